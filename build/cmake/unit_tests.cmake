@@ -72,6 +72,9 @@ myci_add_source_files(test_srcs
     RECURSIVE
 )
 
+# parallel_tree tests use std::thread
+find_package(Threads REQUIRED)
+
 myci_declare_application(${PROJECT_NAME}-tests
     GUI
     SOURCES
@@ -79,6 +82,7 @@ myci_declare_application(${PROJECT_NAME}-tests
     DEPENDENCIES
         utki
         ${tst_dep}
+        Threads::Threads
 )
 
 myci_declare_test(
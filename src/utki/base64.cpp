@@ -31,109 +31,870 @@ SOFTWARE.
 #include <array>
 #include <stdexcept>
 
+#include "cpu.hpp"
 #include "debug.hpp"
+#include "string.hpp"
 #include "type_traits.hpp"
 
+#if defined(UTKI_SIMD_X86)
+#	include <immintrin.h>
+#endif
+
 using namespace utki;
 
 namespace {
-constexpr const std::array<uint8_t, size_t(std::numeric_limits<uint8_t>::max()) + 1> decode_table{
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0x3E, 0,    0,    0,    0x3F, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C,
-	0x3D, 0,    0,    0,    0,    0,    0,    0,    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
-	0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0,    0,    0,    0,
-	0,    0,    0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A,
-	0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
-	0,    0,    0,    0,    0,    0,    0,    0,    0
+constexpr auto base64_bits_per_char = 6;
+constexpr uint32_t base64_char_mask = 0x3f;
+
+constexpr std::string_view standard_encode_table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::string_view url_encode_table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// encodes as many full 3 byte groups as possible,
+// returns number of encoded bytes, the number of written characters is 4/3 of that
+using encode_function_type = size_t (*)(utki::span<const uint8_t> data, char* out, base64_alphabet alphabet);
+
+size_t encode_scalar(utki::span<const uint8_t> data, char* out, base64_alphabet alphabet) noexcept
+{
+	const auto& table = alphabet == base64_alphabet::url ? url_encode_table : standard_encode_table;
+
+	auto i = data.begin();
+	for (; std::distance(i, data.end()) >= 3; i = std::next(i, 3)) {
+		uint32_t triplet = //
+			(uint32_t(*i) << utki::byte_bits * 2) | //
+			(uint32_t(*std::next(i)) << utki::byte_bits) | //
+			uint32_t(*std::next(i, 2));
+
+		// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		out[0] = table[(triplet >> base64_bits_per_char * 3) & base64_char_mask];
+		out[1] = table[(triplet >> base64_bits_per_char * 2) & base64_char_mask];
+		out[2] = table[(triplet >> base64_bits_per_char) & base64_char_mask];
+		out[3] = table[triplet & base64_char_mask];
+		out += 4;
+		// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	}
+
+	return size_t(std::distance(data.begin(), i));
+}
+
+#if defined(UTKI_SIMD_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+
+// The SIMD encoding is based on the algorithm by Wojciech Muła,
+// see http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+
+// Differences between ASCII code of the character and the 6-bit value, indexed by the value class:
+// 0 - 'a'...'z', 1-10 - '0'...'9', 11 - value 62, 12 - value 63, 13 - 'A'...'Z'.
+UTKI_TARGET("ssse3")
+__m128i encode_shift_lut_sse(base64_alphabet alphabet) noexcept
+{
+	bool url = alphabet == base64_alphabet::url;
+	return _mm_setr_epi8(
+		'a' - 26,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		'0' - 52,
+		char(url ? '-' - 62 : '+' - 62),
+		char(url ? '_' - 63 : '/' - 63),
+		'A',
+		0,
+		0
+	);
+}
+
+// converts 12 bytes in each 128-bit lane to 16 6-bit values
+UTKI_TARGET("ssse3")
+__m128i encode_unpack_sse(__m128i in) noexcept
+{
+	in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+	__m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+	__m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	__m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+	__m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+	return _mm_or_si128(t1, t3);
+}
+
+// converts 6-bit values to characters
+UTKI_TARGET("ssse3")
+__m128i encode_lookup_sse(__m128i values, __m128i shift_lut) noexcept
+{
+	__m128i classes = _mm_subs_epu8(values, _mm_set1_epi8(51));
+	__m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), values);
+	classes = _mm_or_si128(classes, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+	return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, classes), values);
+}
+
+UTKI_TARGET("ssse3")
+size_t encode_ssse3(utki::span<const uint8_t> data, char* out, base64_alphabet alphabet) noexcept
+{
+	const __m128i shift_lut = encode_shift_lut_sse(alphabet);
+
+	const uint8_t* in = data.data();
+	const uint8_t* end = utki::end_pointer(data);
+
+	// 16 bytes are loaded, but only 12 of them are encoded
+	for (; end - in >= 16; in += 12, out += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+		v = encode_lookup_sse(encode_unpack_sse(v), shift_lut);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+	}
+
+	auto num_encoded = size_t(in - data.data());
+
+	return num_encoded + encode_scalar(data.subspan(num_encoded), out, alphabet);
+}
+
+UTKI_TARGET("avx2")
+size_t encode_avx2(utki::span<const uint8_t> data, char* out, base64_alphabet alphabet) noexcept
+{
+	const __m256i shift_lut = _mm256_broadcastsi128_si256(encode_shift_lut_sse(alphabet));
+
+	const __m256i shuffle = _mm256_setr_epi8(
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, //
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+	);
+
+	const uint8_t* in = data.data();
+	const uint8_t* end = utki::end_pointer(data);
+
+	// two 16 byte loads of which 12 bytes of each are encoded
+	for (; end - in >= 12 + 16; in += 24, out += 32) {
+		__m256i v = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))), //
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12)),
+			1
+		);
+
+		v = _mm256_shuffle_epi8(v, shuffle);
+
+		__m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+		__m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		__m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+		__m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		__m256i values = _mm256_or_si256(t1, t3);
+
+		__m256i classes = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+		__m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), values);
+		classes = _mm256_or_si256(classes, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+		v = _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, classes), values);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+	}
+
+	auto num_encoded = size_t(in - data.data());
+
+	// the tail can still be long enough for SSSE3
+	return num_encoded + encode_ssse3(data.subspan(num_encoded), out, alphabet);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+
+#endif // ~UTKI_SIMD_X86
+
+encode_function_type select_encode_function() noexcept
+{
+#if defined(UTKI_SIMD_X86)
+	const auto& features = utki::get_cpu_features();
+	if (features.avx2) {
+		return &encode_avx2;
+	}
+	if (features.ssse3) {
+		return &encode_ssse3;
+	}
+#endif
+	return &encode_scalar;
+}
+} // namespace
+
+namespace {
+// encodes full 3 byte groups, returns number of encoded bytes
+size_t encode_triplets(utki::span<const uint8_t> data, char* out, base64_alphabet alphabet) noexcept
+{
+	static const auto encode_function = select_encode_function();
+
+	auto num_encoded = encode_function(data, out, alphabet);
+	ASSERT(data.size() - num_encoded < 3)
+
+	return num_encoded;
+}
+
+// encodes last incomplete 3 byte group, returns number of written chars
+size_t encode_tail(
+	utki::span<const uint8_t> tail, //
+	char* out,
+	base64_alphabet alphabet,
+	bool padding
+) noexcept
+{
+	ASSERT(tail.size() < 3)
+
+	if (tail.empty()) {
+		return 0;
+	}
+
+	const auto& table = alphabet == base64_alphabet::url ? url_encode_table : standard_encode_table;
+
+	uint32_t triplet = uint32_t(tail[0]) << utki::byte_bits * 2;
+	if (tail.size() == 2) {
+		triplet |= uint32_t(tail[1]) << utki::byte_bits;
+	}
+
+	auto o = out;
+
+	*o = table[(triplet >> base64_bits_per_char * 3) & base64_char_mask];
+	o = std::next(o);
+	*o = table[(triplet >> base64_bits_per_char * 2) & base64_char_mask];
+	o = std::next(o);
+
+	if (tail.size() == 2) {
+		*o = table[(triplet >> base64_bits_per_char) & base64_char_mask];
+		o = std::next(o);
+	} else if (padding) {
+		*o = '=';
+		o = std::next(o);
+	}
+
+	if (padding) {
+		*o = '=';
+		o = std::next(o);
+	}
+
+	return size_t(std::distance(out, o));
+}
+} // namespace
+
+size_t utki::base64_encode(
+	utki::span<const uint8_t> data, //
+	utki::span<char> out,
+	base64_alphabet alphabet,
+	bool padding
+)
+{
+	auto encoded_size = base64_encoded_size(data.size(), padding);
+	if (out.size() < encoded_size) {
+		throw std::invalid_argument(utki::cat(
+			"base64_encode(): output buffer is too small: ", //
+			out.size(),
+			" chars, needed ",
+			encoded_size
+		));
+	}
+
+	auto num_encoded = encode_triplets(data, out.data(), alphabet);
+	auto num_chars = num_encoded / 3 * 4;
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	num_chars += encode_tail(data.subspan(num_encoded), out.data() + num_chars, alphabet, padding);
+
+	ASSERT(num_chars == encoded_size)
+
+	return encoded_size;
+}
+
+std::string utki::base64_encode(
+	utki::span<const uint8_t> data, //
+	base64_alphabet alphabet,
+	bool padding
+)
+{
+	std::string ret(base64_encoded_size(data.size(), padding), '\0');
+	base64_encode(data, utki::make_span(ret), alphabet, padding);
+	return ret;
+}
+
+namespace {
+constexpr uint8_t invalid_char_value = 0xff;
+
+using decode_table_type = std::array<uint8_t, size_t(std::numeric_limits<uint8_t>::max()) + 1>;
+
+constexpr decode_table_type make_decode_table(std::string_view encode_table)
+{
+	decode_table_type ret{};
+	for (auto& v : ret) {
+		v = invalid_char_value;
+	}
+	for (size_t i = 0; i != encode_table.size(); ++i) {
+		ret[uint8_t(encode_table[i])] = uint8_t(i);
+	}
+	return ret;
+}
+
+constexpr decode_table_type standard_decode_table = make_decode_table(standard_encode_table);
+constexpr decode_table_type url_decode_table = make_decode_table(url_encode_table);
+
+struct decode_state {
+	const char* in;
+	uint8_t* out;
 };
 
-std::array<uint8_t, 3> base64_decode_quad(char a, char b, char c, char d)
+// decodes as many full 4 character groups as possible, stops at the first group containing invalid character
+using decode_function_type = decode_state (*)(
+	const char* begin, //
+	const char* end,
+	uint8_t* out,
+	base64_alphabet alphabet
+);
+
+decode_state decode_scalar(
+	const char* begin, //
+	const char* end,
+	uint8_t* out,
+	base64_alphabet alphabet
+) noexcept
+{
+	const auto& table = alphabet == base64_alphabet::url ? url_decode_table : standard_decode_table;
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (; end - begin >= 4; begin += 4, out += 3) {
+		auto a = table[uint8_t(begin[0])];
+		auto b = table[uint8_t(begin[1])];
+		auto c = table[uint8_t(begin[2])];
+		auto d = table[uint8_t(begin[3])];
+
+		if ((a | b | c | d) == invalid_char_value) {
+			break;
+		}
+
+		uint32_t quad = //
+			(uint32_t(a) << base64_bits_per_char * 3) | //
+			(uint32_t(b) << base64_bits_per_char * 2) | //
+			(uint32_t(c) << base64_bits_per_char) | //
+			uint32_t(d);
+
+		out[0] = uint8_t((quad >> utki::byte_bits * 2) & utki::byte_mask);
+		out[1] = uint8_t((quad >> utki::byte_bits) & utki::byte_mask);
+		out[2] = uint8_t(quad & utki::byte_mask);
+	}
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+	return {begin, out};
+}
+
+#if defined(UTKI_SIMD_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+
+// The SIMD decoding converts characters to 6-bit values using range checks, which also validate the characters,
+// then packs the values to bytes using multiply-add instructions, as described by Wojciech Muła,
+// see http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+
+// checks if characters are in range, i.e. unsigned (v - first) <= (last - first),
+// returns mask of characters within the range, the offset is set to (v - first)
+UTKI_TARGET("sse2")
+__m128i in_range_sse(__m128i v, char first, char last, __m128i& offset) noexcept
+{
+	offset = _mm_sub_epi8(v, _mm_set1_epi8(first));
+	return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(char(last - first))), offset);
+}
+
+// returns 6-bit values of the characters, sets mask of valid characters
+UTKI_TARGET("sse2")
+__m128i decode_values_sse(__m128i v, __m128i c62, __m128i c63, __m128i& valid) noexcept
 {
-	constexpr auto bits_per_char = 6;
-	uint32_t quad = //
-		(decode_table[a] << bits_per_char * 3) | //
-		(decode_table[b] << bits_per_char * 2) | //
-		(decode_table[c] << bits_per_char) | //
-		decode_table[d];
+	__m128i upper_offset;
+	__m128i upper = in_range_sse(v, 'A', 'Z', upper_offset);
+	__m128i lower_offset;
+	__m128i lower = in_range_sse(v, 'a', 'z', lower_offset);
+	__m128i digit_offset;
+	__m128i digit = in_range_sse(v, '0', '9', digit_offset);
+	__m128i is_62 = _mm_cmpeq_epi8(v, c62);
+	__m128i is_63 = _mm_cmpeq_epi8(v, c63);
 
-	return {
-		uint8_t((quad >> utki::byte_bits * 2) & utki::byte_mask), //
-		uint8_t((quad >> utki::byte_bits) & utki::byte_mask),
-		uint8_t(quad & utki::byte_mask)
-	};
+	valid = _mm_or_si128(
+		_mm_or_si128(upper, lower), //
+		_mm_or_si128(digit, _mm_or_si128(is_62, is_63))
+	);
+
+	__m128i values = _mm_and_si128(upper, upper_offset);
+	values = _mm_or_si128(values, _mm_and_si128(lower, _mm_add_epi8(lower_offset, _mm_set1_epi8(26))));
+	values = _mm_or_si128(values, _mm_and_si128(digit, _mm_add_epi8(digit_offset, _mm_set1_epi8(52))));
+	values = _mm_or_si128(values, _mm_and_si128(is_62, _mm_set1_epi8(62)));
+	return _mm_or_si128(values, _mm_and_si128(is_63, _mm_set1_epi8(63)));
+}
+
+// packs each 4 6-bit values to 3 bytes, the 12 resulting bytes go first
+UTKI_TARGET("ssse3")
+__m128i decode_pack_sse(__m128i values) noexcept
+{
+	__m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+	return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+UTKI_TARGET("ssse3")
+decode_state decode_ssse3(
+	const char* begin, //
+	const char* end,
+	uint8_t* out,
+	base64_alphabet alphabet
+) noexcept
+{
+	bool url = alphabet == base64_alphabet::url;
+	const __m128i c62 = _mm_set1_epi8(url ? '-' : '+');
+	const __m128i c63 = _mm_set1_epi8(url ? '_' : '/');
+
+	// 16 bytes are stored, but only 12 of them are decoded,
+	// so the output has to have 4 more bytes than the decoded data takes
+	for (; end - begin >= 16; begin += 16, out += 12) {
+		__m128i valid;
+		__m128i values = decode_values_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)), c62, c63, valid);
+
+		if (_mm_movemask_epi8(valid) != 0xffff) {
+			// let the scalar decoding find the invalid character
+			break;
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), decode_pack_sse(values));
+	}
+
+	return decode_scalar(begin, end, out, alphabet);
+}
+
+UTKI_TARGET("avx2")
+__m256i in_range_avx2(__m256i v, char first, char last, __m256i& offset) noexcept
+{
+	offset = _mm256_sub_epi8(v, _mm256_set1_epi8(first));
+	return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(char(last - first))), offset);
+}
+
+UTKI_TARGET("avx2")
+decode_state decode_avx2(
+	const char* begin, //
+	const char* end,
+	uint8_t* out,
+	base64_alphabet alphabet
+) noexcept
+{
+	bool url = alphabet == base64_alphabet::url;
+	const __m128i c62 = _mm_set1_epi8(url ? '-' : '+');
+	const __m128i c63 = _mm_set1_epi8(url ? '_' : '/');
+	const __m256i c62_256 = _mm256_set1_epi8(url ? '-' : '+');
+	const __m256i c63_256 = _mm256_set1_epi8(url ? '_' : '/');
+
+	const __m256i shuffle = _mm256_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, //
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+	);
+	const __m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+	// 32 bytes are stored, but only 24 of them are decoded,
+	// so the output has to have 8 more bytes than the decoded data takes
+	for (; end - begin >= 32; begin += 32, out += 24) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+		__m256i upper_offset;
+		__m256i upper = in_range_avx2(v, 'A', 'Z', upper_offset);
+		__m256i lower_offset;
+		__m256i lower = in_range_avx2(v, 'a', 'z', lower_offset);
+		__m256i digit_offset;
+		__m256i digit = in_range_avx2(v, '0', '9', digit_offset);
+		__m256i is_62 = _mm256_cmpeq_epi8(v, c62_256);
+		__m256i is_63 = _mm256_cmpeq_epi8(v, c63_256);
+
+		__m256i valid = _mm256_or_si256(
+			_mm256_or_si256(upper, lower), //
+			_mm256_or_si256(digit, _mm256_or_si256(is_62, is_63))
+		);
+
+		if (uint32_t(_mm256_movemask_epi8(valid)) != 0xffffffff) {
+			// let the scalar decoding find the invalid character
+			break;
+		}
+
+		__m256i values = _mm256_and_si256(upper, upper_offset);
+		values = _mm256_or_si256(
+			values, //
+			_mm256_and_si256(lower, _mm256_add_epi8(lower_offset, _mm256_set1_epi8(26)))
+		);
+		values = _mm256_or_si256(
+			values, //
+			_mm256_and_si256(digit, _mm256_add_epi8(digit_offset, _mm256_set1_epi8(52)))
+		);
+		values = _mm256_or_si256(values, _mm256_and_si256(is_62, _mm256_set1_epi8(62)));
+		values = _mm256_or_si256(values, _mm256_and_si256(is_63, _mm256_set1_epi8(63)));
+
+		__m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+		merged = _mm256_shuffle_epi8(merged, shuffle);
+		merged = _mm256_permutevar8x32_epi32(merged, permute);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), merged);
+	}
+
+	// the tail can still be long enough for SSSE3
+	for (; end - begin >= 16; begin += 16, out += 12) {
+		__m128i valid;
+		__m128i values = decode_values_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(begin)), c62, c63, valid);
+
+		if (_mm_movemask_epi8(valid) != 0xffff) {
+			break;
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), decode_pack_sse(values));
+	}
+
+	return decode_scalar(begin, end, out, alphabet);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+
+#endif // ~UTKI_SIMD_X86
+
+decode_function_type select_decode_function() noexcept
+{
+#if defined(UTKI_SIMD_X86)
+	const auto& features = utki::get_cpu_features();
+	if (features.avx2) {
+		return &decode_avx2;
+	}
+	if (features.ssse3) {
+		return &decode_ssse3;
+	}
+#endif
+	return &decode_scalar;
+}
+
+// returns length of the string without padding
+size_t strip_padding(std::string_view str) noexcept
+{
+	size_t size = str.size();
+	for (unsigned i = 0; i != 2 && size != 0 && str[size - 1] == '='; ++i) {
+		--size;
+	}
+	return size;
+}
+
+size_t num_decoded_bytes(size_t num_chars) noexcept
+{
+	constexpr auto bytes_per_quad = 3;
+	constexpr auto chars_per_quad = 4;
+
+	auto num_tail_chars = num_chars % chars_per_quad;
+
+	// 2 tail chars encode 1 byte, 3 tail chars encode 2 bytes, 1 tail char is invalid
+	return num_chars / chars_per_quad * bytes_per_quad + (num_tail_chars == 0 ? 0 : num_tail_chars - 1);
+}
+
+// decodes full quads, stops at the quad containing invalid character
+decode_state decode_quads(
+	std::string_view data, //
+	utki::span<uint8_t> out,
+	base64_alphabet alphabet
+) noexcept
+{
+	static const auto decode_function = select_decode_function();
+
+	ASSERT(out.size() >= data.size() / 4 * 3)
+
+	// SIMD decoding writes more bytes than it decodes, so let it decode only while
+	// there is enough space in the output buffer
+	constexpr size_t max_simd_overwrite = 8;
+	auto simd_size = std::min(data.size(), (out.size() - std::min(out.size(), max_simd_overwrite)) / 3 * 4);
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto state = decode_function(data.data(), data.data() + simd_size, out.data(), alphabet);
+	return decode_scalar(state.in, utki::end_pointer(data), state.out, alphabet);
+}
+
+// returns index of the first invalid character or std::string_view::npos
+size_t find_invalid_char(std::string_view str, base64_alphabet alphabet) noexcept
+{
+	const auto& table = alphabet == base64_alphabet::url ? url_decode_table : standard_decode_table;
+
+	for (size_t i = 0; i != str.size(); ++i) {
+		if (table[uint8_t(str[i])] == invalid_char_value) {
+			return i;
+		}
+	}
+	return std::string_view::npos;
+}
+
+// decodes last incomplete quad of 2 or 3 valid characters, returns number of written bytes
+size_t decode_tail(std::string_view tail, uint8_t* out, base64_alphabet alphabet) noexcept
+{
+	ASSERT(tail.empty() || tail.size() == 2 || tail.size() == 3)
+	ASSERT(find_invalid_char(tail, alphabet) == std::string_view::npos)
+
+	const auto& table = alphabet == base64_alphabet::url ? url_decode_table : standard_decode_table;
+
+	uint32_t quad = 0;
+	for (auto c : tail) {
+		quad = (quad << base64_bits_per_char) | table[uint8_t(c)];
+	}
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	switch (tail.size()) {
+		case 0:
+			return 0;
+		case 2:
+			out[0] = uint8_t((quad >> (base64_bits_per_char * 2 - utki::byte_bits)) & utki::byte_mask);
+			return 1;
+		default:
+			quad >>= base64_bits_per_char * 3 - utki::byte_bits * 2;
+			out[0] = uint8_t((quad >> utki::byte_bits) & utki::byte_mask);
+			out[1] = uint8_t(quad & utki::byte_mask);
+			return 2;
+	}
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 }
 } // namespace
 
+size_t utki::base64_decoded_size(std::string_view str) noexcept
+{
+	return num_decoded_bytes(strip_padding(str));
+}
+
+base64_decode_result utki::base64_decode(
+	std::string_view str, //
+	utki::span<uint8_t> out,
+	base64_alphabet alphabet
+) noexcept
+{
+	auto data_size = strip_padding(str);
+	auto padding_size = str.size() - data_size;
+
+	constexpr auto chars_per_quad = 4;
+
+	if (padding_size != 0 && str.size() % chars_per_quad != 0) {
+		// padding does not complete the last quad
+		return {0, data_size, std::errc::invalid_argument};
+	}
+
+	auto data = str.substr(0, data_size);
+
+	auto size = num_decoded_bytes(data.size());
+	if (out.size() < size) {
+		return {0, 0, std::errc::value_too_large};
+	}
+
+	auto state = decode_quads(data, out, alphabet);
+
+	auto num_bytes = size_t(state.out - out.data());
+	auto num_decoded_chars = size_t(state.in - data.data());
+
+	auto tail = data.substr(num_decoded_chars);
+
+	if (auto pos = find_invalid_char(tail, alphabet); pos != std::string_view::npos) {
+		return {num_bytes, num_decoded_chars + pos, std::errc::invalid_argument};
+	}
+
+	// full quads were decoded, so the tail is either less than 4 chars or a full quad
+	// containing invalid character which is found above
+	ASSERT(tail.size() < chars_per_quad)
+
+	if (tail.size() == 1) {
+		// one char does not encode a whole byte
+		return {num_bytes, data.size(), std::errc::invalid_argument};
+	}
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	num_bytes += decode_tail(tail, out.data() + num_bytes, alphabet);
+
+	ASSERT(num_bytes == size)
+
+	return {num_bytes, str.size(), std::errc()};
+}
+
+std::vector<uint8_t> utki::base64_decode(std::string_view str, base64_alphabet alphabet)
+{
+	std::vector<uint8_t> ret(base64_decoded_size(str));
+
+	auto res = base64_decode(str, utki::make_span(ret), alphabet);
+	if (res.ec != std::errc()) {
+		throw std::invalid_argument(utki::cat(
+			"base64_decode(): malformed base64 string: invalid character or padding at offset ", //
+			res.offset
+		));
+	}
+
+	ASSERT(res.num_bytes == ret.size())
+
+	return ret;
+}
+
 std::vector<uint8_t> utki::base64_decode(std::string_view str)
 {
-	if (str.empty()) {
-		return {};
+	return base64_decode(str, base64_alphabet::standard);
+}
+
+size_t base64_encoder::encode(utki::span<const uint8_t> chunk, utki::span<char> out)
+{
+	auto encoded_size = this->encoded_size(chunk.size());
+	if (out.size() < encoded_size) {
+		throw std::invalid_argument(utki::cat(
+			"base64_encoder::encode(): output buffer is too small: ", //
+			out.size(),
+			" chars, needed ",
+			encoded_size
+		));
 	}
 
-	size_t num_quads = str.size() / 4;
+	size_t num_chars = 0;
+
+	if (this->tail_size != 0) {
+		auto n = std::min(this->tail.size() - this->tail_size, chunk.size());
+		std::copy(
+			chunk.begin(), //
+			std::next(chunk.begin(), ptrdiff_t(n)),
+			std::next(this->tail.begin(), ptrdiff_t(this->tail_size))
+		);
+		this->tail_size += n;
+		chunk = chunk.subspan(n);
 
-	// strip out padding
-	if (str.back() == '=') {
-		if (num_quads == 0) {
-			throw std::invalid_argument("base64_decode(): malformed base64 string: padding is not complete");
+		if (this->tail_size != this->tail.size()) {
+			ASSERT(chunk.empty())
+			return 0;
 		}
-		--num_quads;
 
-		str = str.substr(0, str.size() - 1);
+		encode_triplets(this->tail, out.data(), this->alphabet);
+		this->tail_size = 0;
+		num_chars = 4;
+	}
+
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	auto num_encoded = encode_triplets(chunk, out.data() + num_chars, this->alphabet);
+	num_chars += num_encoded / 3 * 4;
 
-		if (str.back() == '=') {
-			str = str.substr(0, str.size() - 1);
+	auto rest = chunk.subspan(num_encoded);
+	std::copy(rest.begin(), rest.end(), this->tail.begin());
+	this->tail_size = rest.size();
+
+	ASSERT(num_chars == encoded_size)
+
+	return num_chars;
+}
+
+size_t base64_encoder::finish(utki::span<char> out)
+{
+	auto encoded_size = base64_encoded_size(this->tail_size, this->padding);
+	if (out.size() < encoded_size) {
+		throw std::invalid_argument(utki::cat(
+			"base64_encoder::finish(): output buffer is too small: ", //
+			out.size(),
+			" chars, needed ",
+			encoded_size
+		));
+	}
+
+	auto num_chars = encode_tail(
+		utki::make_span(this->tail).subspan(0, this->tail_size), //
+		out.data(),
+		this->alphabet,
+		this->padding
+	);
+
+	this->reset();
+
+	return num_chars;
+}
+
+base64_decode_result base64_decoder::decode(std::string_view chunk, utki::span<uint8_t> out) noexcept
+{
+	if (out.size() < this->decoded_size(chunk.size())) {
+		return {0, this->num_chars, std::errc::value_too_large};
+	}
+
+	auto chunk_offset = this->num_chars;
+
+	size_t num_bytes = 0;
+
+	// padding can only be at the end of the string
+	auto data = chunk.substr(0, this->num_padding_chars == 0 ? utki::find_char(chunk, '=') : 0);
+
+	if (this->tail_size != 0) {
+		auto n = std::min(this->tail.size() - this->tail_size, data.size());
+		std::copy(
+			data.begin(), //
+			std::next(data.begin(), ptrdiff_t(n)),
+			std::next(this->tail.begin(), ptrdiff_t(this->tail_size))
+		);
+		this->tail_size += n;
+		data = data.substr(n);
+
+		if (this->tail_size == this->tail.size()) {
+			auto tail_str = std::string_view(this->tail.data(), this->tail.size());
+			if (auto pos = find_invalid_char(tail_str, this->alphabet); pos != std::string_view::npos) {
+				// the tail chars before the chunk are valid
+				return {0, chunk_offset + pos - (this->tail.size() - n), std::errc::invalid_argument};
+			}
+			decode_quads(tail_str, out, this->alphabet);
+			this->tail_size = 0;
+			num_bytes = 3;
 		}
 	}
 
-	std::vector<uint8_t> ret;
+	auto data_offset = size_t(data.data() - chunk.data());
+
+	auto state = decode_quads(data, out.subspan(num_bytes), this->alphabet);
+	num_bytes = size_t(state.out - out.data());
+
+	auto rest = data.substr(size_t(state.in - data.data()));
+	if (auto pos = find_invalid_char(rest, this->alphabet); pos != std::string_view::npos) {
+		return {num_bytes, chunk_offset + size_t(rest.data() - chunk.data()) + pos, std::errc::invalid_argument};
+	}
 
-	auto i = str.begin();
-	for (size_t counter = 0; counter != num_quads; ++counter) {
-		ASSERT(i < str.end())
-		ASSERT(std::next(i, 4) <= str.end())
-		auto a = *i;
-		i = std::next(i);
-		auto b = *i;
-		i = std::next(i);
-		auto c = *i;
-		i = std::next(i);
-		auto d = *i;
-		i = std::next(i);
-		auto bytes = base64_decode_quad(a, b, c, d);
+	ASSERT(rest.size() < this->tail.size())
+	ASSERT(rest.empty() || this->tail_size == 0)
+	std::copy(rest.begin(), rest.end(), this->tail.begin());
+	this->tail_size += rest.size();
 
-		ret.insert(ret.end(), bytes.begin(), bytes.end());
+	for (size_t i = data_offset + data.size(); i != chunk.size(); ++i) {
+		if (chunk[i] != '=' || this->num_padding_chars == 2) {
+			// report offset of the first padding char, the padding is not at the end of the string
+			return {num_bytes, chunk_offset + i - this->num_padding_chars, std::errc::invalid_argument};
+		}
+		++this->num_padding_chars;
 	}
 
-	ASSERT(i <= str.end())
+	this->num_chars += chunk.size();
+
+	return {num_bytes, this->num_chars, std::errc()};
+}
+
+base64_decode_result base64_decoder::finish(utki::span<uint8_t> out) noexcept
+{
+	auto data_size = this->num_chars - this->num_padding_chars;
+
+	auto tail_str = std::string_view(this->tail.data(), this->tail_size);
+
+	// incomplete quad chars are not validated yet
+	if (auto pos = find_invalid_char(tail_str, this->alphabet); pos != std::string_view::npos) {
+		return {0, data_size - tail_str.size() + pos, std::errc::invalid_argument};
+	}
 
-	if (i == str.end()) {
-		return ret;
+	if (this->tail_size == 1) {
+		// one char does not encode a whole byte
+		return {0, data_size, std::errc::invalid_argument};
 	}
 
-	auto a = *i;
-	i = std::next(i);
-	ASSERT(i != str.end())
-	auto b = *i;
-	i = std::next(i);
+	if (this->num_padding_chars != 0 && this->tail_size + this->num_padding_chars != this->tail.size()) {
+		// padding does not complete the last quad
+		return {0, data_size, std::errc::invalid_argument};
+	}
 
-	if (i == str.end()) {
-		auto bytes = base64_decode_quad(a, b, 'A', 'A');
-		ret.push_back(bytes[0]);
-		return ret;
+	if (out.size() < num_decoded_bytes(tail_str.size())) {
+		return {0, this->num_chars, std::errc::value_too_large};
 	}
 
-	auto c = *i;
-	auto bytes = base64_decode_quad(a, b, c, 'A');
-	ret.push_back(bytes[0]);
-	ret.push_back(bytes[1]);
+	auto num_bytes = decode_tail(tail_str, out.data(), this->alphabet);
+	auto num_chars = this->num_chars;
 
-	return ret;
+	this->reset();
+
+	return {num_bytes, num_chars, std::errc()};
 }
@@ -28,12 +28,302 @@ SOFTWARE.
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <system_error>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include "span.hpp"
+
 namespace utki {
 
+/**
+ * @brief Base64 alphabet.
+ */
+enum class base64_alphabet {
+	/**
+	 * @brief Standard alphabet.
+	 * Uses '+' and '/' for values 62 and 63, see RFC 4648, section 4.
+	 */
+	standard,
+
+	/**
+	 * @brief URL and filename safe alphabet.
+	 * Uses '-' and '_' for values 62 and 63, see RFC 4648, section 5.
+	 */
+	url
+};
+
+/**
+ * @brief Calculate length of base64 encoded data.
+ * @param data_size - size of the data to encode, in bytes.
+ * @param padding - whether the encoded string is padded with '=' characters to a multiple of 4 characters.
+ * @return Number of characters in the base64 encoded string.
+ */
+inline size_t base64_encoded_size(size_t data_size, bool padding = true) noexcept
+{
+	constexpr auto bytes_per_quad = 3;
+	constexpr auto chars_per_quad = 4;
+
+	auto num_quads = data_size / bytes_per_quad;
+	auto num_tail_bytes = data_size % bytes_per_quad;
+
+	if (num_tail_bytes == 0) {
+		return num_quads * chars_per_quad;
+	}
+
+	if (padding) {
+		return (num_quads + 1) * chars_per_quad;
+	}
+
+	// 1 tail byte is encoded with 2 characters, 2 tail bytes are encoded with 3 characters
+	return num_quads * chars_per_quad + num_tail_bytes + 1;
+}
+
+/**
+ * @brief Encode data to base64.
+ * @param data - data to encode.
+ * @param out - buffer to write the encoded characters to. Must be at least base64_encoded_size() characters long.
+ * @param alphabet - base64 alphabet to use.
+ * @param padding - whether to pad the encoded string with '=' characters to a multiple of 4 characters.
+ * @return Number of characters written to the output buffer.
+ * @throw std::invalid_argument - in case the output buffer is too small.
+ */
+size_t base64_encode(
+	utki::span<const uint8_t> data, //
+	utki::span<char> out,
+	base64_alphabet alphabet = base64_alphabet::standard,
+	bool padding = true
+);
+
+/**
+ * @brief Encode data to base64.
+ * @param data - data to encode.
+ * @param alphabet - base64 alphabet to use.
+ * @param padding - whether to pad the encoded string with '=' characters to a multiple of 4 characters.
+ * @return Base64 encoded string.
+ */
+std::string base64_encode(
+	utki::span<const uint8_t> data, //
+	base64_alphabet alphabet = base64_alphabet::standard,
+	bool padding = true
+);
+
+/**
+ * @brief Calculate size of base64 decoded data.
+ * The string is assumed to be a valid base64 string, padded or not.
+ * @param str - base64 string.
+ * @return Number of bytes the string decodes to.
+ */
+size_t base64_decoded_size(std::string_view str) noexcept;
+
+/**
+ * @brief Result of base64 decoding.
+ */
+struct base64_decode_result {
+	/**
+	 * @brief Number of bytes written to the output buffer.
+	 */
+	size_t num_bytes;
+
+	/**
+	 * @brief Offset of the first character which could not be decoded.
+	 * In case of success it is equal to the input string length.
+	 */
+	size_t offset;
+
+	/**
+	 * @brief Error code.
+	 * std::errc() in case of success.
+	 * std::errc::invalid_argument in case the input string contains invalid character or incorrect padding.
+	 * std::errc::value_too_large in case the output buffer is too small, nothing is decoded in this case.
+	 */
+	std::errc ec;
+};
+
+/**
+ * @brief Decode base64 string into a buffer.
+ * The string can be padded or not. The function does not allocate any memory.
+ * @param str - base64 string to decode.
+ * @param out - buffer to write the decoded bytes to. Must be at least base64_decoded_size() bytes long.
+ * @param alphabet - base64 alphabet to use.
+ * @return Decoding result.
+ */
+base64_decode_result base64_decode(
+	std::string_view str, //
+	utki::span<uint8_t> out,
+	base64_alphabet alphabet = base64_alphabet::standard
+) noexcept;
+
+/**
+ * @brief Decode base64 string.
+ * The string can be padded or not.
+ * @param str - base64 string to decode.
+ * @param alphabet - base64 alphabet to use.
+ * @return Decoded bytes.
+ * @throw std::invalid_argument - in case the string contains invalid character or incorrect padding.
+ */
+std::vector<uint8_t> base64_decode(
+	std::string_view str, //
+	base64_alphabet alphabet
+);
+
+/**
+ * @brief Decode base64 string.
+ * Same as base64_decode(std::string_view, base64_alphabet) with standard alphabet.
+ * @param str - base64 string to decode.
+ * @return Decoded bytes.
+ * @throw std::invalid_argument - in case the string contains invalid character or incorrect padding.
+ */
 std::vector<uint8_t> base64_decode(std::string_view str);
 
+/**
+ * @brief Streaming base64 encoder.
+ * Encodes data which comes in chunks. Chunk boundaries can be arbitrary,
+ * up to 2 bytes which do not form a full 3 byte group are kept till the next chunk.
+ */
+class base64_encoder
+{
+	base64_alphabet alphabet;
+	bool padding;
+
+	// input bytes which do not form a full 3 byte group yet
+	std::array<uint8_t, 3> tail{};
+	size_t tail_size = 0;
+
+public:
+	/**
+	 * @brief Maximum number of characters written by finish().
+	 */
+	constexpr static size_t max_finish_size = 4;
+
+	/**
+	 * @brief Constructor.
+	 * @param alphabet - base64 alphabet to use.
+	 * @param padding - whether to pad the encoded string with '=' characters to a multiple of 4 characters.
+	 */
+	base64_encoder(
+		base64_alphabet alphabet = base64_alphabet::standard, //
+		bool padding = true
+	) noexcept :
+		alphabet(alphabet),
+		padding(padding)
+	{}
+
+	/**
+	 * @brief Calculate number of characters encode() writes for the next chunk.
+	 * @param chunk_size - size of the next chunk, in bytes.
+	 * @return Number of characters.
+	 */
+	size_t encoded_size(size_t chunk_size) const noexcept
+	{
+		constexpr auto bytes_per_quad = 3;
+		constexpr auto chars_per_quad = 4;
+		return (this->tail_size + chunk_size) / bytes_per_quad * chars_per_quad;
+	}
+
+	/**
+	 * @brief Encode next chunk of data.
+	 * @param chunk - data to encode.
+	 * @param out - buffer to write the encoded characters to. Must be at least encoded_size() characters long.
+	 * @return Number of characters written to the output buffer.
+	 * @throw std::invalid_argument - in case the output buffer is too small.
+	 */
+	size_t encode(utki::span<const uint8_t> chunk, utki::span<char> out);
+
+	/**
+	 * @brief Finish encoding.
+	 * Writes characters encoding the remaining bytes and padding.
+	 * After that the encoder is reset and can be used to encode new data.
+	 * @param out - buffer to write the encoded characters to. Buffer of max_finish_size characters is always enough.
+	 * @return Number of characters written to the output buffer.
+	 * @throw std::invalid_argument - in case the output buffer is too small.
+	 */
+	size_t finish(utki::span<char> out);
+
+	/**
+	 * @brief Reset the encoder.
+	 * Drops the remaining bytes, so the encoder can be used to encode new data.
+	 */
+	void reset() noexcept
+	{
+		this->tail_size = 0;
+	}
+};
+
+/**
+ * @brief Streaming base64 decoder.
+ * Decodes base64 string which comes in chunks. Chunk boundaries can be arbitrary,
+ * up to 3 characters which do not form a full 4 character group are kept till the next chunk.
+ * Offsets in returned decoding results are counted from the beginning of the whole string.
+ */
+class base64_decoder
+{
+	base64_alphabet alphabet;
+
+	// characters which do not form a full 4 character group yet
+	std::array<char, 4> tail{};
+	size_t tail_size = 0;
+
+	size_t num_chars = 0;
+	size_t num_padding_chars = 0;
+
+public:
+	/**
+	 * @brief Maximum number of bytes written by finish().
+	 */
+	constexpr static size_t max_finish_size = 2;
+
+	/**
+	 * @brief Constructor.
+	 * @param alphabet - base64 alphabet to use.
+	 */
+	base64_decoder(base64_alphabet alphabet = base64_alphabet::standard) noexcept :
+		alphabet(alphabet)
+	{}
+
+	/**
+	 * @brief Calculate maximum number of bytes decode() writes for the next chunk.
+	 * @param chunk_size - size of the next chunk, in characters.
+	 * @return Number of bytes.
+	 */
+	size_t decoded_size(size_t chunk_size) const noexcept
+	{
+		constexpr auto bytes_per_quad = 3;
+		constexpr auto chars_per_quad = 4;
+		return (this->tail_size + chunk_size) / chars_per_quad * bytes_per_quad;
+	}
+
+	/**
+	 * @brief Decode next chunk of base64 string.
+	 * In case of error the decoder has to be reset before decoding new string.
+	 * @param chunk - part of the base64 string to decode.
+	 * @param out - buffer to write the decoded bytes to. Must be at least decoded_size() bytes long.
+	 * @return Decoding result.
+	 */
+	base64_decode_result decode(std::string_view chunk, utki::span<uint8_t> out) noexcept;
+
+	/**
+	 * @brief Finish decoding.
+	 * Writes bytes decoded from the remaining characters and checks the padding.
+	 * After that the decoder is reset and can be used to decode new string.
+	 * @param out - buffer to write the decoded bytes to. Buffer of max_finish_size bytes is always enough.
+	 * @return Decoding result.
+	 */
+	base64_decode_result finish(utki::span<uint8_t> out) noexcept;
+
+	/**
+	 * @brief Reset the decoder.
+	 * Drops the remaining characters, so the decoder can be used to decode new string.
+	 */
+	void reset() noexcept
+	{
+		this->tail_size = 0;
+		this->num_chars = 0;
+		this->num_padding_chars = 0;
+	}
+};
+
 } // namespace utki
@@ -0,0 +1,88 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "cpu.hpp"
+
+#if defined(UTKI_SIMD_X86) && CFG_COMPILER == CFG_COMPILER_MSVC
+#	include <array>
+
+#	include <immintrin.h>
+#	include <intrin.h>
+#endif
+
+using namespace utki;
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+cpu_features probe_cpu_features() noexcept
+{
+	cpu_features ret;
+
+#if defined(UTKI_SIMD_X86)
+#	if CFG_COMPILER == CFG_COMPILER_MSVC
+	std::array<int, 4> regs{}; // eax, ebx, ecx, edx
+
+	__cpuid(regs.data(), 0);
+	int max_leaf = regs[0];
+
+	if (max_leaf >= 1) {
+		__cpuid(regs.data(), 1);
+		ret.sse2 = (regs[3] & (1 << 26)) != 0;
+		ret.ssse3 = (regs[2] & (1 << 9)) != 0;
+		ret.sse4_1 = (regs[2] & (1 << 19)) != 0;
+
+		bool os_saves_ymm = false;
+		if ((regs[2] & (1 << 27)) != 0 && (regs[2] & (1 << 28)) != 0) { // OSXSAVE and AVX
+			// check that OS saves XMM and YMM registers on context switch
+			os_saves_ymm = (_xgetbv(0) & 0x6) == 0x6;
+		}
+
+		if (max_leaf >= 7 && os_saves_ymm) {
+			__cpuidex(regs.data(), 7, 0);
+			ret.avx2 = (regs[1] & (1 << 5)) != 0;
+		}
+	}
+#	else
+	__builtin_cpu_init();
+	ret.sse2 = __builtin_cpu_supports("sse2");
+	ret.ssse3 = __builtin_cpu_supports("ssse3");
+	ret.sse4_1 = __builtin_cpu_supports("sse4.1");
+	ret.avx2 = __builtin_cpu_supports("avx2");
+#	endif
+#endif
+
+	return ret;
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+} // namespace
+
+const cpu_features& utki::get_cpu_features() noexcept
+{
+	static const cpu_features features = probe_cpu_features();
+	return features;
+}
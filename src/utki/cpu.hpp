@@ -0,0 +1,85 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include "config.hpp"
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+/**
+ * @brief x86 SIMD intrinsics availability.
+ * Defined when x86 SIMD intrinsics (SSE/AVX) can be used, i.e. target CPU is x86 or x86_64 and
+ * compiler supports enabling the instruction set extensions on per-function basis, see UTKI_TARGET().
+ * Note, that this macro does not mean that the CPU the code runs on supports those instructions,
+ * use utki::get_cpu_features() for runtime check.
+ */
+#if (CFG_COMPILER == CFG_COMPILER_GCC || CFG_COMPILER == CFG_COMPILER_CLANG) && \
+	(defined(__x86_64__) || defined(__i386__))
+#	define UTKI_SIMD_X86
+#elif CFG_COMPILER == CFG_COMPILER_MSVC && (defined(_M_X64) || defined(_M_IX86))
+#	define UTKI_SIMD_X86
+#endif
+
+/**
+ * @brief Enable instruction set extension for a function.
+ * Allows using the instruction set extension intrinsics within the function without enabling the extension
+ * for the whole translation unit. So, the function has to be called only after checking the CPU supports
+ * the extension, see utki::get_cpu_features().
+ * MSVC allows using intrinsics without enabling them, so there the macro expands to nothing.
+ * @param feature - instruction set extension name, e.g. "avx2".
+ */
+#if CFG_COMPILER == CFG_COMPILER_GCC || CFG_COMPILER == CFG_COMPILER_CLANG
+#	define UTKI_TARGET(feature) __attribute__((target(feature)))
+#else
+#	define UTKI_TARGET(feature)
+#endif
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+namespace utki {
+
+/**
+ * @brief CPU instruction set extensions.
+ * Each flag tells if the CPU the program runs on supports the instruction set extension.
+ */
+struct cpu_features {
+	bool sse2 = false;
+	bool ssse3 = false;
+	bool sse4_1 = false;
+	bool avx2 = false;
+};
+
+/**
+ * @brief Get CPU instruction set extensions.
+ * The CPU is probed once, on the first call to this function.
+ * @return Instruction set extensions supported by the CPU.
+ */
+const cpu_features& get_cpu_features() noexcept;
+
+} // namespace utki
@@ -28,9 +28,20 @@ SOFTWARE.
 
 #include "deserializer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "cpu.hpp"
+#include "math.hpp"
 #include "string.hpp"
 #include "utility.hpp"
 
+#if defined(UTKI_SIMD_X86)
+#	include <immintrin.h>
+#endif
+
 using namespace utki;
 
 std::string_view deserializer::read_string(size_t length)
@@ -114,6 +125,17 @@ float deserializer::read_float_le()
 	return ret;
 }
 
+double deserializer::read_double_le()
+{
+	if (this->size() < sizeof(double)) {
+		throw std::invalid_argument("deserializer::read_double_le(): buffer has less bytes then needed");
+	}
+
+	auto ret = utki::deserialize_double_le(this->data.data());
+	this->data = this->data.subspan(sizeof(double));
+	return ret;
+}
+
 uint16_t deserializer::read_uint16_be()
 {
 	if (this->size() < sizeof(uint16_t)) {
@@ -158,6 +180,206 @@ float deserializer::read_float_be()
 	return ret;
 }
 
+double deserializer::read_double_be()
+{
+	if (this->size() < sizeof(double)) {
+		throw std::invalid_argument("deserializer::read_double_be(): buffer has less bytes then needed");
+	}
+
+	auto ret = utki::deserialize_double_be(this->data.data());
+	this->data = this->data.subspan(sizeof(double));
+	return ret;
+}
+
+namespace {
+#if CFG_ENDIANNESS == CFG_ENDIANNESS_UNKNOWN
+
+// host byte order is unknown at compile time, assemble each value from bytes
+template <typename unsigned_type>
+void copy_values(utki::span<const uint8_t> src, uint8_t* dst, bool big_endian) noexcept
+{
+	for (auto i = src.begin(); i != src.end(); i += sizeof(unsigned_type)) {
+		auto value = big_endian ? utki::deserialize_be<unsigned_type>(&*i) : utki::deserialize_le<unsigned_type>(&*i);
+		std::memcpy(dst, &value, sizeof(value));
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		dst += sizeof(value);
+	}
+}
+
+void copy_values(utki::span<const uint8_t> src, uint8_t* dst, size_t value_size, bool big_endian) noexcept
+{
+	switch (value_size) {
+		case sizeof(uint8_t):
+			std::copy(src.begin(), src.end(), dst);
+			break;
+		case sizeof(uint16_t):
+			copy_values<uint16_t>(src, dst, big_endian);
+			break;
+		case sizeof(uint32_t):
+			copy_values<uint32_t>(src, dst, big_endian);
+			break;
+		case sizeof(uint64_t):
+			copy_values<uint64_t>(src, dst, big_endian);
+			break;
+		default:
+			ASSERT(false)
+			break;
+	}
+}
+
+#else
+
+template <typename unsigned_type>
+void copy_swapped(utki::span<const uint8_t> src, uint8_t* dst) noexcept
+{
+	for (auto i = src.begin(); i != src.end(); i += sizeof(unsigned_type)) {
+		unsigned_type value{};
+		std::memcpy(&value, &*i, sizeof(value));
+		value = utki::byte_swap(value);
+		std::memcpy(dst, &value, sizeof(value));
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		dst += sizeof(value);
+	}
+}
+
+// copies values reversing byte order of each value
+using copy_swapped_function_type = void (*)(utki::span<const uint8_t> src, uint8_t* dst, size_t value_size);
+
+void copy_swapped_scalar(utki::span<const uint8_t> src, uint8_t* dst, size_t value_size) noexcept
+{
+	switch (value_size) {
+		case sizeof(uint16_t):
+			copy_swapped<uint16_t>(src, dst);
+			break;
+		case sizeof(uint32_t):
+			copy_swapped<uint32_t>(src, dst);
+			break;
+		case sizeof(uint64_t):
+			copy_swapped<uint64_t>(src, dst);
+			break;
+		default:
+			ASSERT(false)
+			break;
+	}
+}
+
+#	if defined(UTKI_SIMD_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+
+// pshufb masks reversing byte order of 2, 4 and 8 byte values
+constexpr std::array<uint8_t, 16> swap_mask_16 = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+constexpr std::array<uint8_t, 16> swap_mask_32 = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+constexpr std::array<uint8_t, 16> swap_mask_64 = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+const std::array<uint8_t, 16>& get_swap_mask(size_t value_size) noexcept
+{
+	switch (value_size) {
+		case sizeof(uint16_t):
+			return swap_mask_16;
+		case sizeof(uint32_t):
+			return swap_mask_32;
+		default:
+			ASSERT(value_size == sizeof(uint64_t))
+			return swap_mask_64;
+	}
+}
+
+UTKI_TARGET("ssse3")
+void copy_swapped_ssse3(utki::span<const uint8_t> src, uint8_t* dst, size_t value_size) noexcept
+{
+	const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(get_swap_mask(value_size).data()));
+
+	auto in = src.data();
+	auto end = in + src.size();
+
+	for (; end - in >= 16; in += 16, dst += 16) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_shuffle_epi8(v, mask));
+	}
+
+	copy_swapped_scalar(utki::make_span(in, size_t(end - in)), dst, value_size);
+}
+
+UTKI_TARGET("avx2")
+void copy_swapped_avx2(utki::span<const uint8_t> src, uint8_t* dst, size_t value_size) noexcept
+{
+	// byte shuffle works within 128 bit lanes, so the mask is the same for both lanes
+	const auto mask = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(get_swap_mask(value_size).data()))
+	);
+
+	auto in = src.data();
+	auto end = in + src.size();
+
+	for (; end - in >= 64; in += 64, dst += 64) {
+		auto v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+		auto v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 32));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_shuffle_epi8(v0, mask));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_shuffle_epi8(v1, mask));
+	}
+
+	// the tail can still be long enough for SSSE3
+	copy_swapped_ssse3(utki::make_span(in, size_t(end - in)), dst, value_size);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+
+#	endif // ~UTKI_SIMD_X86
+
+copy_swapped_function_type select_copy_swapped_function() noexcept
+{
+#	if defined(UTKI_SIMD_X86)
+	const auto& features = utki::get_cpu_features();
+	if (features.avx2) {
+		return &copy_swapped_avx2;
+	}
+	if (features.ssse3) {
+		return &copy_swapped_ssse3;
+	}
+#	endif
+	return &copy_swapped_scalar;
+}
+
+void copy_values(utki::span<const uint8_t> src, uint8_t* dst, size_t value_size, bool big_endian) noexcept
+{
+	constexpr bool is_host_big_endian = CFG_ENDIANNESS == CFG_ENDIANNESS_BIG;
+
+	if (value_size == sizeof(uint8_t) || big_endian == is_host_big_endian) {
+		// byte order matches the host one
+		std::copy(src.begin(), src.end(), dst);
+		return;
+	}
+
+	static const auto copy_swapped_function = select_copy_swapped_function();
+
+	copy_swapped_function(src, dst, value_size);
+}
+
+#endif
+} // namespace
+
+void deserializer::read_array(utki::span<uint8_t> out, size_t value_size, bool big_endian)
+{
+	if (this->size() < out.size()) {
+		throw std::invalid_argument(utki::cat(
+			"deserializer::read_array_",
+			big_endian ? "be" : "le",
+			"(): ",
+			out.size(),
+			" bytes needed, buffer size is only ",
+			this->size()
+		));
+	}
+
+	ASSERT(out.size() % value_size == 0)
+
+	copy_values(this->data.subspan(0, out.size()), out.data(), value_size, big_endian);
+	this->data = this->data.subspan(out.size());
+}
+
 void deserializer::skip(size_t length)
 {
 	if (this->size() < length) {
@@ -166,3 +388,256 @@ void deserializer::skip(size_t length)
 
 	this->data = this->data.subspan(length);
 }
+
+namespace {
+// returned by varint decoding functions in case of malformed or truncated input
+constexpr size_t decode_failed = std::numeric_limits<size_t>::max();
+
+template <typename unsigned_type>
+size_t decode_varuints_scalar(utki::span<const uint8_t> in, utki::span<unsigned_type> out) noexcept
+{
+	size_t num_consumed = 0;
+	for (auto& v : out) {
+		auto size = utki::deserialize_varuint(in.subspan(num_consumed), v);
+		if (size == 0) {
+			return decode_failed;
+		}
+		num_consumed += size;
+	}
+	return num_consumed;
+}
+
+// returns number of consumed bytes or decode_failed
+template <typename unsigned_type>
+using decode_varuints_function_type = size_t (*)(utki::span<const uint8_t> in, utki::span<unsigned_type> out);
+
+#if defined(UTKI_SIMD_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+
+// decodes value of known encoded size, returns false in case the value does not fit into the unsigned_type,
+// at least 8 bytes must be readable starting from the input pointer
+template <typename unsigned_type>
+bool decode_varuint(const uint8_t* in, size_t size, unsigned_type& out) noexcept
+{
+	constexpr auto max_size = utki::max_varuint_size<unsigned_type>;
+
+	// number of value bits in the last byte of the longest possible encoded value
+	constexpr auto last_byte_bits =
+		sizeof(unsigned_type) * utki::byte_bits - utki::varint_payload_bits * (max_size - 1);
+
+	if (size > max_size || (size == max_size && (in[max_size - 1] >> last_byte_bits) != 0)) {
+		return false;
+	}
+
+	if (size > sizeof(uint64_t)) {
+		unsigned_type value = 0;
+		for (size_t i = 0; i != size; ++i) {
+			auto bits = unsigned_type(in[i] & ~utki::varint_continuation_bit);
+			value |= unsigned_type(bits << (utki::varint_payload_bits * i));
+		}
+		out = value;
+		return true;
+	}
+
+	// load up to 8 bytes, the host is little-endian
+	uint64_t w = 0;
+	std::memcpy(&w, in, sizeof(w));
+	w &= ~uint64_t(0) >> ((sizeof(uint64_t) - size) * utki::byte_bits);
+
+	// drop continuation bits and pack 7 bit groups together: 7 -> 14 -> 28 -> 56 bits
+	w = (w & 0x007f'007f'007f'007f) | ((w & 0x7f00'7f00'7f00'7f00) >> 1);
+	w = (w & 0x0000'3fff'0000'3fff) | ((w & 0x3fff'0000'3fff'0000) >> 2);
+	w = (w & 0x0000'0000'0fff'ffff) | ((w & 0x0fff'ffff'0000'0000) >> 4);
+
+	out = unsigned_type(w);
+	return true;
+}
+
+// widens four 32 bit values
+template <typename unsigned_type>
+UTKI_TARGET("sse2")
+void store_4_values(__m128i v, unsigned_type* out) noexcept
+{
+	if constexpr (sizeof(unsigned_type) == sizeof(uint32_t)) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+	} else {
+		static_assert(sizeof(unsigned_type) == sizeof(uint64_t), "unsupported value size");
+		auto zero = _mm_setzero_si128();
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi32(v, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2), _mm_unpackhi_epi32(v, zero));
+	}
+}
+
+// widens 16 bytes to 16 values
+template <typename unsigned_type>
+UTKI_TARGET("sse2")
+void widen_16_bytes(__m128i v, unsigned_type* out) noexcept
+{
+	auto zero = _mm_setzero_si128();
+	auto lo = _mm_unpacklo_epi8(v, zero);
+	auto hi = _mm_unpackhi_epi8(v, zero);
+
+	if constexpr (sizeof(unsigned_type) == sizeof(uint16_t)) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), hi);
+	} else {
+		store_4_values(_mm_unpacklo_epi16(lo, zero), out);
+		store_4_values(_mm_unpackhi_epi16(lo, zero), out + 4);
+		store_4_values(_mm_unpacklo_epi16(hi, zero), out + 8);
+		store_4_values(_mm_unpackhi_epi16(hi, zero), out + 12);
+	}
+}
+
+template <typename unsigned_type>
+UTKI_TARGET("sse2")
+size_t decode_varuints_sse2(utki::span<const uint8_t> in, utki::span<unsigned_type> out) noexcept
+{
+	constexpr size_t block_size = 16;
+
+	// decode_varuint() reads 8 bytes, the value can start at the last byte of the block
+	constexpr size_t min_input_size = block_size + sizeof(uint64_t);
+
+	auto p = in.data();
+	auto end = p + in.size();
+	auto o = out.data();
+	auto out_end = o + out.size();
+
+	// the block can contain up to 16 values, so process blocks while the output has space for that many
+	while (size_t(end - p) >= min_input_size && size_t(out_end - o) >= block_size) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		// bit mask of bytes which terminate encoded values, i.e. having continuation bit cleared
+		auto terminators = ~unsigned(_mm_movemask_epi8(v)) & 0xffff;
+
+		if (terminators == 0xffff) {
+			// all values are single byte
+			widen_16_bytes(v, o);
+			p += block_size;
+			o += block_size;
+			continue;
+		}
+
+		if (terminators == 0) {
+			// encoded value is longer than 16 bytes, none of the supported types is that long
+			return decode_failed;
+		}
+
+		// decode values terminated within the block,
+		// the value which is not terminated within the block will be decoded as part of the next block
+		size_t start = 0;
+		do {
+			auto stop = size_t(utki::countr_zero(terminators)) + 1;
+			if (!decode_varuint(p + start, stop - start, *o)) {
+				return decode_failed;
+			}
+			++o;
+			start = stop;
+			terminators &= terminators - 1;
+		} while (terminators != 0);
+
+		p += start;
+	}
+
+	auto num_consumed = size_t(p - in.data());
+	auto num_decoded = size_t(o - out.data());
+
+	auto num_consumed_tail = decode_varuints_scalar(in.subspan(num_consumed), out.subspan(num_decoded));
+	if (num_consumed_tail == decode_failed) {
+		return decode_failed;
+	}
+	return num_consumed + num_consumed_tail;
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+
+#endif // ~UTKI_SIMD_X86
+
+template <typename unsigned_type>
+decode_varuints_function_type<unsigned_type> select_decode_varuints_function() noexcept
+{
+#if defined(UTKI_SIMD_X86)
+	const auto& features = utki::get_cpu_features();
+	if (features.sse2) {
+		return &decode_varuints_sse2<unsigned_type>;
+	}
+#endif
+	return &decode_varuints_scalar<unsigned_type>;
+}
+
+template <typename unsigned_type>
+size_t decode_varuints(utki::span<const uint8_t> in, utki::span<unsigned_type> out) noexcept
+{
+	static const auto decode_function = select_decode_varuints_function<unsigned_type>();
+
+	return decode_function(in, out);
+}
+
+template <typename unsigned_type>
+utki::span<const uint8_t> read_varuints(utki::span<const uint8_t> data, utki::span<unsigned_type> out)
+{
+	auto num_consumed = decode_varuints(data, out);
+	if (num_consumed == decode_failed) {
+		throw std::invalid_argument("deserializer::read_varuint_array(): malformed or truncated varint");
+	}
+	return data.subspan(num_consumed);
+}
+} // namespace
+
+void deserializer::read_varuint_array(utki::span<uint16_t> out)
+{
+	this->data = read_varuints(this->data, out);
+}
+
+void deserializer::read_varuint_array(utki::span<uint32_t> out)
+{
+	this->data = read_varuints(this->data, out);
+}
+
+void deserializer::read_varuint_array(utki::span<uint64_t> out)
+{
+	this->data = read_varuints(this->data, out);
+}
+
+void checked_deserializer::read_array(utki::span<uint8_t> out, size_t value_size, bool big_endian) noexcept
+{
+	if (this->size() < out.size()) {
+		this->set_error();
+		std::fill(out.begin(), out.end(), 0);
+		return;
+	}
+
+	ASSERT(out.size() % value_size == 0)
+
+	copy_values(this->data.subspan(0, out.size()), out.data(), value_size, big_endian);
+	this->data = this->data.subspan(out.size());
+}
+
+template <typename unsigned_type>
+void checked_deserializer::read_varuints(utki::span<unsigned_type> out) noexcept
+{
+	auto num_consumed = decode_varuints(this->data, out);
+	if (num_consumed == decode_failed) {
+		this->set_error();
+		std::fill(out.begin(), out.end(), 0);
+		return;
+	}
+	this->data = this->data.subspan(num_consumed);
+}
+
+void checked_deserializer::read_varuint_array(utki::span<uint16_t> out) noexcept
+{
+	this->read_varuints(out);
+}
+
+void checked_deserializer::read_varuint_array(utki::span<uint32_t> out) noexcept
+{
+	this->read_varuints(out);
+}
+
+void checked_deserializer::read_varuint_array(utki::span<uint64_t> out) noexcept
+{
+	this->read_varuints(out);
+}
@@ -28,14 +28,40 @@ SOFTWARE.
 
 #pragma once
 
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+
 #include "span.hpp"
+#include "struct_layout.hpp"
+#include "utility.hpp"
 
 namespace utki {
 
 class deserializer
 {
+	friend class checked_deserializer;
+
 	utki::span<const uint8_t> data;
 
+	void read_array(utki::span<uint8_t> out, size_t value_size, bool big_endian);
+
+	template <typename value_type>
+	static utki::span<uint8_t> to_bytes(utki::span<value_type> values) noexcept
+	{
+		static_assert(
+			std::is_arithmetic_v<value_type> && !std::is_same_v<value_type, bool>,
+			"array element type must be arithmetic"
+		);
+		static_assert(
+			sizeof(value_type) == 1 || sizeof(value_type) == 2 || sizeof(value_type) == 4 || sizeof(value_type) == 8,
+			"array element size must be 1, 2, 4 or 8 bytes"
+		);
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		return {reinterpret_cast<uint8_t*>(values.data()), values.size_bytes()};
+	}
+
 public:
 	deserializer(utki::span<const uint8_t> data) :
 		data(data)
@@ -61,13 +87,372 @@ public:
 	uint32_t read_uint32_le();
 	uint64_t read_uint64_le();
 	float read_float_le();
+	double read_double_le();
 
 	uint16_t read_uint16_be();
 	uint32_t read_uint32_be();
 	uint64_t read_uint64_be();
 	float read_float_be();
+	double read_double_be();
+
+	/**
+	 * @brief Read array of values, little-endian.
+	 * Reads as many values as the output span holds, doing a single buffer size check for the whole array.
+	 * @param out - span to read the values to.
+	 * @throw std::invalid_argument - in case the buffer has less bytes than needed to fill the output span.
+	 */
+	template <typename value_type>
+	void read_array_le(utki::span<value_type> out)
+	{
+		this->read_array(to_bytes(out), sizeof(value_type), false);
+	}
+
+	/**
+	 * @brief Read array of values, big-endian.
+	 * Reads as many values as the output span holds, doing a single buffer size check for the whole array.
+	 * @param out - span to read the values to.
+	 * @throw std::invalid_argument - in case the buffer has less bytes than needed to fill the output span.
+	 */
+	template <typename value_type>
+	void read_array_be(utki::span<value_type> out)
+	{
+		this->read_array(to_bytes(out), sizeof(value_type), true);
+	}
+
+	/**
+	 * @brief Read struct.
+	 * Reads all fields of the struct with a single buffer size check.
+	 * @tparam layout_type - binary layout of the struct, see struct_layout.
+	 * @return The read struct.
+	 * @throw std::invalid_argument - in case the buffer has less bytes than the struct occupies.
+	 */
+	template <typename layout_type>
+	typename layout_type::object_type read_struct()
+	{
+		if (this->size() < layout_type::size) {
+			throw std::invalid_argument("deserializer::read_struct(): buffer has less bytes then needed");
+		}
+
+		typename layout_type::object_type ret{};
+		layout_type::read(this->data.data(), ret);
+		this->data = this->data.subspan(layout_type::size);
+		return ret;
+	}
+
+	/**
+	 * @brief Read unsigned integral value, LEB128 variable length encoding.
+	 * @return The read value.
+	 * @throw std::invalid_argument - in case the buffer does not start with a complete encoded value
+	 *        or the value does not fit into the unsigned_type.
+	 */
+	template <typename unsigned_type>
+	unsigned_type read_varuint()
+	{
+		unsigned_type ret = 0;
+		auto size = utki::deserialize_varuint(this->data, ret);
+		if (size == 0) {
+			throw std::invalid_argument("deserializer::read_varuint(): malformed or truncated varint");
+		}
+
+		this->data = this->data.subspan(size);
+		return ret;
+	}
+
+	/**
+	 * @brief Read signed integral value, zigzag LEB128 variable length encoding.
+	 * @return The read value.
+	 * @throw std::invalid_argument - in case the buffer does not start with a complete encoded value
+	 *        or the value does not fit into the signed_type.
+	 */
+	template <typename signed_type>
+	signed_type read_varint()
+	{
+		return utki::zigzag_decode(this->read_varuint<std::make_unsigned_t<signed_type>>());
+	}
+
+	/**
+	 * @brief Read array of unsigned integral values, LEB128 variable length encoding.
+	 * Reads as many values as the output span holds.
+	 * Runs of single byte values and values terminated within a 16 byte block are decoded block-wise.
+	 * In case of an error the deserializer is left unchanged, the output span contents are unspecified.
+	 * @param out - span to read the values to.
+	 * @throw std::invalid_argument - in case the buffer does not contain enough values
+	 *        or a value does not fit into the output type.
+	 */
+	void read_varuint_array(utki::span<uint16_t> out);
+	void read_varuint_array(utki::span<uint32_t> out);
+	void read_varuint_array(utki::span<uint64_t> out);
+
+	/**
+	 * @brief Read array of signed integral values, zigzag LEB128 variable length encoding.
+	 * See read_varuint_array().
+	 * @param out - span to read the values to.
+	 * @throw std::invalid_argument - in case the buffer does not contain enough values
+	 *        or a value does not fit into the output type.
+	 */
+	template <typename signed_type>
+	void read_varint_array(utki::span<signed_type> out)
+	{
+		static_assert(std::is_signed_v<signed_type>, "array element type must be signed");
+
+		using unsigned_type = std::make_unsigned_t<signed_type>;
+
+		// signed and unsigned variants of the same type can alias each other
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		utki::span<unsigned_type> values(reinterpret_cast<unsigned_type*>(out.data()), out.size());
+
+		this->read_varuint_array(values);
+
+		for (auto& v : values) {
+			v = unsigned_type(utki::zigzag_decode(v));
+		}
+	}
 
 	void skip(size_t length);
 };
 
+/**
+ * @brief Non-throwing deserializer.
+ * Has the same reading methods as deserializer, but instead of throwing on errors
+ * it sets the sticky error flag and returns zero values or empty spans.
+ * Once the error flag is set, all further reads return zero values and do not consume any data.
+ * This allows decoding a whole message without checking each read and validating the result once at the end.
+ */
+class checked_deserializer
+{
+	utki::span<const uint8_t> data;
+
+	bool error_flag = false;
+
+	// zero bytes for reading default values in case of error
+	constexpr static std::array<uint8_t, sizeof(uint64_t)> zeros{};
+
+	// consumes given number of bytes, returns pointer to zero bytes in case of error
+	const uint8_t* consume(size_t size) noexcept
+	{
+		ASSERT(size <= zeros.size())
+
+		if (this->data.size() < size) {
+			this->set_error();
+			return zeros.data();
+		}
+
+		auto ret = this->data.data();
+		this->data = this->data.subspan(size);
+		return ret;
+	}
+
+	void set_error() noexcept
+	{
+		this->error_flag = true;
+		this->data = {};
+	}
+
+	void read_array(utki::span<uint8_t> out, size_t value_size, bool big_endian) noexcept;
+
+	template <typename unsigned_type>
+	void read_varuints(utki::span<unsigned_type> out) noexcept;
+
+public:
+	checked_deserializer(utki::span<const uint8_t> data) noexcept :
+		data(data)
+	{}
+
+	/**
+	 * @brief Check if an error has occurred.
+	 * The error flag is set when a read requests more data than is left in the buffer
+	 * or when malformed data is encountered.
+	 * @return true if any of the reads has failed.
+	 * @return false otherwise.
+	 */
+	bool error() const noexcept
+	{
+		return this->error_flag;
+	}
+
+	bool empty() const noexcept
+	{
+		return this->data.empty();
+	}
+
+	size_t size() const noexcept
+	{
+		return this->data.size();
+	}
+
+	std::string_view read_string(size_t length) noexcept
+	{
+		auto span = this->read_span(length);
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		return {reinterpret_cast<const char*>(span.data()), span.size()};
+	}
+
+	utki::span<const uint8_t> read_span(size_t length) noexcept
+	{
+		if (this->data.size() < length) {
+			this->set_error();
+			return {};
+		}
+
+		auto ret = this->data.subspan(0, length);
+		this->data = this->data.subspan(length);
+		return ret;
+	}
+
+	uint8_t read_uint8() noexcept
+	{
+		return *this->consume(sizeof(uint8_t));
+	}
+
+	uint16_t read_uint16_le() noexcept
+	{
+		return utki::deserialize16le(this->consume(sizeof(uint16_t)));
+	}
+
+	uint32_t read_uint32_le() noexcept
+	{
+		return utki::deserialize32le(this->consume(sizeof(uint32_t)));
+	}
+
+	uint64_t read_uint64_le() noexcept
+	{
+		return utki::deserialize64le(this->consume(sizeof(uint64_t)));
+	}
+
+	float read_float_le() noexcept
+	{
+		return utki::deserialize_float_le(this->consume(sizeof(float)));
+	}
+
+	double read_double_le() noexcept
+	{
+		return utki::deserialize_double_le(this->consume(sizeof(double)));
+	}
+
+	uint16_t read_uint16_be() noexcept
+	{
+		return utki::deserialize16be(this->consume(sizeof(uint16_t)));
+	}
+
+	uint32_t read_uint32_be() noexcept
+	{
+		return utki::deserialize32be(this->consume(sizeof(uint32_t)));
+	}
+
+	uint64_t read_uint64_be() noexcept
+	{
+		return utki::deserialize64be(this->consume(sizeof(uint64_t)));
+	}
+
+	float read_float_be() noexcept
+	{
+		return utki::deserialize_float_be(this->consume(sizeof(float)));
+	}
+
+	double read_double_be() noexcept
+	{
+		return utki::deserialize_double_be(this->consume(sizeof(double)));
+	}
+
+	/**
+	 * @brief Read array of values, little-endian.
+	 * In case of error the output span is filled with zeros.
+	 * @param out - span to read the values to.
+	 */
+	template <typename value_type>
+	void read_array_le(utki::span<value_type> out) noexcept
+	{
+		this->read_array(deserializer::to_bytes(out), sizeof(value_type), false);
+	}
+
+	/**
+	 * @brief Read array of values, big-endian.
+	 * In case of error the output span is filled with zeros.
+	 * @param out - span to read the values to.
+	 */
+	template <typename value_type>
+	void read_array_be(utki::span<value_type> out) noexcept
+	{
+		this->read_array(deserializer::to_bytes(out), sizeof(value_type), true);
+	}
+
+	/**
+	 * @brief Read struct.
+	 * In case of error a value-initialized struct is returned.
+	 * @tparam layout_type - binary layout of the struct, see struct_layout.
+	 * @return The read struct.
+	 */
+	template <typename layout_type>
+	typename layout_type::object_type read_struct() noexcept
+	{
+		typename layout_type::object_type ret{};
+
+		if (this->data.size() < layout_type::size) {
+			this->set_error();
+			return ret;
+		}
+
+		layout_type::read(this->data.data(), ret);
+		this->data = this->data.subspan(layout_type::size);
+		return ret;
+	}
+
+	template <typename unsigned_type>
+	unsigned_type read_varuint() noexcept
+	{
+		unsigned_type ret = 0;
+		auto size = utki::deserialize_varuint(this->data, ret);
+		if (size == 0) {
+			this->set_error();
+			return 0;
+		}
+
+		this->data = this->data.subspan(size);
+		return ret;
+	}
+
+	template <typename signed_type>
+	signed_type read_varint() noexcept
+	{
+		return utki::zigzag_decode(this->read_varuint<std::make_unsigned_t<signed_type>>());
+	}
+
+	/**
+	 * @brief Read array of unsigned integral values, LEB128 variable length encoding.
+	 * In case of error the output span is filled with zeros.
+	 * @param out - span to read the values to.
+	 */
+	void read_varuint_array(utki::span<uint16_t> out) noexcept;
+	void read_varuint_array(utki::span<uint32_t> out) noexcept;
+	void read_varuint_array(utki::span<uint64_t> out) noexcept;
+
+	/**
+	 * @brief Read array of signed integral values, zigzag LEB128 variable length encoding.
+	 * In case of error the output span is filled with zeros.
+	 * @param out - span to read the values to.
+	 */
+	template <typename signed_type>
+	void read_varint_array(utki::span<signed_type> out) noexcept
+	{
+		static_assert(std::is_signed_v<signed_type>, "array element type must be signed");
+
+		using unsigned_type = std::make_unsigned_t<signed_type>;
+
+		// signed and unsigned variants of the same type can alias each other
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		utki::span<unsigned_type> values(reinterpret_cast<unsigned_type*>(out.data()), out.size());
+
+		this->read_varuint_array(values);
+
+		for (auto& v : values) {
+			v = unsigned_type(utki::zigzag_decode(v));
+		}
+	}
+
+	void skip(size_t length) noexcept
+	{
+		this->read_span(length);
+	}
+};
+
 } // namespace utki
@@ -0,0 +1,991 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "debug.hpp"
+#include "span.hpp"
+#include "tree.hpp"
+
+namespace utki {
+
+/**
+ * @brief N-ary tree stored in a single contiguous array.
+ * The flat_tree holds a list of trees, same as the list of utki::tree nodes which utki::traversal works on.
+ * All tree nodes are stored in pre-order in one array of values, so traversing the whole tree
+ * is a linear walk through memory and no per-node heap allocations are made.
+ * Along with each node value its subtree size and its parent index are stored,
+ * so next sibling of a node is found by skipping the node's subtree.
+ * The flat_tree provides same interface for traversing the tree as utki::traversal does, but its
+ * iterators dereference to the node value instead of a tree node.
+ * Inserting and erasing nodes is O(number of nodes), so the flat_tree is intended for the trees
+ * which are built once and then traversed many times.
+ * @tparam element_type - the tree node data type.
+ */
+template <class element_type>
+class flat_tree
+{
+public:
+	/**
+	 * @brief Type of the tree node value.
+	 */
+	using value_type = element_type;
+
+	/**
+	 * @brief Pointer to tree node value type.
+	 */
+	using pointer = value_type*;
+
+	/**
+	 * @brief Constant pointer to tree node value type.
+	 */
+	using const_pointer = const value_type*;
+
+	/**
+	 * @brief Reference to tree node value type.
+	 */
+	using reference = value_type&;
+
+	/**
+	 * @brief Constant reference to tree node value type.
+	 */
+	using const_reference = const value_type&;
+
+	/**
+	 * @brief Node index type.
+	 */
+	using size_type = size_t;
+
+	/**
+	 * @brief Node index difference type.
+	 */
+	using difference_type = std::ptrdiff_t;
+
+	/**
+	 * @brief utki::tree type the flat_tree can be converted from and to.
+	 */
+	using tree_type = tree<element_type>;
+
+	/**
+	 * @brief List of utki::tree nodes type.
+	 */
+	using tree_container_type = typename tree_type::container_type;
+
+private:
+	constexpr static const size_type no_parent = std::numeric_limits<size_type>::max();
+
+	struct node_link {
+		// number of nodes in the subtree, including the node itself
+		size_type subtree_size;
+		size_type parent;
+
+		bool operator==(const node_link& l) const noexcept
+		{
+			return this->subtree_size == l.subtree_size && this->parent == l.parent;
+		}
+	};
+
+	std::vector<element_type> node_values;
+	std::vector<node_link> node_links;
+
+	template <class list_type>
+	void append(list_type&& trees, size_type parent)
+	{
+		constexpr bool move_values = !std::is_lvalue_reference_v<list_type>;
+
+		struct frame {
+			using list_pointer_type = decltype(&trees);
+
+			list_pointer_type list;
+			size_type child;
+			size_type node;
+		};
+
+		std::vector<frame> stack;
+		stack.push_back(frame{&trees, 0, parent});
+
+		while (!stack.empty()) {
+			auto& top = stack.back();
+			if (top.child == top.list->size()) {
+				if (top.node != parent) {
+					this->node_links[top.node].subtree_size = this->size() - top.node;
+				}
+				stack.pop_back();
+				continue;
+			}
+
+			auto& t = (*top.list)[top.child];
+			++top.child;
+
+			auto index = this->size();
+			if constexpr (move_values) {
+				this->node_values.push_back(std::move(t.value));
+			} else {
+				this->node_values.push_back(t.value);
+			}
+			this->node_links.push_back(node_link{1, top.node});
+
+			// NOTE: push_back() invalidates the 'top' reference
+			stack.push_back(frame{&t.children, 0, index});
+		}
+	}
+
+	template <class tree_ref_type>
+	void append_tree(tree_ref_type&& t, size_type parent)
+	{
+		auto index = this->size();
+		this->node_values.push_back(std::forward<tree_ref_type>(t).value);
+		this->node_links.push_back(node_link{1, parent});
+
+		this->append(std::forward<tree_ref_type>(t).children, index);
+
+		this->node_links[index].subtree_size = this->size() - index;
+	}
+
+	void insert_nodes(size_type pos, flat_tree&& nodes, size_type parent)
+	{
+		ASSERT(pos <= this->size())
+
+		size_type num = nodes.size();
+		if (num == 0) {
+			return;
+		}
+
+		for (size_type i = pos; i != this->size(); ++i) {
+			auto& p = this->node_links[i].parent;
+			if (p != no_parent && p >= pos) {
+				p += num;
+			}
+		}
+
+		for (auto& l : nodes.node_links) {
+			if (l.parent == no_parent) {
+				l.parent = parent;
+			} else {
+				l.parent += pos;
+			}
+		}
+
+		for (auto p = parent; p != no_parent; p = this->node_links[p].parent) {
+			this->node_links[p].subtree_size += num;
+		}
+
+		using std::begin;
+		using std::end;
+
+		this->node_values.insert(
+			std::next(begin(this->node_values), difference_type(pos)),
+			std::make_move_iterator(begin(nodes.node_values)),
+			std::make_move_iterator(end(nodes.node_values))
+		);
+		this->node_links.insert(
+			std::next(begin(this->node_links), difference_type(pos)),
+			begin(nodes.node_links),
+			end(nodes.node_links)
+		);
+	}
+
+	void erase_nodes(size_type pos)
+	{
+		ASSERT(pos < this->size())
+
+		size_type num = this->node_links[pos].subtree_size;
+
+		for (auto p = this->node_links[pos].parent; p != no_parent; p = this->node_links[p].parent) {
+			this->node_links[p].subtree_size -= num;
+		}
+
+		for (size_type i = pos + num; i != this->size(); ++i) {
+			auto& p = this->node_links[i].parent;
+			if (p != no_parent && p >= pos + num) {
+				p -= num;
+			}
+		}
+
+		using std::begin;
+
+		this->node_values.erase(
+			std::next(begin(this->node_values), difference_type(pos)),
+			std::next(begin(this->node_values), difference_type(pos + num))
+		);
+		this->node_links.erase(
+			std::next(begin(this->node_links), difference_type(pos)),
+			std::next(begin(this->node_links), difference_type(pos + num))
+		);
+	}
+
+	// get index of the node which follows the last child of the given parent node
+	size_type siblings_end(size_type parent) const noexcept
+	{
+		if (parent == no_parent) {
+			return this->size();
+		}
+		return parent + this->node_links[parent].subtree_size;
+	}
+
+public:
+	flat_tree() = default;
+
+	flat_tree(const flat_tree&) = default;
+	flat_tree& operator=(const flat_tree&) = default;
+
+	flat_tree(flat_tree&&) = default;
+	flat_tree& operator=(flat_tree&&) = default;
+
+	~flat_tree() = default;
+
+	/**
+	 * @brief Create flat tree from the list of utki::tree nodes.
+	 * The tree node values are copied.
+	 * @param trees - list of trees to make the flat tree from.
+	 */
+	flat_tree(const tree_container_type& trees)
+	{
+		this->append(trees, no_parent);
+	}
+
+	/**
+	 * @brief Create flat tree from the list of utki::tree nodes.
+	 * The tree node values are moved out of the given list of trees.
+	 * @param trees - list of trees to make the flat tree from.
+	 */
+	flat_tree(tree_container_type&& trees)
+	{
+		this->append(std::move(trees), no_parent);
+	}
+
+	/**
+	 * @brief Create flat tree from the list of utki::tree nodes.
+	 * @param trees - list of trees to make the flat tree from.
+	 */
+	flat_tree(std::initializer_list<tree_type> trees) :
+		flat_tree(tree_container_type(trees))
+	{}
+
+	/**
+	 * @brief Create flat tree from single utki::tree.
+	 * The resulting flat tree has one root node.
+	 * The tree node values are copied.
+	 * @param t - tree to make the flat tree from.
+	 */
+	flat_tree(const tree_type& t)
+	{
+		this->append_tree(t, no_parent);
+	}
+
+	/**
+	 * @brief Create flat tree from single utki::tree.
+	 * The resulting flat tree has one root node.
+	 * The tree node values are moved out of the given tree.
+	 * @param t - tree to make the flat tree from.
+	 */
+	flat_tree(tree_type&& t)
+	{
+		this->append_tree(std::move(t), no_parent);
+	}
+
+	/**
+	 * @brief Convert the flat tree to list of utki::tree nodes.
+	 * @return List of trees which has same structure and node values as this flat tree.
+	 */
+	tree_container_type to_trees() const
+	{
+		tree_container_type ret;
+
+		struct frame {
+			tree_container_type* list;
+			size_type end;
+		};
+
+		std::vector<frame> stack;
+		stack.push_back(frame{&ret, this->size()});
+
+		for (size_type i = 0; i != this->size(); ++i) {
+			while (i == stack.back().end) {
+				stack.pop_back();
+				ASSERT(!stack.empty())
+			}
+
+			auto& list = *stack.back().list;
+			list.emplace_back(this->node_values[i]);
+
+			const auto& l = this->node_links[i];
+			if (l.subtree_size != 1) {
+				stack.push_back(frame{&list.back().children, i + l.subtree_size});
+			}
+		}
+
+		return ret;
+	}
+
+	/**
+	 * @brief Get total number of nodes in the tree.
+	 * @return Number of nodes in the tree.
+	 */
+	size_type size() const noexcept
+	{
+		return this->node_values.size();
+	}
+
+	/**
+	 * @brief Check if the tree has no nodes.
+	 * @return true if the tree has no nodes.
+	 * @return false otherwise.
+	 */
+	bool empty() const noexcept
+	{
+		return this->node_values.empty();
+	}
+
+	/**
+	 * @brief Get values of all tree nodes.
+	 * The values are in pre-order, i.e. in the order the tree traversal visits them.
+	 * @return Span of all node values.
+	 */
+	utki::span<element_type> values() noexcept
+	{
+		return utki::make_span(this->node_values);
+	}
+
+	/**
+	 * @brief Get values of all tree nodes.
+	 * Constant version of values().
+	 * @return Span of all node values.
+	 */
+	utki::span<const element_type> values() const noexcept
+	{
+		return utki::make_span(this->node_values);
+	}
+
+	bool operator==(const flat_tree& t) const noexcept
+	{
+		return this->node_links == t.node_links && this->node_values == t.node_values;
+	}
+
+	bool operator!=(const flat_tree& t) const noexcept
+	{
+		return !this->operator==(t);
+	}
+
+private:
+	template <bool is_const>
+	class iterator_internal
+	{
+		using owner_type = typename std::conditional_t< //
+			is_const,
+			const flat_tree,
+			flat_tree>;
+
+		owner_type* owner = nullptr;
+		size_type node = 0;
+
+		friend class flat_tree;
+
+		iterator_internal(owner_type& owner, size_type node) :
+			owner(&owner),
+			node(node)
+		{}
+
+	public:
+		iterator_internal() = default;
+
+		/**
+		 * @brief Tree node value type.
+		 */
+		using value_type = typename std::conditional_t< //
+			is_const,
+			const element_type,
+			element_type>;
+
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+		using difference_type = typename flat_tree::difference_type;
+
+		/**
+		 * @brief Move iterator to the next tree node.
+		 * The iterator is moved to the next tree node in pre-order.
+		 * @return Reference to this iterator.
+		 */
+		iterator_internal& operator++() noexcept
+		{
+			ASSERT(this->node < this->owner->size())
+			++this->node;
+			return *this;
+		}
+
+		/**
+		 * @brief Move iterator to the previous tree node.
+		 * The iterator is moved to the previous tree node in pre-order.
+		 * @return Reference to this iterator.
+		 */
+		iterator_internal& operator--() noexcept
+		{
+			ASSERT(this->node != 0)
+			--this->node;
+			return *this;
+		}
+
+		/**
+		 * @brief Move iterator past the subtree of the current tree node.
+		 * After this operation the iterator points to the next sibling of the current node,
+		 * or, if there is no next sibling, to the tree node which follows the current node's subtree in pre-order.
+		 * @return Reference to this iterator.
+		 */
+		iterator_internal& skip_subtree() noexcept
+		{
+			ASSERT(this->node < this->owner->size())
+			this->node += this->owner->node_links[this->node].subtree_size;
+			return *this;
+		}
+
+		/**
+		 * @brief Get number of nodes in the subtree of the current tree node.
+		 * @return Number of nodes in the subtree, including the current tree node itself.
+		 */
+		size_type subtree_size() const noexcept
+		{
+			ASSERT(this->node < this->owner->size())
+			return this->owner->node_links[this->node].subtree_size;
+		}
+
+		/**
+		 * @brief Chack that two iterators point to the same tree node.
+		 * @return false in case this iterator points to a different tree node than the given iterator.
+		 * @return true in case this iterator points to the same tree node as the given iterator.
+		 */
+		bool operator==(const iterator_internal& iter) const noexcept
+		{
+			return this->node == iter.node;
+		}
+
+		/**
+		 * @brief Check that iterators point to different tree nodes.
+		 * @return true in case this iterator points to a different tree node than the given iterator.
+		 * @return false in case this iterator points to the same tree node as the given iterator.
+		 */
+		bool operator!=(const iterator_internal& iter) const noexcept
+		{
+			return !this->operator==(iter);
+		}
+
+		/**
+		 * @brief Check if this iterator precedes given iterator in traversal order.
+		 * @param iter - iterator to compare this iterator with.
+		 * @return true if this iterator precedes the given iterator in traversal order.
+		 * @return false otherwise.
+		 */
+		bool operator<(const iterator_internal& iter) const noexcept
+		{
+			return this->node < iter.node;
+		}
+
+		/**
+		 * @brief Check if this iterator follows given iterator in traversal order.
+		 * @param iter - iterator to compare this iterator with.
+		 * @return true if this iterator follows the given iterator in traversal order.
+		 * @return false otherwise.
+		 */
+		bool operator>(const iterator_internal& iter) const noexcept
+		{
+			return this->node > iter.node;
+		}
+
+		/**
+		 * @brief Check if this iterator precedes given iterator in traversal order or is equal to it.
+		 * @param iter - iterator to compare this iterator with.
+		 * @return true if this iterator precedes the given iterator in traversal order or is equal to it.
+		 * @return false otherwise.
+		 */
+		bool operator<=(const iterator_internal& iter) const noexcept
+		{
+			return this->node <= iter.node;
+		}
+
+		/**
+		 * @brief Check if this iterator follows given iterator in traversal order or is equal to it.
+		 * @param iter - iterator to compare this iterator with.
+		 * @return true if this iterator follows the given iterator in traversal order or is equal to it.
+		 * @return false otherwise.
+		 */
+		bool operator>=(const iterator_internal& iter) const noexcept
+		{
+			return this->node >= iter.node;
+		}
+
+		/**
+		 * @brief Dereference the tree node value.
+		 * @return Reference to the value of the tree node this iterator points to.
+		 */
+		value_type& operator*() const noexcept
+		{
+			ASSERT(this->node < this->owner->size())
+			return this->owner->node_values[this->node];
+		}
+
+		/**
+		 * @brief Dereference the tree node value.
+		 * @return Pointer to the value of the tree node this iterator points to.
+		 */
+		value_type* operator->() const noexcept
+		{
+			return &this->operator*();
+		}
+
+		/**
+		 * @brief Get index of the tree node.
+		 * The index of the tree node into the tree hierarchy is the list of indices into
+		 * tree node children lists starting from the root list of tree nodes.
+		 * @return the index into tree hierarchy of the tree node this iterator points to.
+		 */
+		std::vector<size_type> index() const
+		{
+			std::vector<size_type> ret;
+			if (this->node == this->owner->size()) {
+				return ret;
+			}
+
+			for (auto n = this->node; n != no_parent;) {
+				auto parent = this->owner->node_links[n].parent;
+
+				size_type i = 0;
+				for (auto s = parent == no_parent ? 0 : parent + 1; s != n; ++i) {
+					s += this->owner->node_links[s].subtree_size;
+				}
+				ret.push_back(i);
+
+				n = parent;
+			}
+
+			std::reverse(ret.begin(), ret.end());
+			return ret;
+		}
+
+		/**
+		 * @brief Get iterator depth.
+		 * Zero depth means that the iterator does not point to any tree node.
+		 * Depth of one means that the iterator points to one of the root nodes.
+		 * And so on.
+		 * The depth is calculated by walking up to the root node, so it is O(depth).
+		 * @return number depth of the tree node the iterator points to.
+		 */
+		size_t depth() const noexcept
+		{
+			if (this->node == this->owner->size()) {
+				return 0;
+			}
+
+			size_t ret = 0;
+			for (auto n = this->node; n != no_parent; n = this->owner->node_links[n].parent) {
+				++ret;
+			}
+			return ret;
+		}
+
+		/**
+		 * @brief Dereference the tree node value at given tree level.
+		 * @param d - tree level.
+		 * @return Reference to the value of the tree node this iterator points to on the requested tree level.
+		 * @throw std::out_of_range - in case the requested tree level is higher than the iterator depth.
+		 */
+		value_type& at_level(size_t d) const
+		{
+			auto dep = this->depth();
+			if (d >= dep) {
+				throw std::out_of_range("flat_tree::iterator::at_level(): requested level is deeper than the iterator");
+			}
+
+			auto n = this->node;
+			for (; dep != d + 1; --dep) {
+				n = this->owner->node_links[n].parent;
+			}
+			return this->owner->node_values[n];
+		}
+
+		/**
+		 * @brief Check if this iterator points to the last tree node on the current tree level.
+		 * @return true if the iterator points to the last tree node on the current tree level.
+		 * @return false otherwise.
+		 */
+		bool is_last_child() const noexcept
+		{
+			if (this->node == this->owner->size()) {
+				return false;
+			}
+
+			const auto& l = this->owner->node_links[this->node];
+			return this->node + l.subtree_size == this->owner->siblings_end(l.parent);
+		}
+	};
+
+public:
+	/**
+	 * @brief Iterator type.
+	 * The iterator performs the pre-order traversal of the tree.
+	 */
+	using iterator = iterator_internal<false>;
+
+	/**
+	 * @brief Constant iterator type.
+	 * The iterator performs the pre-order traversal of the tree.
+	 */
+	using const_iterator = iterator_internal<true>;
+
+	/**
+	 * @brief Reverse iterator type.
+	 * The iterator performs the traversal of the tree.
+	 */
+	using reverse_iterator = std::reverse_iterator<iterator>;
+
+	/**
+	 * @brief Constant reverse iterator type.
+	 * The iterator performs the traversal of the tree.
+	 */
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+	size_type find(utki::span<const size_type> index) const
+	{
+		if (index.empty()) {
+			return this->size();
+		}
+
+		size_type n = 0;
+		size_type end = this->size();
+
+		for (auto i : index) {
+			for (; i != 0; --i) {
+				if (n >= end) {
+					throw std::out_of_range("given index points out of the tree");
+				}
+				n += this->node_links[n].subtree_size;
+			}
+			if (n >= end) {
+				throw std::out_of_range("given index points out of the tree");
+			}
+			end = n + this->node_links[n].subtree_size;
+			++n;
+		}
+
+		return n - 1;
+	}
+
+public:
+	/**
+	 * @brief Create iterator which points to the tree node given by index.
+	 * @param index - the index of the tree node.
+	 * @return Iterator which points to the tree node given by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	iterator make_iterator(utki::span<const size_type> index)
+	{
+		return iterator(*this, this->find(index));
+	}
+
+	/**
+	 * @brief Create iterator which points to the tree node given by index.
+	 * @param index - the index of the tree node.
+	 * @return Iterator which points to the tree node given by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	iterator make_iterator(std::initializer_list<size_t> index)
+	{
+		return this->make_iterator(utki::make_span(index));
+	}
+
+	/**
+	 * @brief Create constant iterator which points to the tree node given by index.
+	 * @param index - the index of the tree node.
+	 * @return Constant iterator which points to the tree node given by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	const_iterator make_const_iterator(utki::span<const size_type> index) const
+	{
+		return const_iterator(*this, this->find(index));
+	}
+
+	/**
+	 * @brief Create constant iterator which points to the tree node given by index.
+	 * @param index - the index of the tree node.
+	 * @return Constant iterator which points to the tree node given by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	const_iterator make_const_iterator(std::initializer_list<size_t> index) const
+	{
+		return this->make_const_iterator(utki::make_span(index));
+	}
+
+	/**
+	 * @brief Check if the given index is valid.
+	 * Checks that the given index points to the existing tree node within the
+	 * tree hierarchy, i.e. the index does not point out of the tree bounds.
+	 * @param index - index to check for validity.
+	 * @return true in case the given index is valid.
+	 * @return false in case the given index is invalid.
+	 */
+	bool is_valid(utki::span<const size_type> index) const noexcept
+	{
+		if (index.empty()) {
+			return false;
+		}
+
+		size_type n = 0;
+		size_type end = this->size();
+
+		for (auto i : index) {
+			for (; i != 0 && n < end; --i) {
+				n += this->node_links[n].subtree_size;
+			}
+			if (n >= end) {
+				return false;
+			}
+			end = n + this->node_links[n].subtree_size;
+			++n;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Check if the given index is valid.
+	 * Checks that the given index points to the existing tree node within the
+	 * tree hierarchy, i.e. the index does not point out of the tree bounds.
+	 * @param index - index to check for validity.
+	 * @return true in case the given index is valid.
+	 * @return false in case the given index is invalid.
+	 */
+	bool is_valid(std::initializer_list<size_t> index) const noexcept
+	{
+		return this->is_valid(utki::make_span(index));
+	}
+
+	/**
+	 * @brief Get reference to tree node value by index.
+	 * @param index - index of the tree node.
+	 * @return reference to the value of the tree node referred by index.
+	 */
+	element_type& operator[](utki::span<const size_type> index)
+	{
+		ASSERT(this->is_valid(index))
+		return this->node_values[this->find(index)];
+	}
+
+	/**
+	 * @brief Get constant reference to tree node value by index.
+	 * @param index - index of the tree node.
+	 * @return reference to the value of the tree node referred by index.
+	 */
+	const element_type& operator[](utki::span<const size_type> index) const
+	{
+		ASSERT(this->is_valid(index))
+		return this->node_values[this->find(index)];
+	}
+
+	/**
+	 * @brief Get reference to tree node value by index.
+	 * @param index - index of the tree node.
+	 * @return reference to the value of the tree node referred by index.
+	 */
+	element_type& operator[](std::initializer_list<size_t> index)
+	{
+		return this->operator[](utki::make_span(index));
+	}
+
+	/**
+	 * @brief Get constant reference to tree node value by index.
+	 * @param index - index of the tree node.
+	 * @return reference to the value of the tree node referred by index.
+	 */
+	const element_type& operator[](std::initializer_list<size_t> index) const
+	{
+		return this->operator[](utki::make_span(index));
+	}
+
+	/**
+	 * @brief Get iterator pointing to the beginning of the tree hierarchy.
+	 * @return Iterator pointing to the beginning of the tree hierarchy.
+	 */
+	iterator begin() noexcept
+	{
+		return iterator(*this, 0);
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the beginning of the tree hierarchy.
+	 * @return Constant iterator pointing to the beginning of the tree hierarchy.
+	 */
+	const_iterator cbegin() const noexcept
+	{
+		return const_iterator(*this, 0);
+	}
+
+	/**
+	 * @brief Get iterator pointing to the end of the tree hierarchy.
+	 * @return Iterator pointing to the end of the tree hierarchy.
+	 */
+	iterator end() noexcept
+	{
+		return iterator(*this, this->size());
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the end of the tree hierarchy.
+	 * @return constant iterator pointing to the end of the tree hierarchy.
+	 */
+	const_iterator cend() const noexcept
+	{
+		return const_iterator(*this, this->size());
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the beginning of the tree hierarchy.
+	 * @return Constant iterator pointing to the beginning of the tree hierarchy.
+	 */
+	const_iterator begin() const noexcept
+	{
+		return this->cbegin();
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the end of the tree hierarchy.
+	 * @return constant iterator pointing to the end of the tree hierarchy.
+	 */
+	const_iterator end() const noexcept
+	{
+		return this->cend();
+	}
+
+	/**
+	 * @brief Get constant reverse iterator pointing to the reverse beginning of the tree hierarchy.
+	 * @return Constant reverse iterator pointing to the reverse beginning of the tree hierarchy.
+	 */
+	const_reverse_iterator crbegin() const noexcept
+	{
+		return const_reverse_iterator(this->cend());
+	}
+
+	/**
+	 * @brief Get constant reverse iterator pointing to the reverse end of the tree hierarchy.
+	 * @return constant reverse iterator pointing to the reverse end of the tree hierarchy.
+	 */
+	const_reverse_iterator crend() const noexcept
+	{
+		return const_reverse_iterator(this->cbegin());
+	}
+
+	/**
+	 * @brief Get reverse iterator pointing to the reverse beginning of the tree hierarchy.
+	 * @return Reverse iterator pointing to the reverse beginning of the tree hierarchy.
+	 */
+	reverse_iterator rbegin() noexcept
+	{
+		return reverse_iterator(this->end());
+	}
+
+	/**
+	 * @brief Get reverse iterator pointing to the reverse end of the tree hierarchy.
+	 * @return Reverse iterator pointing to the reverse end of the tree hierarchy.
+	 */
+	reverse_iterator rend() noexcept
+	{
+		return reverse_iterator(this->begin());
+	}
+
+	/**
+	 * @brief Insert new tree node before given iterator.
+	 * Insertion happens on the current tree level.
+	 * This operation invalidates all obtained iterators.
+	 * The given iterator must not be an end iterator, to insert at the very end of the root level use push_back().
+	 * @param i - iterator pointing to the tree node to insert the new node before.
+	 * @param t - tree to insert.
+	 * @return iterator pointing to the newly inserted tree node.
+	 */
+	iterator insert(iterator i, tree_type t)
+	{
+		ASSERT(i.owner == this)
+		ASSERT(i.node < this->size())
+		this->insert_nodes(i.node, flat_tree(std::move(t)), this->node_links[i.node].parent);
+		return i;
+	}
+
+	/**
+	 * @brief Insert new tree node after given iterator.
+	 * Insertion happens on the current tree level.
+	 * This operation invalidates all obtained iterators.
+	 * The result of this operation is undefined if performed on an end iterator.
+	 * @param i - iterator pointing to the tree node to insert the new node after.
+	 * @param t - tree to insert.
+	 * @return iterator pointing to the newly inserted tree node.
+	 */
+	iterator insert_after(iterator i, tree_type t)
+	{
+		ASSERT(i.owner == this)
+		ASSERT(i.node < this->size())
+		const auto& l = this->node_links[i.node];
+		auto pos = i.node + l.subtree_size;
+		this->insert_nodes(pos, flat_tree(std::move(t)), l.parent);
+		return iterator(*this, pos);
+	}
+
+	/**
+	 * @brief Append new tree to the end of the root level.
+	 * This operation invalidates all obtained iterators.
+	 * @param t - tree to append.
+	 * @return iterator pointing to the newly appended tree root node.
+	 */
+	iterator push_back(tree_type t)
+	{
+		auto pos = this->size();
+		this->insert_nodes(pos, flat_tree(std::move(t)), no_parent);
+		return iterator(*this, pos);
+	}
+
+	/**
+	 * @brief Erase tree node pointed by given iterator.
+	 * The whole subtree of the tree node is erased.
+	 * This operation invalidates all obtained iterators.
+	 * @param i - iterator pointing to the tree node to remove.
+	 * @return iterator pointing to the next tree node in traversal order after the removed one.
+	 */
+	iterator erase(iterator i)
+	{
+		ASSERT(i.owner == this)
+		this->erase_nodes(i.node);
+		return i;
+	}
+};
+
+} // namespace utki
@@ -30,8 +30,13 @@ SOFTWARE.
 
 #include <cmath>
 
+#include "config.hpp"
 #include "utility.hpp"
 
+#if CFG_CPP >= 20
+#	include <bit>
+#endif
+
 namespace utki {
 
 /**
@@ -142,4 +147,65 @@ constexpr number_type pow6(number_type x) noexcept
 	return pow2(pow3(x));
 }
 
+/**
+ * @brief Count consecutive zero bits, starting from the least significant bit.
+ * Drop-in replacement for std::countr_zero() from C++20.
+ * C++17 compatible.
+ * @param x - unsigned integer value.
+ * @return number of consecutive zero bits, starting from the least significant bit.
+ */
+template <typename unsigned_type>
+constexpr int countr_zero(unsigned_type x) noexcept
+{
+	static_assert(std::is_unsigned_v<unsigned_type>, "countr_zero() argument must be unsigned");
+
+#if CFG_CPP >= 20
+	return std::countr_zero(x);
+#else
+	if (x == 0) {
+		return std::numeric_limits<unsigned_type>::digits;
+	}
+#	if CFG_COMPILER == CFG_COMPILER_GCC || CFG_COMPILER == CFG_COMPILER_CLANG
+	return __builtin_ctzll(x);
+#	else
+	int ret = 0;
+	for (; (x & 1) == 0; x >>= 1) {
+		++ret;
+	}
+	return ret;
+#	endif
+#endif
+}
+
+/**
+ * @brief Count one bits.
+ * Drop-in replacement for std::popcount() from C++20.
+ * C++17 compatible.
+ * @param x - unsigned integer value.
+ * @return number of one bits in the value.
+ */
+template <typename unsigned_type>
+constexpr int popcount(unsigned_type x) noexcept
+{
+	static_assert(std::is_unsigned_v<unsigned_type>, "popcount() argument must be unsigned");
+
+#if CFG_CPP >= 20
+	return std::popcount(x);
+#else
+#	if CFG_COMPILER == CFG_COMPILER_GCC || CFG_COMPILER == CFG_COMPILER_CLANG
+	if constexpr (sizeof(x) <= sizeof(unsigned)) {
+		return __builtin_popcount(x);
+	} else {
+		return __builtin_popcountll(x);
+	}
+#	else
+	int ret = 0;
+	for (; x != 0; x &= x - 1) {
+		++ret;
+	}
+	return ret;
+#	endif
+#endif
+}
+
 } // namespace utki
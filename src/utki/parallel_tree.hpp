@@ -0,0 +1,407 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+// NOTE: the functions of this header use std::thread, so on some platforms the program
+//       has to be linked with the threads library, e.g. -pthread or Threads::Threads in CMake.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "debug.hpp"
+#include "span.hpp"
+#include "tree.hpp"
+
+namespace utki {
+
+namespace parallel_tree_internal {
+
+// maximal number of splitting rounds, limits the splitting work for degenerate (e.g. very deep and narrow) trees
+constexpr const unsigned max_split_rounds = 64;
+
+// number of tasks to split the tree into per thread, so that threads which finish early can take more tasks
+constexpr const size_t tasks_per_thread = 4;
+
+// range of sibling subtrees
+template <class list_type>
+struct subtree_range {
+	list_type* list;
+	size_t begin;
+	size_t end;
+
+	// index of the buffer to store results of the range subtrees to, used by parallel_reduce_subtrees()
+	size_t buffer;
+};
+
+// count nodes in the range of subtrees, stops counting when the limit is reached
+template <class list_type>
+size_t count_nodes(const subtree_range<list_type>& range, size_t limit)
+{
+	struct frame {
+		const list_type* list;
+		size_t begin;
+		size_t end;
+	};
+
+	std::vector<frame> stack;
+	stack.push_back(frame{range.list, range.begin, range.end});
+
+	size_t num = 0;
+	while (!stack.empty()) {
+		auto& f = stack.back();
+		if (f.begin == f.end) {
+			stack.pop_back();
+			continue;
+		}
+
+		const auto& node = (*f.list)[f.begin];
+		++f.begin;
+
+		++num;
+		if (num >= limit) {
+			break;
+		}
+
+		if (!node.children.empty()) {
+			// NOTE: push_back() invalidates the 'f' reference
+			stack.push_back(frame{&node.children, 0, node.children.size()});
+		}
+	}
+	return num;
+}
+
+// Split the tree into ranges of subtrees.
+// Ranges having at least min_subtree_size nodes are split in halves, single subtrees are split into
+// their root node and the range of its children. For each split off root node the split_node function
+// is called, it returns buffer index for the children range.
+// Returns the ranges, possibly big ones go first.
+template <class list_type, class split_node_function_type>
+std::vector<subtree_range<list_type>> split(
+	list_type& roots,
+	size_t num_tasks,
+	size_t min_subtree_size,
+	split_node_function_type split_node
+)
+{
+	std::vector<subtree_range<list_type>> small_ranges;
+	std::vector<subtree_range<list_type>> big_ranges;
+	big_ranges.push_back(subtree_range<list_type>{&roots, 0, roots.size(), 0});
+
+	for (unsigned round = 0; round != max_split_rounds; ++round) {
+		if (big_ranges.empty() || small_ranges.size() + big_ranges.size() >= num_tasks) {
+			break;
+		}
+
+		std::vector<subtree_range<list_type>> next;
+		for (const auto& r : big_ranges) {
+			if (r.begin == r.end) {
+				continue;
+			}
+
+			if (count_nodes(r, min_subtree_size) < min_subtree_size) {
+				small_ranges.push_back(r);
+				continue;
+			}
+
+			if (r.end - r.begin > 1) {
+				auto middle = r.begin + (r.end - r.begin) / 2;
+				next.push_back(subtree_range<list_type>{r.list, r.begin, middle, r.buffer});
+				next.push_back(subtree_range<list_type>{r.list, middle, r.end, r.buffer});
+				continue;
+			}
+
+			auto& node = (*r.list)[r.begin];
+			auto buffer = split_node(node, r);
+			next.push_back(subtree_range<list_type>{&node.children, 0, node.children.size(), buffer});
+		}
+		big_ranges = std::move(next);
+	}
+
+	big_ranges.erase(
+		std::remove_if(
+			big_ranges.begin(),
+			big_ranges.end(),
+			[](const auto& r) {
+				return r.begin == r.end;
+			}
+		),
+		big_ranges.end()
+	);
+
+	big_ranges.insert(big_ranges.end(), small_ranges.begin(), small_ranges.end());
+	return big_ranges;
+}
+
+// Run tasks on the given number of threads, the calling thread is one of them.
+// The make_worker function is called once per thread to create the task processing function for that thread.
+// The first exception thrown by a task is rethrown in the calling thread after all threads have finished.
+template <class worker_factory_type>
+void run(size_t num_tasks, size_t num_threads, worker_factory_type make_worker)
+{
+	std::atomic<size_t> next_task{0};
+	std::atomic<bool> failed{false};
+
+	std::mutex error_mutex;
+	std::exception_ptr error;
+
+	auto work = [&]() {
+		try {
+			auto process = make_worker();
+			while (!failed.load(std::memory_order_relaxed)) {
+				auto i = next_task.fetch_add(1, std::memory_order_relaxed);
+				if (i >= num_tasks) {
+					break;
+				}
+				process(i);
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+			failed.store(true, std::memory_order_relaxed);
+		}
+	};
+
+	num_threads = std::min(num_threads, num_tasks);
+
+	std::vector<std::thread> threads;
+	if (num_threads > 1) {
+		threads.reserve(num_threads - 1);
+		try {
+			for (size_t i = 1; i != num_threads; ++i) {
+				threads.emplace_back(work);
+			}
+		} catch (...) {
+			failed.store(true, std::memory_order_relaxed);
+			for (auto& t : threads) {
+				t.join();
+			}
+			throw;
+		}
+	}
+
+	work();
+
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace parallel_tree_internal
+
+/**
+ * @brief Call a function for each tree node in parallel.
+ * The tree is split into subtrees which are processed by several threads. Subtrees having less
+ * than min_subtree_size nodes are not split further and are processed by one thread, so that small
+ * subtrees do not produce more tasks than is worth it.
+ * The order in which the tree nodes are processed is unspecified and the function is called
+ * concurrently from different threads, so it must be thread-safe.
+ * The threads are started when this function is called and are joined before it returns.
+ * @param roots - list of trees to process.
+ * @param func - function to call for each tree node. Called as func(node), where node is a reference to the tree node.
+ * @param num_threads - number of threads to use, including the calling thread. Values less than 1 are treated as 1,
+ *                      e.g. when std::thread::hardware_concurrency() returns 0 because it cannot detect
+ *                      the number of hardware threads, the processing is done by the calling thread only.
+ * @param min_subtree_size - number of nodes below which a subtree is not split into separate tasks.
+ * @throw any exception thrown by func. In case func throws, the remaining tree nodes may be left unprocessed.
+ */
+template <class collection_type, class function_type>
+void parallel_for_each_node(
+	collection_type& roots,
+	function_type func,
+	size_t num_threads = std::thread::hardware_concurrency(),
+	size_t min_subtree_size = 1024
+)
+{
+	using namespace parallel_tree_internal;
+
+	num_threads = std::max(num_threads, size_t(1));
+	min_subtree_size = std::max(min_subtree_size, size_t(1));
+
+	auto tasks = split(
+		roots,
+		num_threads == 1 ? 1 : num_threads * tasks_per_thread,
+		min_subtree_size,
+		[&](auto& node, const auto&) {
+			func(node);
+			return size_t(0);
+		}
+	);
+
+	run(tasks.size(), num_threads, [&]() {
+		using node_type = std::remove_reference_t<decltype(roots[0])>;
+
+		return [&, stack = std::vector<node_type*>()](size_t i) mutable {
+			const auto& r = tasks[i];
+			for (size_t j = r.begin; j != r.end; ++j) {
+				stack.push_back(&(*r.list)[j]);
+				while (!stack.empty()) {
+					auto node = stack.back();
+					stack.pop_back();
+					func(*node);
+					for (auto& c : node->children) {
+						stack.push_back(&c);
+					}
+				}
+			}
+		};
+	});
+}
+
+/**
+ * @brief Reduce the tree bottom-up in parallel.
+ * For each tree node the function is called with the results of the function calls for the node's children,
+ * i.e. children are always processed before their parent node.
+ * The tree is split into subtrees which are processed by several threads. Subtrees having less
+ * than min_subtree_size nodes are not split further and are processed by one thread, so that small
+ * subtrees do not produce more tasks than is worth it. The root nodes of split subtrees are processed
+ * by the calling thread after all the threads are finished.
+ * The function is called concurrently from different threads, so it must be thread-safe.
+ * The threads are started when this function is called and are joined before it returns.
+ * @tparam result_type - type of the reduction result, must be default constructible. Must not be bool, because
+ *                       results are passed as utki::span and stored to std::vector elements concurrently
+ *                       from different threads, which std::vector<bool> does not support.
+ *                       Use a wrapper type, e.g. a struct with a bool member, or uint8_t instead.
+ * @param roots - list of trees to process.
+ * @param func - reduction function. Called as func(node, children_results), where node is a reference to the tree
+ *               node and children_results is a utki::span<result_type> of the results for the node's children,
+ *               in the order of the children. Returns result for the node's subtree.
+ * @param num_threads - number of threads to use, including the calling thread. Values less than 1 are treated as 1,
+ *                      e.g. when std::thread::hardware_concurrency() returns 0 because it cannot detect
+ *                      the number of hardware threads, the processing is done by the calling thread only.
+ * @param min_subtree_size - number of nodes below which a subtree is not split into separate tasks.
+ * @return Results for each of the root trees.
+ * @throw any exception thrown by func.
+ */
+template <class result_type, class collection_type, class function_type>
+std::vector<result_type> parallel_reduce_subtrees(
+	collection_type& roots,
+	function_type func,
+	size_t num_threads = std::thread::hardware_concurrency(),
+	size_t min_subtree_size = 1024
+)
+{
+	static_assert(
+		!std::is_same_v<result_type, bool>,
+		"result_type must not be bool, std::vector<bool> is not suitable for storing the results"
+	);
+
+	using namespace parallel_tree_internal;
+
+	num_threads = std::max(num_threads, size_t(1));
+	min_subtree_size = std::max(min_subtree_size, size_t(1));
+
+	using node_type = std::remove_reference_t<decltype(roots[0])>;
+
+	// results of children lists of split off nodes, buffer 0 is for the roots
+	std::vector<std::vector<result_type>> buffers;
+	buffers.emplace_back(roots.size());
+
+	struct split_node {
+		node_type* node;
+		size_t buffer;
+		size_t index;
+		size_t children_buffer;
+	};
+
+	std::vector<split_node> split_nodes;
+
+	auto tasks = split(
+		roots,
+		num_threads == 1 ? 1 : num_threads * tasks_per_thread,
+		min_subtree_size,
+		[&](auto& node, const auto& range) {
+			ASSERT(range.end - range.begin == 1)
+			buffers.emplace_back(node.children.size());
+			split_nodes.push_back(split_node{&node, range.buffer, range.begin, buffers.size() - 1});
+			return buffers.size() - 1;
+		}
+	);
+
+	run(tasks.size(), num_threads, [&]() {
+		struct frame {
+			node_type* node;
+			size_t child;
+		};
+
+		return [&, stack = std::vector<frame>(), results = std::vector<result_type>()](size_t i) mutable {
+			const auto& r = tasks[i];
+			auto& out = buffers[r.buffer];
+
+			for (size_t j = r.begin; j != r.end; ++j) {
+				stack.push_back(frame{&(*r.list)[j], 0});
+				while (!stack.empty()) {
+					auto& f = stack.back();
+					if (f.child != f.node->children.size()) {
+						auto child = &f.node->children[f.child];
+						++f.child;
+						// NOTE: push_back() invalidates the 'f' reference
+						stack.push_back(frame{child, 0});
+						continue;
+					}
+
+					auto num_children = f.node->children.size();
+					ASSERT(results.size() >= num_children)
+					auto children_offset = results.size() - num_children;
+
+					auto res = func(*f.node, utki::make_span(results).subspan(children_offset));
+
+					results.erase(std::next(results.begin(), children_offset), results.end());
+					stack.pop_back();
+
+					if (stack.empty()) {
+						out[j] = std::move(res);
+					} else {
+						results.push_back(std::move(res));
+					}
+				}
+			}
+		};
+	});
+
+	// split off nodes are recorded parents before children, so process them in reverse order
+	for (auto i = split_nodes.rbegin(); i != split_nodes.rend(); ++i) {
+		buffers[i->buffer][i->index] = func(*i->node, utki::make_span(buffers[i->children_buffer]));
+	}
+
+	return std::move(buffers.front());
+}
+
+} // namespace utki
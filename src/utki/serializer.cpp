@@ -0,0 +1,72 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#include "serializer.hpp"
+
+#include "string.hpp"
+
+using namespace utki;
+
+serializer::serializer(size_t capacity) :
+	storage(capacity),
+	growable(true),
+	buffer(this->storage)
+{}
+
+void serializer::grow(size_t size)
+{
+	auto required_capacity = this->num_written + size;
+
+	if (!this->growable) {
+		throw std::invalid_argument(utki::cat(
+			"serializer: fixed size buffer is too small, required ",
+			required_capacity,
+			" bytes, buffer size is only ",
+			this->buffer.size()
+		));
+	}
+
+	// grow geometrically to have amortized constant time writes
+	this->storage.resize(std::max(required_capacity, this->storage.size() * 2));
+	this->buffer = this->storage;
+}
+
+std::vector<uint8_t> serializer::release()
+{
+	std::vector<uint8_t> ret;
+	if (this->growable) {
+		this->storage.resize(this->num_written);
+		ret = std::move(this->storage);
+		this->storage.clear();
+		this->buffer = this->storage;
+	} else {
+		ret.assign(this->data().begin(), this->data().end());
+	}
+	this->num_written = 0;
+	return ret;
+}
@@ -0,0 +1,313 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "span.hpp"
+#include "struct_layout.hpp"
+#include "utility.hpp"
+
+namespace utki {
+
+/**
+ * @brief Serializer of binary data.
+ * Writes values to a memory buffer. The buffer is either a growable one owned by the serializer,
+ * or a fixed size one provided by the user.
+ * Each write operation does a single buffer capacity check, so writing several values with one call,
+ * e.g. using write_le() or write_be(), does one check for the whole batch.
+ */
+class serializer
+{
+	std::vector<uint8_t> storage;
+
+	bool growable;
+
+	// in case of growable buffer it refers to the storage
+	utki::span<uint8_t> buffer;
+
+	size_t num_written = 0;
+
+	void grow(size_t size);
+
+	uint8_t* allocate(size_t size)
+	{
+		if (this->buffer.size() - this->num_written < size) {
+			this->grow(size);
+		}
+		ASSERT(this->buffer.size() - this->num_written >= size)
+
+		auto ret = this->buffer.subspan(this->num_written, size).data();
+		this->num_written += size;
+		return ret;
+	}
+
+public:
+	/**
+	 * @brief Construct serializer writing to a growable buffer.
+	 * @param capacity - initial buffer capacity, in bytes.
+	 */
+	explicit serializer(size_t capacity = 0);
+
+	/**
+	 * @brief Construct serializer writing to a fixed size buffer.
+	 * @param buffer - buffer to write to.
+	 */
+	explicit serializer(utki::span<uint8_t> buffer) noexcept :
+		growable(false),
+		buffer(buffer)
+	{}
+
+	serializer(const serializer&) = delete;
+	serializer& operator=(const serializer&) = delete;
+
+	serializer(serializer&&) = delete;
+	serializer& operator=(serializer&&) = delete;
+
+	~serializer() = default;
+
+	bool empty() const noexcept
+	{
+		return this->num_written == 0;
+	}
+
+	/**
+	 * @brief Get number of bytes written.
+	 * @return Number of bytes written.
+	 */
+	size_t size() const noexcept
+	{
+		return this->num_written;
+	}
+
+	/**
+	 * @brief Get buffer capacity.
+	 * @return Total number of bytes which can be written without growing the buffer.
+	 */
+	size_t capacity() const noexcept
+	{
+		return this->buffer.size();
+	}
+
+	/**
+	 * @brief Reserve buffer capacity.
+	 * Makes sure that given total number of bytes can be written without further buffer reallocations.
+	 * @param capacity - capacity to reserve, in bytes.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and is smaller than requested capacity.
+	 */
+	void reserve(size_t capacity)
+	{
+		if (capacity > this->buffer.size()) {
+			this->grow(capacity - this->num_written);
+		}
+	}
+
+	/**
+	 * @brief Get written data.
+	 * @return Span of the written bytes.
+	 */
+	utki::span<const uint8_t> data() const noexcept
+	{
+		return this->buffer.subspan(0, this->num_written);
+	}
+
+	/**
+	 * @brief Get written data and reset the serializer.
+	 * In case of growable buffer the buffer is moved out to the returned vector,
+	 * in case of fixed size buffer the written bytes are copied to the returned vector.
+	 * @return Vector of written bytes.
+	 */
+	std::vector<uint8_t> release();
+
+	/**
+	 * @brief Write unsigned integral values, little-endian.
+	 * @param values - values to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename... unsigned_type>
+	void write_le(unsigned_type... values)
+	{
+		[[maybe_unused]] auto p = this->allocate((size_t(0) + ... + sizeof(values)));
+		((p = utki::serialize_le(values, p)), ...);
+	}
+
+	/**
+	 * @brief Write unsigned integral values, big-endian.
+	 * @param values - values to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename... unsigned_type>
+	void write_be(unsigned_type... values)
+	{
+		[[maybe_unused]] auto p = this->allocate((size_t(0) + ... + sizeof(values)));
+		((p = utki::serialize_be(values, p)), ...);
+	}
+
+	/**
+	 * @brief Write struct.
+	 * Writes all fields of the struct with a single buffer capacity check.
+	 * @tparam layout_type - binary layout of the struct, see struct_layout.
+	 * @param obj - struct to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename layout_type>
+	void write_struct(const typename layout_type::object_type& obj)
+	{
+		layout_type::write(obj, this->allocate(layout_type::size));
+	}
+
+	/**
+	 * @brief Write unsigned integral value, LEB128 variable length encoding.
+	 * @param value - value to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename unsigned_type>
+	void write_varuint(unsigned_type value)
+	{
+		utki::serialize_varuint(value, this->allocate(utki::varuint_size(value)));
+	}
+
+	/**
+	 * @brief Write signed integral value, zigzag LEB128 variable length encoding.
+	 * @param value - value to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename signed_type>
+	void write_varint(signed_type value)
+	{
+		this->write_varuint(utki::zigzag_encode(value));
+	}
+
+	/**
+	 * @brief Write array of unsigned integral values, LEB128 variable length encoding.
+	 * @param values - values to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename unsigned_type>
+	void write_varuint_array(utki::span<unsigned_type> values)
+	{
+		size_t size = 0;
+		for (auto v : values) {
+			size += utki::varuint_size(v);
+		}
+
+		auto p = this->allocate(size);
+		for (auto v : values) {
+			p = utki::serialize_varuint(v, p);
+		}
+	}
+
+	/**
+	 * @brief Write array of signed integral values, zigzag LEB128 variable length encoding.
+	 * @param values - values to write.
+	 * @throw std::invalid_argument - in case the buffer is of fixed size and there is not enough space left.
+	 */
+	template <typename signed_type>
+	void write_varint_array(utki::span<signed_type> values)
+	{
+		size_t size = 0;
+		for (auto v : values) {
+			size += utki::varuint_size(utki::zigzag_encode(v));
+		}
+
+		auto p = this->allocate(size);
+		for (auto v : values) {
+			p = utki::serialize_varint(v, p);
+		}
+	}
+
+	void write_string(std::string_view str)
+	{
+		this->write_span(utki::to_uint8_t(utki::make_span(str)));
+	}
+
+	void write_span(utki::span<const uint8_t> data)
+	{
+		std::copy(data.begin(), data.end(), this->allocate(data.size()));
+	}
+
+	void write_uint8(uint8_t value)
+	{
+		*this->allocate(sizeof(value)) = value;
+	}
+
+	void write_uint16_le(uint16_t value)
+	{
+		this->write_le(value);
+	}
+
+	void write_uint32_le(uint32_t value)
+	{
+		this->write_le(value);
+	}
+
+	void write_uint64_le(uint64_t value)
+	{
+		this->write_le(value);
+	}
+
+	void write_float_le(float value)
+	{
+		utki::serialize_float_le(value, this->allocate(sizeof(value)));
+	}
+
+	void write_double_le(double value)
+	{
+		utki::serialize_double_le(value, this->allocate(sizeof(value)));
+	}
+
+	void write_uint16_be(uint16_t value)
+	{
+		this->write_be(value);
+	}
+
+	void write_uint32_be(uint32_t value)
+	{
+		this->write_be(value);
+	}
+
+	void write_uint64_be(uint64_t value)
+	{
+		this->write_be(value);
+	}
+
+	void write_float_be(float value)
+	{
+		utki::serialize_float_be(value, this->allocate(sizeof(value)));
+	}
+
+	void write_double_be(double value)
+	{
+		utki::serialize_double_be(value, this->allocate(sizeof(value)));
+	}
+};
+
+} // namespace utki
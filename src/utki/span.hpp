@@ -198,18 +198,29 @@ public:
 #	if CFG_CPP < 20
 		,
 		typename std::enable_if_t< //
-			std::is_same_v<other_element_type, char> || //
-				std::is_same_v<other_element_type, wchar_t> || //
-				std::is_same_v<other_element_type, char16_t> || //
-				std::is_same_v<other_element_type, char32_t>,
+			(std::is_same_v<other_element_type, char> || //
+			 std::is_same_v<other_element_type, wchar_t> || //
+			 std::is_same_v<other_element_type, char16_t> || //
+			 std::is_same_v<other_element_type, char32_t>) &&
+				std::is_convertible_v< //
+					// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+					other_element_type (*)[], // NOLINT(modernize-avoid-c-arrays)
+					// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+					element_type (*)[]>, // NOLINT(modernize-avoid-c-arrays)
 			bool> = true
 #	endif
 		>
 #	if CFG_CPP >= 20
-	requires std::same_as<other_element_type, char> || //
-		std::same_as<other_element_type, wchar_t> || //
-		std::same_as<other_element_type, char16_t> || //
-		std::same_as<other_element_type, char32_t>
+	requires(std::same_as<other_element_type, char> || //
+			 std::same_as<other_element_type, wchar_t> || //
+			 std::same_as<other_element_type, char16_t> || //
+			 std::same_as<other_element_type, char32_t>) &&
+		std::convertible_to<
+			// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+			other_element_type (*)[], // NOLINT(modernize-avoid-c-arrays)
+			// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+			element_type (*)[] // NOLINT(modernize-avoid-c-arrays)
+			>
 #	endif
 	span(std::basic_string<other_element_type>& v) :
 		span(v.data(), v.size())
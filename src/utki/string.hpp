@@ -30,7 +30,10 @@ SOFTWARE.
 
 #include <array>
 #include <charconv>
+#include <limits>
 #include <locale>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -144,6 +147,351 @@ inline std::string make_string(const std::vector<uint8_t>& buf)
 	return utki::make_string(utki::make_span(buf));
 }
 
+/**
+ * @brief Find first occurrence of a character.
+ * The search is vectorized with SIMD instructions in case the CPU supports those.
+ * @param str - string to search in.
+ * @param c - character to search for.
+ * @return position of the first occurrence of the character.
+ * @return std::string_view::npos if the character was not found.
+ */
+size_t find_char(std::string_view str, char c) noexcept;
+
+/**
+ * @brief Find first occurrence of any of the given characters.
+ * The search is vectorized with SIMD instructions in case the CPU supports those
+ * and the set of characters is small.
+ * @param str - string to search in.
+ * @param chars - set of characters to search for.
+ * @return position of the first occurrence of any of the characters.
+ * @return std::string_view::npos if none of the characters was found.
+ */
+size_t find_any_of(std::string_view str, utki::span<const char> chars) noexcept;
+
+/**
+ * @brief Find first whitespace character.
+ * Whitespace characters are same as for string_parser::is_space().
+ * The search is vectorized with SIMD instructions in case the CPU supports those.
+ * @param str - string to search in.
+ * @return position of the first whitespace character.
+ * @return std::string_view::npos if there are no whitespace characters in the string.
+ */
+size_t find_space(std::string_view str) noexcept;
+
+/**
+ * @brief Find first whitespace character or given character.
+ * Whitespace characters are same as for string_parser::is_space().
+ * The search is vectorized with SIMD instructions in case the CPU supports those.
+ * @param str - string to search in.
+ * @param c - character to search for, in addition to whitespaces.
+ * @return position of the first whitespace character or the given character, whichever comes first.
+ * @return std::string_view::npos if none was found.
+ */
+size_t find_space_or(std::string_view str, char c) noexcept;
+
+/**
+ * @brief Find first non-whitespace character.
+ * Whitespace characters are same as for string_parser::is_space().
+ * The search is vectorized with SIMD instructions in case the CPU supports those.
+ * @param str - string to search in.
+ * @return position of the first non-whitespace character.
+ * @return std::string_view::npos if the string consists only of whitespaces.
+ */
+size_t find_non_space(std::string_view str) noexcept;
+
+/**
+ * @brief Lazy range of split string tokens.
+ * The range does not allocate any memory, each token is a string view pointing into the original string.
+ * So, the original string must remain alive while the range and its tokens are in use.
+ *
+ * The range can split the string in two modes:
+ * - by delimiter character. Same as split(str, delimiter), empty tokens are preserved, so
+ *   the range always has at least one token.
+ * - by whitespaces. Same as split(str), delimiter is any sequence of whitespaces,
+ *   empty tokens are not produced.
+ *
+ * Example:
+ * @code
+ * for (std::string_view token : utki::split_view("a,b,c"sv, ',')) {
+ *     std::cout << token << std::endl;
+ * }
+ * @endcode
+ *
+ * @tparam element_type - string element type.
+ */
+template <typename element_type>
+class split_view
+{
+	using string_view_type = std::basic_string_view<element_type>;
+
+	string_view_type str;
+	element_type delimiter;
+	bool by_whitespaces;
+
+	// same as string_parser::is_space(), but for any character type
+	static bool is_space(element_type c) noexcept
+	{
+		return //
+			c == element_type(' ') || //
+			c == element_type('\n') || //
+			c == element_type('\t') || //
+			c == element_type('\r') || //
+			c == element_type('\v') || // vertical tab
+			c == element_type('\f'); // form feed
+	}
+
+	// char strings are searched with vectorized utki::find_*() functions
+
+	static size_t find_delimiter(string_view_type s, element_type delimiter) noexcept
+	{
+		if constexpr (std::is_same_v<element_type, char>) {
+			return utki::find_char(s, delimiter);
+		} else {
+			return s.find(delimiter);
+		}
+	}
+
+	static size_t find_space(string_view_type s) noexcept
+	{
+		if constexpr (std::is_same_v<element_type, char>) {
+			return utki::find_space(s);
+		} else {
+			auto i = std::find_if(s.begin(), s.end(), &split_view::is_space);
+			return i == s.end() ? string_view_type::npos : size_t(std::distance(s.begin(), i));
+		}
+	}
+
+	static size_t find_non_space(string_view_type s) noexcept
+	{
+		if constexpr (std::is_same_v<element_type, char>) {
+			return utki::find_non_space(s);
+		} else {
+			auto i = std::find_if_not(s.begin(), s.end(), &split_view::is_space);
+			return i == s.end() ? string_view_type::npos : size_t(std::distance(s.begin(), i));
+		}
+	}
+
+public:
+	/**
+	 * @brief Create a range of tokens separated by the given delimiter.
+	 * @param str - string to split.
+	 * @param delimiter - delimiter character to use as a splitter.
+	 */
+	split_view(
+		string_view_type str, //
+		element_type delimiter
+	) :
+		str(str),
+		delimiter(delimiter),
+		by_whitespaces(false)
+	{}
+
+	/**
+	 * @brief Create a range of words.
+	 * Delimiter for splitting is any sequence of whitespaces.
+	 * Whitespace includes space, tab, new line characters.
+	 * @param str - string to split to words.
+	 */
+	split_view(string_view_type str) :
+		str(str),
+		delimiter(0),
+		by_whitespaces(true)
+	{}
+
+	/**
+	 * @brief Iterator over the string tokens.
+	 */
+	class iterator
+	{
+		friend class split_view;
+
+		const split_view* owner = nullptr;
+
+		string_view_type token;
+
+		// position in the owner's string to start looking for the next token from,
+		// npos if current token is the last one
+		size_t next_pos = 0;
+
+		bool is_end = true;
+
+		iterator(const split_view& owner) :
+			owner(&owner),
+			is_end(false)
+		{
+			this->find_token(0);
+		}
+
+		void find_token(size_t pos) noexcept
+		{
+			ASSERT(this->owner)
+			const auto& s = this->owner->str;
+
+			if (pos == string_view_type::npos) {
+				this->is_end = true;
+				return;
+			}
+
+			auto rest = s.substr(pos);
+
+			if (!this->owner->by_whitespaces) {
+				auto dpos = split_view::find_delimiter(rest, this->owner->delimiter);
+				if (dpos == string_view_type::npos) {
+					this->token = rest;
+					this->next_pos = string_view_type::npos;
+				} else {
+					this->token = rest.substr(0, dpos);
+					this->next_pos = pos + dpos + 1;
+				}
+				return;
+			}
+
+			auto word_begin = split_view::find_non_space(rest);
+			if (word_begin == string_view_type::npos) {
+				this->is_end = true;
+				return;
+			}
+			rest = rest.substr(word_begin);
+
+			auto word_length = split_view::find_space(rest);
+			if (word_length == string_view_type::npos) {
+				this->token = rest;
+				this->next_pos = s.size();
+			} else {
+				this->token = rest.substr(0, word_length);
+				this->next_pos = pos + word_begin + word_length;
+			}
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = string_view_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type*;
+		using reference = const value_type&;
+
+		/**
+		 * @brief Create end iterator.
+		 */
+		iterator() = default;
+
+		reference operator*() const noexcept
+		{
+			ASSERT(!this->is_end)
+			return this->token;
+		}
+
+		pointer operator->() const noexcept
+		{
+			ASSERT(!this->is_end)
+			return &this->token;
+		}
+
+		iterator& operator++() noexcept
+		{
+			ASSERT(!this->is_end)
+			this->find_token(this->next_pos);
+			return *this;
+		}
+
+		iterator operator++(int) noexcept
+		{
+			auto ret = *this;
+			this->operator++();
+			return ret;
+		}
+
+		bool operator==(const iterator& i) const noexcept
+		{
+			if (this->is_end || i.is_end) {
+				return this->is_end == i.is_end;
+			}
+			// every token starts at unique position within the string
+			return this->token.data() == i.token.data();
+		}
+
+		bool operator!=(const iterator& i) const noexcept
+		{
+			return !this->operator==(i);
+		}
+	};
+
+	iterator begin() const
+	{
+		return iterator(*this);
+	}
+
+	iterator end() const
+	{
+		return iterator();
+	}
+};
+
+template <typename element_type>
+split_view(const element_type*, element_type) -> split_view<element_type>;
+
+template <typename element_type>
+split_view(const std::basic_string<element_type>&, element_type) -> split_view<element_type>;
+
+template <typename element_type>
+split_view(const element_type*) -> split_view<element_type>;
+
+template <typename element_type>
+split_view(const std::basic_string<element_type>&) -> split_view<element_type>;
+
+/**
+ * @brief Split string view using given delimiter into caller-provided buffer.
+ * No memory allocation is done, resulting tokens are string views pointing into the original string.
+ * In case the buffer is too small to hold all the tokens, only the tokens which fit into the buffer are stored,
+ * the returned number of tokens still accounts for all the tokens. So, the caller can detect that the buffer
+ * was too small by comparing the returned value with the buffer size.
+ * @param str - string view to split.
+ * @param delimiter - delimiter character to use as a splitter.
+ * @param out - buffer to store the tokens to.
+ * @return total number of tokens in the string.
+ */
+template <typename element_type>
+size_t split_into(
+	std::basic_string_view<element_type> str, //
+	element_type delimiter,
+	utki::span<std::basic_string_view<element_type>> out
+)
+{
+	size_t num_tokens = 0;
+	for (auto token : split_view(str, delimiter)) {
+		if (num_tokens < out.size()) {
+			out[num_tokens] = token;
+		}
+		++num_tokens;
+	}
+	return num_tokens;
+}
+
+/**
+ * @brief Split string to separate words into caller-provided buffer.
+ * Delimiter for splitting is any sequence of whitespaces.
+ * No memory allocation is done, resulting words are string views pointing into the original string.
+ * In case the buffer is too small to hold all the words, only the words which fit into the buffer are stored,
+ * the returned number of words still accounts for all the words.
+ * @param str - string to split to words.
+ * @param out - buffer to store the words to.
+ * @return total number of words in the string.
+ */
+inline size_t split_into(
+	std::string_view str, //
+	utki::span<std::string_view> out
+)
+{
+	size_t num_tokens = 0;
+	for (auto token : split_view(str)) {
+		if (num_tokens < out.size()) {
+			out[num_tokens] = token;
+		}
+		++num_tokens;
+	}
+	return num_tokens;
+}
+
 /**
  * @brief Split string view using given delimiter.
  * @param str - string view to split.
@@ -157,25 +505,9 @@ std::vector<std::basic_string<element_type>> split(
 )
 {
 	std::vector<std::basic_string<element_type>> ret;
-	size_t pos = 0;
-
-	for (;;) {
-		auto dpos = str.find(delimiter, pos);
 
-		if (dpos == std::string::npos) {
-			ret.emplace_back(str.substr(
-				pos, //
-				str.size() - pos
-			));
-			break;
-		}
-
-		ret.emplace_back(str.substr(
-			pos, //
-			dpos - pos
-		));
-
-		pos = dpos + 1;
+	for (auto token : split_view(str, delimiter)) {
+		ret.emplace_back(token);
 	}
 
 	return ret;
@@ -223,6 +555,221 @@ std::vector<std::basic_string<element_type>> split(const element_type* str, elem
  */
 std::vector<std::string> split(std::string_view str);
 
+/**
+ * @brief String builder.
+ * Appends values to a string, numbers are formatted with std::to_chars(),
+ * i.e. the formatting is locale-independent.
+ * Integral numbers are formatted in decimal base, floating point numbers are formatted
+ * same way as std::ostream does it by default, i.e. in general format with precision of 6 digits.
+ * Values of char, signed char and unsigned char types are appended as characters and
+ * bool values are appended as '1' and '0', same as std::ostream does it by default.
+ * Values of other types are formatted via std::ostream, using operator<<().
+ * The string_builder::estimate_size() function allows to reserve memory once
+ * before appending several values.
+ */
+class string_builder
+{
+	std::string buffer;
+
+	// 128 chars is large enough to hold any built-in integral or floating point type
+	constexpr static size_t max_number_size = 128;
+
+	// sign + 6 digits + point + 'e' + exponent sign + 4 exponent digits
+	constexpr static size_t max_floating_point_size = 14;
+
+	template <typename value_type>
+	constexpr static bool is_char_v = std::is_same_v<value_type, char> || //
+		std::is_same_v<value_type, signed char> || //
+		std::is_same_v<value_type, unsigned char>;
+
+	template <typename value_type>
+	constexpr static bool is_integer_v = std::is_integral_v<value_type> && //
+		!std::is_same_v<value_type, bool> && //
+		!is_char_v<value_type> && //
+		!std::is_same_v<value_type, wchar_t> && //
+		!std::is_same_v<value_type, char16_t> && //
+		!std::is_same_v<value_type, char32_t>
+#if CFG_CPP >= 20
+		&& !std::is_same_v<value_type, char8_t>
+#endif
+		;
+
+	template <typename value_type>
+	constexpr static bool is_floating_point_v =
+#if defined(__cpp_lib_to_chars)
+		std::is_floating_point_v<value_type>;
+#else
+		// std::to_chars() for floating point types is not supported by the standard library
+		false;
+#endif
+
+	template <typename value_type>
+	constexpr static bool is_string_v = std::is_same_v<std::decay_t<value_type>, const char*> || //
+		std::is_same_v<std::decay_t<value_type>, char*> || //
+		std::is_same_v<value_type, std::string> || //
+		std::is_same_v<value_type, std::string_view>;
+
+	template <typename value_type>
+	static size_t estimate_value_size(const value_type& value) noexcept
+	{
+		if constexpr (std::is_same_v<value_type, bool> || is_char_v<value_type>) {
+			return 1;
+		} else if constexpr (is_integer_v<value_type>) {
+			return size_t(std::numeric_limits<value_type>::digits10) + 1 + (std::is_signed_v<value_type> ? 1 : 0);
+		} else if constexpr (is_floating_point_v<value_type>) {
+			return max_floating_point_size;
+		} else if constexpr (is_string_v<value_type>) {
+			return std::string_view(value).size();
+		} else {
+			// size is unknown
+			return 0;
+		}
+	}
+
+public:
+	/**
+	 * @brief Check if values of the type are formatted by string_builder without using std::ostream.
+	 * These are built-in integral, floating point, char and bool types, C strings, std::string and
+	 * std::string_view.
+	 * @tparam value_type - type to check.
+	 */
+	template <typename value_type>
+	constexpr static bool is_formatted_natively_v = std::is_same_v<value_type, bool> || //
+		is_char_v<value_type> || //
+		is_integer_v<value_type> || //
+		is_floating_point_v<value_type> || //
+		is_string_v<value_type>;
+
+	string_builder() = default;
+
+	/**
+	 * @brief Estimate length of the string representation of the values.
+	 * For integral, floating point and char values the upper bound of the length is returned.
+	 * For strings the exact length is returned.
+	 * Values of other types are not accounted.
+	 * @param values - values to estimate the length of string representation for.
+	 * @return Estimated length of the string representation of all the values.
+	 */
+	template <typename... value_type>
+	static size_t estimate_size(const value_type&... values) noexcept
+	{
+		return (size_t(0) + ... + estimate_value_size(values));
+	}
+
+	/**
+	 * @brief Reserve memory for the string being built.
+	 * @param size - total string size to reserve memory for.
+	 */
+	void reserve(size_t size)
+	{
+		this->buffer.reserve(size);
+	}
+
+	/**
+	 * @brief Append value to the string.
+	 * @param value - value to append.
+	 * @return Reference to this string builder.
+	 */
+	template <typename value_type>
+	string_builder& append(const value_type& value)
+	{
+		if constexpr (std::is_same_v<value_type, bool>) {
+			this->buffer.push_back(value ? '1' : '0');
+		} else if constexpr (is_char_v<value_type>) {
+			this->buffer.push_back(char(value));
+		} else if constexpr (is_integer_v<value_type> || is_floating_point_v<value_type>) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+			std::array<char, max_number_size> buf;
+
+			auto res = [&]() {
+				if constexpr (is_integer_v<value_type>) {
+					return std::to_chars(buf.data(), utki::end_pointer(buf), value);
+				} else {
+					// same as default std::ostream formatting
+					constexpr int default_precision = 6;
+					return std::to_chars(
+						buf.data(), //
+						utki::end_pointer(buf),
+						value,
+						std::chars_format::general,
+						default_precision
+					);
+				}
+			}();
+
+			ASSERT(res.ec == std::errc())
+			ASSERT(res.ptr <= utki::end_pointer(buf))
+
+			this->buffer.append(buf.data(), res.ptr - buf.data());
+		} else if constexpr (is_string_v<value_type>) {
+			this->buffer.append(std::string_view(value));
+		} else {
+			// NOTE: the stream is not shared between append() calls, so stream manipulators have no effect
+			std::stringstream ss;
+			ss << value;
+			this->buffer.append(ss.str());
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Append value to the string.
+	 * Same as append().
+	 * @param value - value to append.
+	 * @return Reference to this string builder.
+	 */
+	template <typename value_type>
+	string_builder& operator<<(const value_type& value)
+	{
+		return this->append(value);
+	}
+
+	/**
+	 * @brief Get length of the string built so far.
+	 * @return Length of the string.
+	 */
+	size_t size() const noexcept
+	{
+		return this->buffer.size();
+	}
+
+	/**
+	 * @brief Get view of the string built so far.
+	 * @return String view.
+	 */
+	std::string_view view() const noexcept
+	{
+		return this->buffer;
+	}
+
+	/**
+	 * @brief Clear the string.
+	 * The reserved memory is retained, so the string builder can be reused.
+	 */
+	void clear() noexcept
+	{
+		this->buffer.clear();
+	}
+
+	/**
+	 * @brief Get the built string.
+	 * @return Copy of the built string.
+	 */
+	std::string str() const&
+	{
+		return this->buffer;
+	}
+
+	/**
+	 * @brief Get the built string.
+	 * @return The built string moved out of the string builder.
+	 */
+	std::string str() &&
+	{
+		return std::move(this->buffer);
+	}
+};
+
 /**
  * @brief Join strings with delimeter.
  * @tparam strings_collection_type - string collection type, can be e.g. std::vector<std::string> or
@@ -241,19 +788,31 @@ std::basic_string<typename strings_collection_type::value_type::value_type> join
 		return {};
 	}
 
-	std::basic_stringstream<typename strings_collection_type::value_type::value_type> ss;
-	ss << strings.front();
+	size_t size = strings.size() - 1;
+	for (const auto& s : strings) {
+		size += s.size();
+	}
+
+	std::basic_string<typename strings_collection_type::value_type::value_type> ret;
+	ret.reserve(size);
+
+	ret.append(strings.front().begin(), strings.front().end());
 
 	for (const auto& s : utki::skip_front<1>(strings)) {
-		ss << delimeter << s;
+		ret.push_back(delimeter);
+		ret.append(s.begin(), s.end());
 	}
 
-	return ss.str();
+	return ret;
 }
 
 /**
  * @brief Concatenate strings.
  * Concatenates values which can be streamed to an std::ostream using operator<<().
+ * In case all the values are numbers, chars or strings (see string_builder::is_formatted_natively_v),
+ * those are formatted by string_builder without using std::ostream, memory for the resulting string is reserved once.
+ * Otherwise, all the values are written to a single std::stringstream, so stream manipulators,
+ * e.g. std::hex or std::setw(), apply to the values which follow them.
  * @tparam streamable_type - parameter pack of types of values to concatenate.
  * @param s - parameter pack of values to concatenate.
  * @return std::string of concatenated values.
@@ -261,12 +820,19 @@ std::basic_string<typename strings_collection_type::value_type::value_type> join
 template <typename... streamable_type>
 std::string cat(const streamable_type&... s)
 {
-	std::stringstream ss;
-
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-array-to-pointer-decay, "false positive")
-	[[maybe_unused]] auto& stream = (ss << ... << s);
-
-	return ss.str();
+	if constexpr ((string_builder::is_formatted_natively_v<streamable_type> && ...)) {
+		string_builder sb;
+		sb.reserve(string_builder::estimate_size(s...));
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-array-to-pointer-decay, "false positive")
+		(sb.append(s), ...);
+
+		return std::move(sb).str();
+	} else {
+		std::stringstream ss;
+		[[maybe_unused]] auto& stream = (ss << ... << s);
+		return ss.str();
+	}
 }
 
 /**
@@ -370,6 +936,39 @@ std::from_chars_result from_chars( //
 	chars_format fmt = chars_format::general
 ) noexcept;
 
+/**
+ * @brief Convert float to shortest string representation.
+ * Writes the shortest string representation which converts back to exactly the same float value,
+ * the output is same as of std::to_chars(first, last, value), i.e. the representation is locale-independent and
+ * uses either fixed or scientific format, whichever is shorter.
+ * The output is same on all toolchains.
+ * @param first - output buffer start.
+ * @param last - output buffer end.
+ * @param value - the value to convert.
+ * @return conversion result. In case the buffer is too small the error is std::errc::value_too_large.
+ */
+std::to_chars_result to_chars( //
+	char* first,
+	char* last,
+	float value
+) noexcept;
+
+/**
+ * @brief Convert double to shortest string representation.
+ * Writes the shortest string representation which converts back to exactly the same double value,
+ * the output is same as of std::to_chars(first, last, value).
+ * The output is same on all toolchains.
+ * @param first - output buffer start.
+ * @param last - output buffer end.
+ * @param value - the value to convert.
+ * @return conversion result. In case the buffer is too small the error is std::errc::value_too_large.
+ */
+std::to_chars_result to_chars( //
+	char* first,
+	char* last,
+	double value
+) noexcept;
+
 /**
  * @brief String parsing helper.
  * This helper class iterates through string characters as it was a stream of characters and
@@ -381,6 +980,9 @@ class string_parser
 
 	void throw_if_empty() const;
 
+	// read characters till the given position, npos means till the end of the string
+	std::string_view read_until(size_t pos);
+
 public:
 	/**
 	 * @brief Check if given character is a space-character.
@@ -470,6 +1072,96 @@ public:
 
 		number_type value = 0;
 
+		auto ec = this->parse_number(value);
+
+		if (ec == std::errc::invalid_argument) {
+			throw std::invalid_argument("string_parser::read_integer(): input string does not start with a number");
+		}
+
+		if (ec != std::errc()) {
+			throw std::runtime_error("string_parser::read_integer(): unknown error");
+		}
+
+		return value;
+	}
+
+	/**
+	 * @brief Result of reading a series of numbers.
+	 */
+	struct read_numbers_result {
+		/**
+		 * @brief Number of numbers read.
+		 */
+		size_t num_read;
+
+		/**
+		 * @brief Pointer to the character which has stopped reading.
+		 * This is where the parser remains pointing to after the reading.
+		 */
+		const char* ptr;
+
+		/**
+		 * @brief Reading error.
+		 * std::errc() in case the reading has stopped due to end of the string or the output buffer is full.
+		 * std::errc::invalid_argument in case a character sequence which is not a number was encountered,
+		 * the ptr points to that character sequence. Also, in case a number is not followed by a separator,
+		 * the ptr points to the character right after the number, and in case the string ends with a comma,
+		 * the ptr points to that trailing comma.
+		 */
+		std::errc ec;
+	};
+
+	/**
+	 * @brief Read series of numbers.
+	 * Reads numbers separated by whitespaces and/or a single comma, until the output buffer is full,
+	 * or end of the string is reached, or a non-number is encountered, or a number is not followed by a separator.
+	 * Leading whitespaces before the first number are skipped.
+	 * Numbers are parsed same way as by read_number(). Out of range values are read as 0.
+	 * The parser remains pointing to the character which has stopped the reading.
+	 * This method does not throw on malformed input, the error is reported via the returned value.
+	 * @tparam number_type - type of the numbers to read. Can be one of C++ integral or floating point types.
+	 * @param out - buffer to read the numbers to.
+	 * @return Reading result.
+	 */
+	template <class number_type>
+	read_numbers_result read_numbers(utki::span<number_type> out) noexcept
+	{
+		auto dst = out.begin();
+		return this->read_numbers_internal<number_type>(
+			out.size(), //
+			[&dst](number_type value) {
+				*dst = value;
+				dst = std::next(dst);
+			}
+		);
+	}
+
+	/**
+	 * @brief Read series of numbers.
+	 * Reads numbers separated by whitespaces and/or a single comma, until end of the string is reached,
+	 * or a non-number is encountered, or a number is not followed by a separator.
+	 * Same as read_numbers(utki::span<number_type>), but appends the read numbers to the given vector.
+	 * @tparam number_type - type of the numbers to read. Can be one of C++ integral or floating point types.
+	 * @param out - vector to append the read numbers to.
+	 * @return Reading result.
+	 */
+	template <class number_type>
+	read_numbers_result read_numbers(std::vector<number_type>& out)
+	{
+		return this->read_numbers_internal<number_type>(
+			std::numeric_limits<size_t>::max(), //
+			[&out](number_type value) {
+				out.push_back(value);
+			}
+		);
+	}
+
+private:
+	// Parse number at current position. Does not skip leading whitespaces.
+	// On success the parser position is moved past the parsed number.
+	template <class number_type>
+	std::errc parse_number(number_type& value) noexcept
+	{
 		std::from_chars_result res{};
 
 		if constexpr (std::is_floating_point_v<number_type>) {
@@ -484,42 +1176,43 @@ public:
 
 			if constexpr (std::is_unsigned_v<number_type>) {
 				// detect base
-				if (this->peek_char() == '0') {
-					this->read_char();
-					if (this->empty()) {
-						return number_type(0);
+				if (!this->view.empty() && this->view.front() == '0') {
+					this->view = this->view.substr(1);
+					value = 0;
+					if (this->view.empty()) {
+						return std::errc();
 					}
-					char c = this->peek_char();
+					char c = this->view.front();
 					switch (c) {
 						case 'x':
 							if (this->size() < 2) {
-								return number_type(0);
+								return std::errc();
 							}
-							c = this->peek_char(1);
+							c = this->view[1];
 							if (('0' <= c && c <= '9') || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F')) {
 								base = to_int(integer_base::hex);
-								this->read_char();
+								this->view = this->view.substr(1);
 							} else {
-								return number_type(0);
+								return std::errc();
 							}
 							break;
 						case 'b':
 							if (this->size() < 2) {
-								return number_type(0);
+								return std::errc();
 							}
-							c = this->peek_char(1);
+							c = this->view[1];
 							if (c == '0' || c == '1') {
 								base = to_int(integer_base::bin);
-								this->read_char();
+								this->view = this->view.substr(1);
 							} else {
-								return number_type(0);
+								return std::errc();
 							}
 							break;
 						default:
 							if ('0' <= c && c <= '7') {
 								base = to_int(integer_base::oct);
 							} else if (c < '0' || '9' < c) {
-								return number_type(0);
+								return std::errc();
 							}
 							break;
 					}
@@ -535,7 +1228,7 @@ public:
 		}
 
 		if (res.ec == std::errc::invalid_argument) {
-			throw std::invalid_argument("string_parser::read_integer(): input string does not start with a number");
+			return res.ec;
 		}
 
 		ASSERT(res.ptr > this->view.data())
@@ -551,16 +1244,60 @@ public:
 			// At the moment, there is no compiler-independent way to tell if it was due to too big or too small number.
 			// See https://github.com/fastfloat/fast_float/issues/261 for discussion.
 			// So, we just return 0 for both cases.
-			return {0};
+			value = 0;
+			return std::errc();
 		}
 
-		if (res.ec != std::errc()) {
-			throw std::runtime_error("string_parser::read_integer(): unknown error");
+		return res.ec;
+	}
+
+	template <class number_type, typename store_function_type>
+	read_numbers_result read_numbers_internal(
+		size_t max_num, //
+		store_function_type store
+	)
+	{
+		read_numbers_result ret{0, nullptr, std::errc()};
+
+		for (; ret.num_read != max_num; ++ret.num_read) {
+			if (ret.num_read == 0) {
+				this->skip_whitespaces();
+			} else {
+				if (!this->view.empty() && !is_space(this->view.front()) && this->view.front() != ',') {
+					// no separator after the previous number
+					ret.ec = std::errc::invalid_argument;
+					break;
+				}
+
+				this->skip_whitespaces();
+				auto separator = this->view;
+				this->skip_whitespaces_and_comma();
+				if (this->view.empty() && !separator.empty()) {
+					// trailing comma, there is no number after it
+					this->view = separator;
+					ret.ec = std::errc::invalid_argument;
+					break;
+				}
+			}
+
+			if (this->view.empty()) {
+				break;
+			}
+
+			number_type value = 0;
+			ret.ec = this->parse_number(value);
+			if (ret.ec != std::errc()) {
+				break;
+			}
+
+			store(value);
 		}
 
-		return value;
+		ret.ptr = this->view.data();
+		return ret;
 	}
 
+public:
 	/**
 	 * @brief Read character at current parser position.
 	 * The parser position is advanced one character further.
@@ -585,6 +1322,76 @@ public:
 	 */
 	char peek_char(size_t n) const;
 
+	/**
+	 * @brief Read character at current parser position.
+	 * Non-throwing version of read_char().
+	 * The parser position is advanced one character further.
+	 * @return Character at current parser position.
+	 * @return std::nullopt in case end of string is reached.
+	 */
+	std::optional<char> try_read_char() noexcept
+	{
+		if (this->view.empty()) {
+			return std::nullopt;
+		}
+
+		char ret = this->view.front();
+		this->view.remove_prefix(1);
+		return ret;
+	}
+
+	/**
+	 * @brief Get current character without advancing parser position.
+	 * Non-throwing version of peek_char().
+	 * @return Character at the current parser position.
+	 * @return std::nullopt in case end of string is reached.
+	 */
+	std::optional<char> try_peek_char() const noexcept
+	{
+		if (this->view.empty()) {
+			return std::nullopt;
+		}
+		return this->view.front();
+	}
+
+	/**
+	 * @brief Peek n-th character.
+	 * Non-throwing version of peek_char(size_t).
+	 * This method doesn't move the parser position.
+	 * @param n - position of the character to peek.
+	 * @return Character at n-th position from the current parser's position.
+	 * @return std::nullopt in case requested character is beyond the string's boundary.
+	 */
+	std::optional<char> try_peek_char(size_t n) const noexcept
+	{
+		if (this->view.size() <= n) {
+			return std::nullopt;
+		}
+		return this->view[n];
+	}
+
+	/**
+	 * @brief Read number.
+	 * Non-throwing version of read_number().
+	 * Skip leading whitespaces before reading the number.
+	 * On success, the parser remains pointing to the character which stopped parsing the number.
+	 * On failure, the parser remains pointing to the first non-whitespace character.
+	 * @tparam number_type - type of the number to read. Can be one of C++ integral or floating point types.
+	 * @param value - the read number output. Out of range values are read as 0, same as by read_number().
+	 * @return Reading result. The ptr points to the current parser position after the reading.
+	 *         The ec is std::errc() on success, std::errc::invalid_argument in case the string
+	 *         does not start with a number.
+	 */
+	template <class number_type>
+	std::from_chars_result try_read_number(number_type& value) noexcept
+	{
+		this->skip_whitespaces();
+
+		auto ec = this->parse_number(value);
+
+		return {this->view.data(), ec};
+	}
+
 	/**
 	 * @brief Read N characters.
 	 * @param n - number of characters to read.
@@ -623,14 +1430,74 @@ public:
 };
 
 /**
- * @brief Locale-independent version of std::to_string().
- * @param value - Number value to convert to string.
- * @param conversion_base - Integer base to use for the conversion.
- * @return String representing the converted integer value.
+ * @brief Convert number to string in a caller-provided buffer.
+ * Integral numbers are written in the requested base, unsigned numbers in non-decimal bases get
+ * the '0b', '0' or '0x' prefix, same as utki::to_string() does.
+ * Floating point numbers are written in shortest round-trip representation,
+ * see utki::to_chars(char*, char*, double).
+ * @param buf - output buffer.
+ * @param value - number value to convert.
+ * @param conversion_base - integer base to use for the conversion, ignored for floating point numbers.
+ * @return conversion result. In case the buffer is too small the error is std::errc::value_too_large.
  */
 template <typename number_type>
-std::string to_string(
-	number_type value, //
+std::to_chars_result to_chars(
+	utki::span<char> buf, //
+	number_type value,
+	integer_base conversion_base = integer_base::dec
+) noexcept
+{
+	if constexpr (std::is_floating_point_v<number_type>) {
+		static_assert(
+			std::is_same_v<number_type, float> || std::is_same_v<number_type, double>,
+			"only float and double floating point types are supported"
+		);
+		return utki::to_chars(buf.data(), utki::end_pointer(buf), value);
+	} else {
+		std::string_view prefix;
+
+		if constexpr (std::is_unsigned_v<number_type>) {
+			switch (conversion_base) {
+				case integer_base::bin:
+					prefix = "0b";
+					break;
+				case integer_base::oct:
+					prefix = "0";
+					break;
+				case integer_base::hex:
+					prefix = "0x";
+					break;
+				default:
+					break;
+			}
+		}
+
+		if (buf.size() < prefix.size()) {
+			return {utki::end_pointer(buf), std::errc::value_too_large};
+		}
+
+		auto begin = std::copy(prefix.begin(), prefix.end(), buf.data());
+
+		return std::to_chars(
+			begin, //
+			utki::end_pointer(buf),
+			value,
+			to_int(conversion_base)
+		);
+	}
+}
+
+/**
+ * @brief Append number string representation to a string.
+ * The number is formatted same way as utki::to_chars(utki::span<char>, number_type, integer_base) does.
+ * @param str - string to append the number to.
+ * @param value - number value to convert.
+ * @param conversion_base - integer base to use for the conversion, ignored for floating point numbers.
+ */
+template <typename number_type>
+void append_to_string(
+	std::string& str, //
+	number_type value,
 	integer_base conversion_base = integer_base::dec
 )
 {
@@ -638,47 +1505,35 @@ std::string to_string(
 	constexpr size_t buf_size = 128;
 	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, cppcoreguidelines-pro-type-vararg)
 	std::array<char, buf_size> buf;
-	auto begin = buf.begin();
-
-	if constexpr (std::is_unsigned_v<number_type>) {
-		switch (conversion_base) {
-			case integer_base::bin:
-				buf[0] = '0';
-				buf[1] = 'b';
-				begin = std::next(begin, 2);
-				break;
-			case integer_base::oct:
-				buf[0] = '0';
-				begin = std::next(begin);
-				break;
-			case integer_base::hex:
-				buf[0] = '0';
-				buf[1] = 'x';
-				begin = std::next(begin, 2);
-				break;
-			default:
-				break;
-		}
-	}
 
-	auto res = std::to_chars(
-		&*begin, //
-		utki::end_pointer(buf),
-		value,
-		to_int(conversion_base)
-	);
+	auto res = to_chars(utki::make_span(buf), value, conversion_base);
 
 	if (res.ec != std::errc()) {
-		// std::to_chars() returned error
-		return {};
+		// to_chars() returned error
+		return;
 	}
 
 	ASSERT(res.ptr <= utki::end_pointer(buf))
 
-	return std::string(
-		buf.data(), //
-		res.ptr - buf.data()
-	);
+	str.append(buf.data(), res.ptr - buf.data());
+}
+
+/**
+ * @brief Locale-independent version of std::to_string().
+ * The number is formatted same way as utki::to_chars(utki::span<char>, number_type, integer_base) does.
+ * @param value - Number value to convert to string.
+ * @param conversion_base - Integer base to use for the conversion.
+ * @return String representing the converted integer value.
+ */
+template <typename number_type>
+std::string to_string(
+	number_type value, //
+	integer_base conversion_base = integer_base::dec
+)
+{
+	std::string ret;
+	append_to_string(ret, value, conversion_base);
+	return ret;
 }
 
 /**
@@ -0,0 +1,221 @@
+/*
+The MIT License (MIT)
+
+utki - Utility Kit for C++.
+
+Copyright (c) 2015-2026 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "type_traits.hpp"
+#include "utility.hpp"
+
+namespace utki {
+
+/**
+ * @brief Descriptor of a struct field for binary serialization.
+ * Describes a field of integral, floating point or enumeration type and its byte order in serialized form.
+ * See struct_layout.
+ * @tparam member_pointer - pointer to the data member.
+ * @tparam byte_order - byte order of the field in serialized form.
+ */
+template <auto member_pointer, endian byte_order = endian::little>
+struct struct_field {
+	using object_type = typename member_pointer_traits<decltype(member_pointer)>::object_type;
+	using value_type = typename member_pointer_traits<decltype(member_pointer)>::value_type;
+
+	static_assert(
+		(std::is_arithmetic_v<value_type> && !std::is_same_v<value_type, bool>) || std::is_enum_v<value_type>,
+		"field type must be integral, floating point or enumeration"
+	);
+
+	/**
+	 * @brief Size of the field in serialized form, in bytes.
+	 */
+	constexpr static size_t size = sizeof(value_type);
+
+	/**
+	 * @brief Whether the serialized form of the field is same as its in-memory representation.
+	 */
+	constexpr static bool is_native_byte_order = size == 1 || byte_order == endian::native;
+
+private:
+	using unsigned_type = typename uint_size<size>::type;
+
+	static_assert(sizeof(unsigned_type) == size, "unsupported field size");
+
+public:
+	/**
+	 * @brief Get offset of the field within the struct.
+	 * @param obj - struct object.
+	 * @return Offset of the field within the struct, in bytes.
+	 */
+	static size_t offset(const object_type& obj) noexcept
+	{
+		// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+		return size_t(
+			reinterpret_cast<const uint8_t*>(&(obj.*member_pointer)) - reinterpret_cast<const uint8_t*>(&obj)
+		);
+		// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+	}
+
+	static void read(const uint8_t* in, object_type& obj) noexcept
+	{
+		auto& field = obj.*member_pointer;
+
+		if constexpr (is_native_byte_order) {
+			std::memcpy(&field, in, size);
+		} else if constexpr (byte_order == endian::little) {
+			auto value = deserialize_le<unsigned_type>(in);
+			std::memcpy(&field, &value, size);
+		} else {
+			auto value = deserialize_be<unsigned_type>(in);
+			std::memcpy(&field, &value, size);
+		}
+	}
+
+	static uint8_t* write(const object_type& obj, uint8_t* out) noexcept
+	{
+		const auto& field = obj.*member_pointer;
+
+		if constexpr (is_native_byte_order) {
+			std::memcpy(out, &field, size);
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			return out + size;
+		} else {
+			unsigned_type value = 0;
+			std::memcpy(&value, &field, size);
+			if constexpr (byte_order == endian::little) {
+				return serialize_le(value, out);
+			} else {
+				return serialize_be(value, out);
+			}
+		}
+	}
+};
+
+/**
+ * @brief Binary layout of a struct.
+ * Describes the serialized form of a struct as a sequence of fields without any padding in between.
+ * The whole struct is read or written at once, with a single buffer size check when used
+ * with deserializer::read_struct(), checked_deserializer::read_struct() or serializer::write_struct().
+ * Fields which have host byte order are copied as is. In case all fields have host byte order and are listed
+ * in order of their location in a struct without padding, the whole struct is copied as is.
+ *
+ * Example:
+ * @code
+ * struct header{
+ *     uint32_t magic;
+ *     uint16_t version;
+ *     float scale;
+ * };
+ *
+ * using header_layout = utki::struct_layout<
+ *     utki::struct_field<&header::magic, utki::endian::big>,
+ *     utki::struct_field<&header::version>,
+ *     utki::struct_field<&header::scale>
+ * >;
+ *
+ * utki::deserializer d(buf);
+ * header h = d.read_struct<header_layout>();
+ * @endcode
+ *
+ * @tparam field_type - descriptors of the fields, see struct_field.
+ */
+template <typename... field_type>
+struct struct_layout {
+	static_assert(sizeof...(field_type) != 0, "layout must have at least one field");
+
+	using object_type = std::tuple_element_t<0, std::tuple<typename field_type::object_type...>>;
+
+	static_assert(
+		(std::is_same_v<object_type, typename field_type::object_type> && ...),
+		"all fields must belong to the same struct"
+	);
+
+	/**
+	 * @brief Size of the struct in serialized form, in bytes.
+	 */
+	constexpr static size_t size = (size_t(0) + ... + field_type::size);
+
+private:
+	// whether the serialized form of the struct can be same as its in-memory representation
+	constexpr static bool may_be_memory_layout = std::is_trivially_copyable_v<object_type> &&
+		sizeof(object_type) == size && (field_type::is_native_byte_order && ...);
+
+	// check that fields are listed in order of their location in the struct and there is no padding between them,
+	// the field offsets are known at compile time, so optimizing compilers evaluate the check at compile time
+	static bool is_memory_layout(const object_type& obj) noexcept
+	{
+		size_t offset = 0;
+		bool ret = true;
+		((ret = ret && field_type::offset(obj) == offset, offset += field_type::size), ...);
+		return ret;
+	}
+
+public:
+	/**
+	 * @brief Read struct fields.
+	 * @param in - pointer to the buffer of at least 'size' bytes.
+	 * @param obj - struct to read the fields to.
+	 */
+	static void read(const uint8_t* in, object_type& obj) noexcept
+	{
+		if constexpr (may_be_memory_layout) {
+			if (is_memory_layout(obj)) {
+				std::memcpy(&obj, in, size);
+				return;
+			}
+		}
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		((field_type::read(in, obj), in += field_type::size), ...);
+	}
+
+	/**
+	 * @brief Write struct fields.
+	 * @param obj - struct to write.
+	 * @param out - pointer to the buffer of at least 'size' bytes.
+	 * @return Pointer to the next byte after the written struct.
+	 */
+	static uint8_t* write(const object_type& obj, uint8_t* out) noexcept
+	{
+		if constexpr (may_be_memory_layout) {
+			if (is_memory_layout(obj)) {
+				std::memcpy(out, &obj, size);
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				return out + size;
+			}
+		}
+
+		((out = field_type::write(obj, out)), ...);
+		return out;
+	}
+};
+
+} // namespace utki
@@ -28,7 +28,11 @@ SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include "debug.hpp"
@@ -145,14 +149,170 @@ public:
 	}
 };
 
+namespace tree_internal {
+
+/**
+ * @brief Stack with inline storage for first few elements.
+ * Elements are stored in the inline buffer until the stack grows bigger than the buffer capacity.
+ * After that all elements are moved to heap allocated storage.
+ * @tparam element_type - type of stack elements, must be default constructible and copyable.
+ * @tparam inline_capacity - number of elements which can be stored without heap allocation.
+ */
+template <class element_type, size_t inline_capacity>
+class inline_stack
+{
+	std::array<element_type, inline_capacity> buffer;
+	size_t buffer_size = 0;
+
+	// when not empty, holds all the stack elements
+	std::vector<element_type> heap;
+
+public:
+	inline_stack() = default;
+
+	inline_stack(const inline_stack& s) :
+		buffer_size(s.buffer_size),
+		heap(s.heap)
+	{
+		std::copy(s.buffer.begin(), std::next(s.buffer.begin(), s.buffer_size), this->buffer.begin());
+	}
+
+	inline_stack& operator=(const inline_stack& s)
+	{
+		if (this == &s) {
+			return *this;
+		}
+		std::copy(s.buffer.begin(), std::next(s.buffer.begin(), s.buffer_size), this->buffer.begin());
+		this->buffer_size = s.buffer_size;
+		this->heap = s.heap;
+		return *this;
+	}
+
+	inline_stack(inline_stack&& s) noexcept :
+		buffer_size(s.buffer_size),
+		heap(std::move(s.heap))
+	{
+		std::copy(s.buffer.begin(), std::next(s.buffer.begin(), s.buffer_size), this->buffer.begin());
+		s.heap.clear();
+		s.buffer_size = 0;
+	}
+
+	inline_stack& operator=(inline_stack&& s) noexcept
+	{
+		if (this == &s) {
+			return *this;
+		}
+		std::copy(s.buffer.begin(), std::next(s.buffer.begin(), s.buffer_size), this->buffer.begin());
+		this->buffer_size = s.buffer_size;
+		this->heap = std::move(s.heap);
+		s.heap.clear();
+		s.buffer_size = 0;
+		return *this;
+	}
+
+	~inline_stack() = default;
+
+	size_t size() const noexcept
+	{
+		return this->heap.empty() ? this->buffer_size : this->heap.size();
+	}
+
+	bool empty() const noexcept
+	{
+		return this->size() == 0;
+	}
+
+	element_type* begin() noexcept
+	{
+		return this->heap.empty() ? this->buffer.data() : this->heap.data();
+	}
+
+	const element_type* begin() const noexcept
+	{
+		return this->heap.empty() ? this->buffer.data() : this->heap.data();
+	}
+
+	element_type* end() noexcept
+	{
+		return std::next(this->begin(), this->size());
+	}
+
+	const element_type* end() const noexcept
+	{
+		return std::next(this->begin(), this->size());
+	}
+
+	element_type& operator[](size_t i) noexcept
+	{
+		ASSERT(i < this->size())
+		return *std::next(this->begin(), i);
+	}
+
+	const element_type& operator[](size_t i) const noexcept
+	{
+		ASSERT(i < this->size())
+		return *std::next(this->begin(), i);
+	}
+
+	const element_type& at(size_t i) const
+	{
+		if (i >= this->size()) {
+			throw std::out_of_range("inline_stack::at(): index is out of range");
+		}
+		return this->operator[](i);
+	}
+
+	element_type& back() noexcept
+	{
+		ASSERT(!this->empty())
+		return *std::prev(this->end());
+	}
+
+	const element_type& back() const noexcept
+	{
+		ASSERT(!this->empty())
+		return *std::prev(this->end());
+	}
+
+	void push_back(const element_type& e)
+	{
+		if (this->heap.empty()) {
+			if (this->buffer_size != inline_capacity) {
+				this->buffer[this->buffer_size] = e;
+				++this->buffer_size;
+				return;
+			}
+			this->heap.reserve(inline_capacity * 2 + 1);
+			this->heap.assign(this->buffer.begin(), this->buffer.end());
+			this->buffer_size = 0;
+		}
+		this->heap.push_back(e);
+	}
+
+	void pop_back() noexcept
+	{
+		ASSERT(!this->empty())
+		if (this->heap.empty()) {
+			--this->buffer_size;
+		} else {
+			this->heap.pop_back();
+		}
+	}
+};
+
+} // namespace tree_internal
+
 /**
  * @brief Helper for traversing the tree data structure.
  * This class is a wrapper class which provides STL-like container interface which
  * allows traversal of the tree data structure.
  * The traversal is done in pre-order, i.e. first the parent node is visited, then its child nodes are visited.
+ * Iterators keep the path from the root to the current tree node in an inline buffer of inline_depth levels,
+ * so creating and copying iterators does not allocate heap memory unless the tree is deeper than inline_depth.
  * @tparam collection_type - container type the tree is based on.
+ * @tparam inline_depth - tree depth up to which iterators do not allocate heap memory.
  */
-template <class collection_type>
+template <class collection_type, size_t inline_depth = 16>
 class traversal
 {
 	static_assert(
@@ -223,22 +383,42 @@ private:
 			const collection_type,
 			collection_type>;
 
-		std::vector<list_type*> list_stack;
-
 		using iterator_type = typename std::conditional_t< //
 			is_const,
 			typename collection_type::const_iterator,
 			typename collection_type::iterator>;
 
-		std::vector<iterator_type> iter_stack;
+		struct level {
+			list_type* list;
+			iterator_type iter;
+		};
 
-		template <class>
+		tree_internal::inline_stack<level, inline_depth> stack;
+
+		template <class, size_t>
 		friend class traversal;
 
+		// compare positions of the tree nodes in traversal order
+		int compare(const iterator_internal& iter) const noexcept
+		{
+			auto num = std::min(this->stack.size(), iter.stack.size());
+			for (size_t i = 0; i != num; ++i) {
+				const auto& a = this->stack[i].iter;
+				const auto& b = iter.stack[i].iter;
+				if (a != b) {
+					// iterators are within the same list because all higher levels are equal
+					return a < b ? -1 : 1;
+				}
+			}
+			if (this->stack.size() == iter.stack.size()) {
+				return 0;
+			}
+			return this->stack.size() < iter.stack.size() ? -1 : 1;
+		}
+
 		iterator_internal(collection_type& roots, iterator_type i)
 		{
-			this->list_stack.push_back(&roots);
-			this->iter_stack.push_back(i);
+			this->stack.push_back(level{&roots, i});
 		}
 
 	public:
@@ -267,28 +447,42 @@ private:
 		 */
 		iterator_internal& operator++()
 		{
-			ASSERT(!this->iter_stack.empty())
-			ASSERT(this->iter_stack.size() == this->list_stack.size())
+			ASSERT(!this->stack.empty())
+
+			auto& l = this->stack.back();
+			ASSERT(l.list)
+
+			ASSERT(l.iter != l.list->end())
+			if (!l.iter->children.empty()) {
+				auto& children = l.iter->children;
+				this->stack.push_back(level{&children, children.begin()});
+				return *this;
+			}
+
+			return this->skip_subtree();
+		}
+
+		/**
+		 * @brief Move iterator past the subtree of the current tree node.
+		 * The iterator is moved to the next tree node in traversal order which is not a descendant
+		 * of the current tree node. I.e. the children of the current tree node are not visited.
+		 * @return Reference to this iterator.
+		 */
+		iterator_internal& skip_subtree()
+		{
+			ASSERT(!this->stack.empty())
 
 			{
-				ASSERT(this->list_stack.back())
-				auto& iter = this->iter_stack.back();
-
-				ASSERT(iter != this->list_stack.back()->end())
-				if (!iter->children.empty()) {
-					this->list_stack.push_back(&iter->children);
-					this->iter_stack.push_back(this->list_stack.back()->begin());
-					return *this;
-				}
-				++iter;
+				auto& l = this->stack.back();
+				ASSERT(l.iter != l.list->end())
+				++l.iter;
 			}
 
-			ASSERT(this->iter_stack.size() >= 1)
-			for (; this->iter_stack.size() != 1;) {
-				if (this->iter_stack.back() == this->list_stack.back()->end()) {
-					this->list_stack.pop_back();
-					this->iter_stack.pop_back();
-					++this->iter_stack.back();
+			ASSERT(this->stack.size() >= 1)
+			for (; this->stack.size() != 1;) {
+				if (this->stack.back().iter == this->stack.back().list->end()) {
+					this->stack.pop_back();
+					++this->stack.back().iter;
 				} else {
 					break;
 				}
@@ -305,23 +499,21 @@ private:
 		 */
 		iterator_internal& operator--()
 		{
-			ASSERT(!this->iter_stack.empty())
-			ASSERT(!this->list_stack.empty())
+			ASSERT(!this->stack.empty())
 
-			if (this->iter_stack.back() == this->list_stack.back()->begin()) {
-				this->iter_stack.pop_back();
-				this->list_stack.pop_back();
+			if (this->stack.back().iter == this->stack.back().list->begin()) {
+				this->stack.pop_back();
 				return *this;
 			}
 
 			for (;;) {
-				auto& iter = this->iter_stack.back();
-				ASSERT(iter != this->list_stack.back()->begin())
-				--iter;
+				auto& l = this->stack.back();
+				ASSERT(l.iter != l.list->begin())
+				--l.iter;
 
-				if (!iter->children.empty()) {
-					this->list_stack.push_back(&iter->children);
-					this->iter_stack.push_back(this->list_stack.back()->end());
+				if (!l.iter->children.empty()) {
+					auto& children = l.iter->children;
+					this->stack.push_back(level{&children, children.end()});
 				} else {
 					break;
 				}
@@ -332,12 +524,22 @@ private:
 
 		/**
 		 * @brief Chack that two iterators point to the same tree node.
+		 * The iterators are compared by depth and by the tree node they point to,
+		 * so the comparison takes constant time regardless of the iterator depth.
 		 * @return false in case this iterator points to a different tree node than the given iterator.
 		 * @return true in case this iterator points to the same tree node as the given iterator.
 		 */
 		bool operator==(const iterator_internal& iter) const noexcept
 		{
-			return this->iter_stack == iter.iter_stack;
+			if (this->stack.size() != iter.stack.size()) {
+				return false;
+			}
+			if (this->stack.empty()) {
+				return true;
+			}
+			const auto& a = this->stack.back();
+			const auto& b = iter.stack.back();
+			return a.iter == b.iter && a.list == b.list;
 		}
 
 		/**
@@ -358,7 +560,7 @@ private:
 		 */
 		bool operator<(const iterator_internal& iter) const noexcept
 		{
-			return this->iter_stack < iter.iter_stack;
+			return this->compare(iter) < 0;
 		}
 
 		/**
@@ -369,7 +571,7 @@ private:
 		 */
 		bool operator>(const iterator_internal& iter) const noexcept
 		{
-			return this->iter_stack > iter.iter_stack;
+			return this->compare(iter) > 0;
 		}
 
 		/**
@@ -380,7 +582,7 @@ private:
 		 */
 		bool operator<=(const iterator_internal& iter) const noexcept
 		{
-			return this->iter_stack <= iter.iter_stack;
+			return this->compare(iter) <= 0;
 		}
 
 		/**
@@ -391,7 +593,7 @@ private:
 		 */
 		bool operator>=(const iterator_internal& iter) const noexcept
 		{
-			return this->iter_stack >= iter.iter_stack;
+			return this->compare(iter) >= 0;
 		}
 
 		/**
@@ -402,7 +604,7 @@ private:
 			conditional_t<is_const, const typename collection_type::value_type, typename collection_type::value_type>&
 			operator*() noexcept
 		{
-			return *this->iter_stack.back();
+			return *this->stack.back().iter;
 		}
 
 		/**
@@ -412,7 +614,7 @@ private:
 		 */
 		const typename collection_type::value_type& operator*() const noexcept
 		{
-			return *this->iter_stack.back();
+			return *this->stack.back().iter;
 		}
 
 		/**
@@ -423,7 +625,7 @@ private:
 			conditional_t<is_const, const typename collection_type::value_type, typename collection_type::value_type>*
 			operator->() noexcept
 		{
-			return this->iter_stack.back().operator->();
+			return this->stack.back().iter.operator->();
 		}
 
 		/**
@@ -433,7 +635,7 @@ private:
 		 */
 		const typename collection_type::value_type* operator->() const noexcept
 		{
-			return this->iter_stack.back().operator->();
+			return this->stack.back().iter.operator->();
 		}
 
 		/**
@@ -444,10 +646,10 @@ private:
 		 */
 		std::vector<size_type> index() const
 		{
-			ASSERT(this->iter_stack.size() == this->list_stack.size())
 			std::vector<size_type> ret;
-			for (typename decltype(this->iter_stack)::size_type i = 0; i != this->iter_stack.size(); ++i) {
-				ret.push_back(std::distance(this->list_stack[i]->begin(), this->iter_stack[i]));
+			ret.reserve(this->stack.size());
+			for (const auto& l : this->stack) {
+				ret.push_back(std::distance(l.list->begin(), l.iter));
 			}
 			return ret;
 		}
@@ -461,7 +663,7 @@ private:
 		 */
 		size_t depth() const noexcept
 		{
-			return this->iter_stack.size();
+			return this->stack.size();
 		}
 
 		/**
@@ -476,7 +678,7 @@ private:
 			typename collection_type::value_type>&
 		at_level(size_t d) noexcept
 		{
-			return *this->iter_stack.at(d);
+			return *this->stack.at(d).iter;
 		}
 
 		/**
@@ -487,7 +689,7 @@ private:
 		 */
 		const typename collection_type::value_type& at_level(size_t d) const noexcept
 		{
-			return *this->iter_stack.at(d);
+			return *this->stack.at(d).iter;
 		}
 
 		/**
@@ -497,11 +699,12 @@ private:
 		 */
 		bool is_last_child() const noexcept
 		{
-			if (this->iter_stack.back() == this->list_stack.back()->end()) {
+			const auto& l = this->stack.back();
+			if (l.iter == l.list->end()) {
 				return false;
 			}
 
-			return std::next(this->iter_stack.back()) == this->list_stack.back()->end();
+			return std::next(l.iter) == l.list->end();
 		}
 	};
 
@@ -531,6 +734,66 @@ public:
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 private:
+	// get tree node by index without creating an iterator, returns nullptr if the index is invalid
+	pointer find(utki::span<const size_type> index) const noexcept
+	{
+		if (index.empty()) {
+			return nullptr;
+		}
+
+		pointer node = nullptr;
+		auto list = &this->roots;
+		for (auto i : index) {
+			if (i >= list->size()) {
+				return nullptr;
+			}
+			node = &(*list)[i];
+			list = &node->children;
+		}
+		return node;
+	}
+
+	template <class node_pointer_type>
+	void find(utki::span<const std::vector<size_type>> indices, utki::span<node_pointer_type> nodes) const
+	{
+		if (indices.size() != nodes.size()) {
+			throw std::invalid_argument("traversal::at(): indices and nodes have different sizes");
+		}
+
+		// tree nodes on the path given by the previously resolved index
+		tree_internal::inline_stack<pointer, inline_depth> path;
+
+		auto out = nodes.begin();
+		for (auto index = indices.begin(); index != indices.end(); ++index, ++out) {
+			if (index->empty()) {
+				throw std::out_of_range("traversal::at(): given index is empty");
+			}
+
+			size_t common = 0;
+			if (index != indices.begin()) {
+				const auto& prev = *std::prev(index);
+				auto num = std::min(index->size(), prev.size());
+				for (; common != num && (*index)[common] == prev[common]; ++common) {
+				}
+			}
+
+			while (path.size() > common) {
+				path.pop_back();
+			}
+
+			auto list = path.empty() ? &this->roots : &path.back()->children;
+			for (auto i = std::next(index->begin(), path.size()); i != index->end(); ++i) {
+				if (*i >= list->size()) {
+					throw std::out_of_range("traversal::at(): given index points out of the tree");
+				}
+				path.push_back(&(*list)[*i]);
+				list = &path.back()->children;
+			}
+
+			*out = path.back();
+		}
+	}
+
 	template <bool is_const>
 	iterator_internal<is_const> make_iterator_internal(utki::span<const size_type> index) const
 	{
@@ -540,12 +803,11 @@ private:
 		auto iter = this->roots.begin();
 
 		for (auto i : index) {
-			ret.list_stack.push_back(list);
 			if (i >= list->size()) {
 				throw std::out_of_range("given index points out of the tree");
 			}
-			ret.iter_stack.push_back(std::next(iter, i));
-			list = &ret.iter_stack.back()->children;
+			ret.stack.push_back({list, std::next(iter, i)});
+			list = &ret.stack.back().iter->children;
 			iter = list->begin();
 		}
 
@@ -623,18 +885,7 @@ public:
 	 */
 	bool is_valid(utki::span<const size_type> index) const
 	{
-		if (index.empty()) {
-			return false;
-		}
-
-		auto li = &this->roots;
-		for (auto i : index) {
-			if (i >= li->size()) {
-				return false;
-			}
-			li = &(*li)[i].children;
-		}
-		return true;
+		return this->find(index) != nullptr;
 	}
 
 	/**
@@ -662,7 +913,7 @@ public:
 	// TODO: is needed? span overload seems enough, std::span in C++26 should support initializer lists
 	bool is_valid(std::initializer_list<size_t> index) const
 	{
-		return this->is_valid(std::vector<size_t>(index));
+		return this->is_valid(utki::make_span(index));
 	}
 
 	/**
@@ -672,9 +923,9 @@ public:
 	 */
 	typename collection_type::value_type& operator[](utki::span<const size_type> index)
 	{
-		ASSERT(this->is_valid(index))
-		// TODO: rewrite without creating iterator, for more performance
-		return *this->make_iterator(index);
+		auto node = this->find(index);
+		ASSERT(node)
+		return *node;
 	}
 
 	/**
@@ -684,9 +935,9 @@ public:
 	 */
 	const typename collection_type::value_type& operator[](utki::span<const size_type> index) const
 	{
-		ASSERT(this->is_valid(index))
-		// TODO: rewrite without creating iterator, for more performance
-		return *this->make_const_iterator(index);
+		auto node = this->find(index);
+		ASSERT(node)
+		return *node;
 	}
 
 	/**
@@ -716,7 +967,7 @@ public:
 	 */
 	typename collection_type::value_type& operator[](std::initializer_list<size_t> index)
 	{
-		return this->operator[](std::vector<size_t>(index));
+		return this->operator[](utki::make_span(index));
 	}
 
 	/**
@@ -726,7 +977,89 @@ public:
 	 */
 	const typename collection_type::value_type& operator[](std::initializer_list<size_t> index) const
 	{
-		return this->operator[](std::vector<size_t>(index));
+		return this->operator[](utki::make_span(index));
+	}
+
+	/**
+	 * @brief Get reference to tree element by index.
+	 * @param index - index of the tree element.
+	 * @return reference to the tree element referred by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	reference at(utki::span<const size_type> index)
+	{
+		auto node = this->find(index);
+		if (!node) {
+			throw std::out_of_range("traversal::at(): given index points out of the tree");
+		}
+		return *node;
+	}
+
+	/**
+	 * @brief Get constant reference to tree element by index.
+	 * @param index - index of the tree element.
+	 * @return reference to the tree element referred by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	const_reference at(utki::span<const size_type> index) const
+	{
+		auto node = this->find(index);
+		if (!node) {
+			throw std::out_of_range("traversal::at(): given index points out of the tree");
+		}
+		return *node;
+	}
+
+	/**
+	 * @brief Get reference to tree element by index.
+	 * @param index - index of the tree element.
+	 * @return reference to the tree element referred by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	reference at(std::initializer_list<size_t> index)
+	{
+		return this->at(utki::make_span(index));
+	}
+
+	/**
+	 * @brief Get constant reference to tree element by index.
+	 * @param index - index of the tree element.
+	 * @return reference to the tree element referred by index.
+	 * @throw std::out_of_range - in case the given index points out of the tree.
+	 */
+	const_reference at(std::initializer_list<size_t> index) const
+	{
+		return this->at(utki::make_span(index));
+	}
+
+	/**
+	 * @brief Get tree elements by list of indices.
+	 * Resolves all the given indices in one go without heap allocations, unless the indices are deeper than
+	 * inline_depth. Consecutive indices which have common prefix are resolved starting from the
+	 * last common tree node, so sorting the indices lexicographically makes the lookup faster.
+	 * @param indices - indices of the tree elements.
+	 * @param nodes - span to store pointers to the tree elements to. Must be of same size as indices.
+	 * @throw std::out_of_range - in case any of the given indices is empty or points out of the tree.
+	 * @throw std::invalid_argument - in case indices and nodes are of different sizes.
+	 */
+	void at(utki::span<const std::vector<size_type>> indices, utki::span<pointer> nodes)
+	{
+		this->find(indices, nodes);
+	}
+
+	/**
+	 * @brief Get constant tree elements by list of indices.
+	 * Resolves all the given indices in one go without heap allocations, unless the indices are deeper than
+	 * inline_depth. Consecutive indices which have common prefix are resolved starting from the
+	 * last common tree node, so sorting the indices lexicographically makes the lookup faster.
+	 * @param indices - indices of the tree elements.
+	 * @param nodes - span to store pointers to the tree elements to. Must be of same size as indices.
+	 * @throw std::out_of_range - in case any of the given indices is empty or points out of the tree.
+	 * @throw std::invalid_argument - in case indices and nodes are of different sizes.
+	 */
+	void at(utki::span<const std::vector<size_type>> indices, utki::span<const_pointer> nodes) const
+	{
+		this->find(indices, nodes);
 	}
 
 	/**
@@ -811,7 +1144,8 @@ public:
 	 */
 	iterator insert(iterator i, value_type&& t)
 	{
-		i.iter_stack.back() = i.list_stack.back()->insert(i.iter_stack.back(), std::move(t));
+		auto& l = i.stack.back();
+		l.iter = l.list->insert(l.iter, std::move(t));
 		return i;
 	}
 
@@ -839,7 +1173,8 @@ public:
 	 */
 	iterator insert_after(iterator i, value_type&& t)
 	{
-		i.iter_stack.back() = i.list_stack.back()->insert(std::next(i.iter_stack.back()), std::move(t));
+		auto& l = i.stack.back();
+		l.iter = l.list->insert(std::next(l.iter), std::move(t));
 		return i;
 	}
 
@@ -865,12 +1200,13 @@ public:
 	 */
 	iterator erase(iterator i)
 	{
-		i.iter_stack.back() = i.list_stack.back()->erase(i.iter_stack.back());
-		while (i.iter_stack.size() > 1 && i.iter_stack.back() == i.list_stack.back()->end()) {
-			i.list_stack.pop_back();
-			i.iter_stack.pop_back();
-			ASSERT(i.iter_stack.size() == i.list_stack.size())
-			++i.iter_stack.back();
+		{
+			auto& l = i.stack.back();
+			l.iter = l.list->erase(l.iter);
+		}
+		while (i.stack.size() > 1 && i.stack.back().iter == i.stack.back().list->end()) {
+			i.stack.pop_back();
+			++i.stack.back().iter;
 		}
 		return i;
 	}
@@ -888,4 +1224,612 @@ traversal<container_type> make_traversal(container_type& trees)
 	return traversal<container_type>(trees);
 }
 
+/**
+ * @brief Helper for post-order traversal of the tree data structure.
+ * This class is a wrapper class which provides STL-like container interface which
+ * allows traversal of the tree data structure in post-order, i.e. first the child nodes
+ * are visited, then their parent node is visited.
+ * Iterators keep the path from the root to the current tree node in an inline buffer of inline_depth levels,
+ * so creating and copying iterators does not allocate heap memory unless the tree is deeper than inline_depth.
+ * @tparam collection_type - container type the tree is based on.
+ * @tparam inline_depth - tree depth up to which iterators do not allocate heap memory.
+ */
+template <class collection_type, size_t inline_depth = 16>
+class post_order_traversal
+{
+	static_assert(
+		std::is_same_v< //
+			decltype(collection_type::value_type::children),
+			typename std::remove_const_t<collection_type>>,
+		"collection_type::value_type must have 'children' member of type collection_type"
+	);
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+	collection_type& roots;
+
+public:
+	/**
+	 * @brief Construct a post-order traversal object around given list of trees.
+	 * The traversal object does not take ownership of the passed in list of trees, but it holds a reference to that.
+	 * So, the given list of trees must remain alive during the whole life-span of the traversal object.
+	 * @param trees - list of trees through which the traversal will be performed.
+	 */
+	post_order_traversal(collection_type& trees) :
+		roots(trees)
+	{}
+
+	/**
+	 * @brief Tree node type.
+	 */
+	using value_type = typename std::conditional_t< //
+		std::is_const_v<collection_type>,
+		const typename collection_type::value_type,
+		typename collection_type::value_type>;
+
+	/**
+	 * @brief Pointer to tree node type.
+	 */
+	using pointer = value_type*;
+
+	/**
+	 * @brief Constant pointer to tree node type.
+	 */
+	using const_pointer = const value_type*;
+
+	/**
+	 * @brief Reference to tree node type.
+	 */
+	using reference = value_type&;
+
+	/**
+	 * @brief Constant reference to tree node type.
+	 */
+	using const_reference = const value_type&;
+
+	/**
+	 * @brief List size type.
+	 */
+	using size_type = typename collection_type::size_type;
+
+	/**
+	 * @brief List index difference type.
+	 */
+	using difference_type = typename collection_type::difference_type;
+
+private:
+	template <bool is_const>
+	class iterator_internal
+	{
+		using list_type = typename std::conditional_t< //
+			is_const,
+			const collection_type,
+			collection_type>;
+
+		using iterator_type = typename std::conditional_t< //
+			is_const,
+			typename collection_type::const_iterator,
+			typename collection_type::iterator>;
+
+		struct level {
+			list_type* list;
+			iterator_type iter;
+		};
+
+		tree_internal::inline_stack<level, inline_depth> stack;
+
+		template <class, size_t>
+		friend class post_order_traversal;
+
+		iterator_internal(collection_type& roots, iterator_type i)
+		{
+			this->stack.push_back(level{&roots, i});
+			this->descend();
+		}
+
+		// move to the first tree node of the current node's subtree in post-order
+		void descend()
+		{
+			for (;;) {
+				auto& l = this->stack.back();
+				if (l.iter == l.list->end() || l.iter->children.empty()) {
+					return;
+				}
+				auto& children = l.iter->children;
+				this->stack.push_back(level{&children, children.begin()});
+			}
+		}
+
+	public:
+		iterator_internal() = default;
+
+		/**
+		 * @brief Tree node type.
+		 */
+		using value_type = typename std::conditional_t< //
+			is_const,
+			const typename post_order_traversal::value_type,
+			typename post_order_traversal::value_type>;
+
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = typename collection_type::difference_type;
+
+		/**
+		 * @brief Move iterator to the next tree node.
+		 * The iterator is moved to the next tree node in post-order.
+		 * @return Reference to this iterator.
+		 */
+		iterator_internal& operator++()
+		{
+			ASSERT(!this->stack.empty())
+
+			auto& l = this->stack.back();
+			ASSERT(l.iter != l.list->end())
+			++l.iter;
+
+			if (l.iter == l.list->end()) {
+				// all children are visited, go to the parent node
+				if (this->stack.size() != 1) {
+					this->stack.pop_back();
+				}
+				return *this;
+			}
+
+			this->descend();
+			return *this;
+		}
+
+		/**
+		 * @brief Chack that two iterators point to the same tree node.
+		 * @return false in case this iterator points to a different tree node than the given iterator.
+		 * @return true in case this iterator points to the same tree node as the given iterator.
+		 */
+		bool operator==(const iterator_internal& iter) const noexcept
+		{
+			if (this->stack.size() != iter.stack.size()) {
+				return false;
+			}
+			if (this->stack.empty()) {
+				return true;
+			}
+			const auto& a = this->stack.back();
+			const auto& b = iter.stack.back();
+			return a.iter == b.iter && a.list == b.list;
+		}
+
+		/**
+		 * @brief Check that iterators point to different tree nodes.
+		 * @return true in case this iterator points to a different tree node than the given iterator.
+		 * @return false in case this iterator points to the same tree node as the given iterator.
+		 */
+		bool operator!=(const iterator_internal& iter) const noexcept
+		{
+			return !this->operator==(iter);
+		}
+
+		/**
+		 * @brief Dereference the tree node.
+		 * @return Reference to the tree node this iterator points to.
+		 */
+		value_type& operator*() const noexcept
+		{
+			return *this->stack.back().iter;
+		}
+
+		/**
+		 * @brief Dereference the tree node.
+		 * @return Pointer to the tree node this iterator points to.
+		 */
+		value_type* operator->() const noexcept
+		{
+			return this->stack.back().iter.operator->();
+		}
+
+		/**
+		 * @brief Get iterator depth.
+		 * Depth of one means that the iterator points to one of the root nodes.
+		 * And so on.
+		 * @return number depth of the tree node the iterator points to.
+		 */
+		size_t depth() const noexcept
+		{
+			return this->stack.size();
+		}
+	};
+
+public:
+	/**
+	 * @brief Iterator type.
+	 * The iterator performs the post-order traversal of the tree.
+	 */
+	using iterator = iterator_internal<std::is_const_v<collection_type>>;
+
+	/**
+	 * @brief Constant iterator type.
+	 * The iterator performs the post-order traversal of the tree.
+	 */
+	using const_iterator = iterator_internal<true>;
+
+	/**
+	 * @brief Get iterator pointing to the first tree node in post-order.
+	 * @return Iterator pointing to the first tree node in post-order.
+	 */
+	iterator begin()
+	{
+		return iterator(this->roots, this->roots.begin());
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the first tree node in post-order.
+	 * @return Constant iterator pointing to the first tree node in post-order.
+	 */
+	const_iterator begin() const
+	{
+		return this->cbegin();
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the first tree node in post-order.
+	 * @return Constant iterator pointing to the first tree node in post-order.
+	 */
+	const_iterator cbegin() const
+	{
+		return const_iterator(this->roots, this->roots.cbegin());
+	}
+
+	/**
+	 * @brief Get iterator pointing to the end of the tree hierarchy.
+	 * @return Iterator pointing to the end of the tree hierarchy.
+	 */
+	iterator end()
+	{
+		return iterator(this->roots, this->roots.end());
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the end of the tree hierarchy.
+	 * @return constant iterator pointing to the end of the tree hierarchy.
+	 */
+	const_iterator end() const
+	{
+		return this->cend();
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the end of the tree hierarchy.
+	 * @return constant iterator pointing to the end of the tree hierarchy.
+	 */
+	const_iterator cend() const
+	{
+		return const_iterator(this->roots, this->roots.cend());
+	}
+};
+
+/**
+ * @brief Construct post-order traversal object out given list of tree nodes.
+ * This is a helper method for automatic template arguments resolution when creating traversal object.
+ * @param trees - list of tree nodes to make traversal object around.
+ * @return Post-order traversal object.
+ */
+template <class container_type>
+post_order_traversal<container_type> make_post_order_traversal(container_type& trees)
+{
+	return post_order_traversal<container_type>(trees);
+}
+
+/**
+ * @brief Helper for level-order traversal of the tree data structure.
+ * This class is a wrapper class which provides STL-like container interface which
+ * allows breadth-first traversal of the tree data structure, i.e. all root nodes are visited first,
+ * then all their children are visited, then all grandchildren, and so on.
+ * The traversal object holds the queue buffer of tree nodes to visit which is used by the non-constant begin().
+ * The buffer is reused by subsequent traversals, so the traversal does not allocate heap memory once the buffer
+ * has grown to the size of the tree. Because of the shared queue buffer, calling non-constant begin() invalidates
+ * all iterators previously obtained from the same traversal object by non-constant begin().
+ * Constant iterators obtained by cbegin() or constant begin() allocate their own queue, which is shared
+ * by their copies, so those do not modify the traversal object.
+ * @tparam collection_type - container type the tree is based on.
+ */
+template <class collection_type>
+class level_order_traversal
+{
+	static_assert(
+		std::is_same_v< //
+			decltype(collection_type::value_type::children),
+			typename std::remove_const_t<collection_type>>,
+		"collection_type::value_type must have 'children' member of type collection_type"
+	);
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-const-or-ref-data-members)
+	collection_type& roots;
+
+public:
+	/**
+	 * @brief Construct a level-order traversal object around given list of trees.
+	 * The traversal object does not take ownership of the passed in list of trees, but it holds a reference to that.
+	 * So, the given list of trees must remain alive during the whole life-span of the traversal object.
+	 * @param trees - list of trees through which the traversal will be performed.
+	 */
+	level_order_traversal(collection_type& trees) :
+		roots(trees)
+	{}
+
+	/**
+	 * @brief Tree node type.
+	 */
+	using value_type = typename std::conditional_t< //
+		std::is_const_v<collection_type>,
+		const typename collection_type::value_type,
+		typename collection_type::value_type>;
+
+	/**
+	 * @brief Pointer to tree node type.
+	 */
+	using pointer = value_type*;
+
+	/**
+	 * @brief Constant pointer to tree node type.
+	 */
+	using const_pointer = const value_type*;
+
+	/**
+	 * @brief Reference to tree node type.
+	 */
+	using reference = value_type&;
+
+	/**
+	 * @brief Constant reference to tree node type.
+	 */
+	using const_reference = const value_type&;
+
+	/**
+	 * @brief List size type.
+	 */
+	using size_type = typename collection_type::size_type;
+
+	/**
+	 * @brief List index difference type.
+	 */
+	using difference_type = typename collection_type::difference_type;
+
+private:
+	struct queue_entry {
+		pointer node;
+		size_t depth;
+	};
+
+	// Tree nodes in level-order, the nodes before num_expanded have their children added to the queue.
+	// The queue only grows while iterating, so several iterators at different positions can share it.
+	struct queue_type {
+		std::vector<queue_entry> entries;
+		size_t num_expanded = 0;
+
+		void restart(collection_type& roots)
+		{
+			this->entries.clear();
+			this->num_expanded = 0;
+			for (auto& r : roots) {
+				this->entries.push_back(queue_entry{&r, 1});
+			}
+		}
+
+		void expand(size_t pos)
+		{
+			for (; this->num_expanded <= pos; ++this->num_expanded) {
+				// NOTE: push_back() may invalidate references to the queue entries, so copy the entry
+				auto e = this->entries[this->num_expanded];
+				for (auto& c : e.node->children) {
+					this->entries.push_back(queue_entry{&c, e.depth + 1});
+				}
+			}
+		}
+	};
+
+	// queue buffer reused by non-constant begin()
+	queue_type queue;
+
+	template <bool is_const>
+	class iterator_internal
+	{
+		queue_type* queue = nullptr;
+
+		// queue owned by constant iterators, shared with their copies
+		std::shared_ptr<queue_type> owned_queue;
+
+		size_t pos = 0;
+
+		template <class>
+		friend class level_order_traversal;
+
+		iterator_internal(queue_type& queue) :
+			queue(&queue)
+		{}
+
+		iterator_internal(std::shared_ptr<queue_type> queue) :
+			queue(queue.get()),
+			owned_queue(std::move(queue))
+		{}
+
+		bool is_end() const noexcept
+		{
+			// all nodes before the current one are expanded, so if there are no more
+			// nodes in the queue then there will be no more nodes to visit
+			return !this->queue || this->pos >= this->queue->entries.size();
+		}
+
+	public:
+		iterator_internal() = default;
+
+		/**
+		 * @brief Tree node type.
+		 */
+		using value_type = typename std::conditional_t< //
+			is_const,
+			const typename level_order_traversal::value_type,
+			typename level_order_traversal::value_type>;
+
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = typename collection_type::difference_type;
+
+		/**
+		 * @brief Move iterator to the next tree node.
+		 * The iterator is moved to the next tree node in level-order.
+		 * @return Reference to this iterator.
+		 */
+		iterator_internal& operator++()
+		{
+			ASSERT(!this->is_end())
+			this->queue->expand(this->pos);
+			++this->pos;
+			return *this;
+		}
+
+		/**
+		 * @brief Chack that two iterators point to the same tree node.
+		 * @return false in case this iterator points to a different tree node than the given iterator.
+		 * @return true in case this iterator points to the same tree node as the given iterator.
+		 */
+		bool operator==(const iterator_internal& iter) const noexcept
+		{
+			if (this->is_end() || iter.is_end()) {
+				return this->is_end() == iter.is_end();
+			}
+			return this->pos == iter.pos;
+		}
+
+		/**
+		 * @brief Check that iterators point to different tree nodes.
+		 * @return true in case this iterator points to a different tree node than the given iterator.
+		 * @return false in case this iterator points to the same tree node as the given iterator.
+		 */
+		bool operator!=(const iterator_internal& iter) const noexcept
+		{
+			return !this->operator==(iter);
+		}
+
+		/**
+		 * @brief Dereference the tree node.
+		 * @return Reference to the tree node this iterator points to.
+		 */
+		value_type& operator*() const noexcept
+		{
+			ASSERT(!this->is_end())
+			return *this->queue->entries[this->pos].node;
+		}
+
+		/**
+		 * @brief Dereference the tree node.
+		 * @return Pointer to the tree node this iterator points to.
+		 */
+		value_type* operator->() const noexcept
+		{
+			return &this->operator*();
+		}
+
+		/**
+		 * @brief Get iterator depth.
+		 * Depth of one means that the iterator points to one of the root nodes.
+		 * And so on.
+		 * @return number depth of the tree node the iterator points to.
+		 */
+		size_t depth() const noexcept
+		{
+			ASSERT(!this->is_end())
+			return this->queue->entries[this->pos].depth;
+		}
+	};
+
+public:
+	/**
+	 * @brief Iterator type.
+	 * The iterator performs the level-order traversal of the tree.
+	 */
+	using iterator = iterator_internal<std::is_const_v<collection_type>>;
+
+	/**
+	 * @brief Constant iterator type.
+	 * The iterator performs the level-order traversal of the tree.
+	 */
+	using const_iterator = iterator_internal<true>;
+
+	/**
+	 * @brief Start level-order traversal.
+	 * Invalidates all iterators previously obtained by non-constant begin().
+	 * @return Iterator pointing to the first root tree node.
+	 */
+	iterator begin()
+	{
+		this->queue.restart(this->roots);
+		return iterator(this->queue);
+	}
+
+	/**
+	 * @brief Start constant level-order traversal.
+	 * Same as cbegin().
+	 * @return Constant iterator pointing to the first root tree node.
+	 */
+	const_iterator begin() const
+	{
+		return this->cbegin();
+	}
+
+	/**
+	 * @brief Start constant level-order traversal.
+	 * The returned iterator has its own queue of tree nodes to visit, so it does not invalidate any iterators.
+	 * @return Constant iterator pointing to the first root tree node.
+	 */
+	const_iterator cbegin() const
+	{
+		auto q = std::make_shared<queue_type>();
+		q->restart(this->roots);
+		return const_iterator(std::move(q));
+	}
+
+	/**
+	 * @brief Get iterator pointing to the end of the tree hierarchy.
+	 * @return Iterator pointing to the end of the tree hierarchy.
+	 */
+	iterator end()
+	{
+		return iterator();
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the end of the tree hierarchy.
+	 * @return constant iterator pointing to the end of the tree hierarchy.
+	 */
+	const_iterator end() const
+	{
+		return this->cend();
+	}
+
+	/**
+	 * @brief Get constant iterator pointing to the end of the tree hierarchy.
+	 * @return constant iterator pointing to the end of the tree hierarchy.
+	 */
+	const_iterator cend() const
+	{
+		return const_iterator();
+	}
+};
+
+/**
+ * @brief Construct level-order traversal object out given list of tree nodes.
+ * This is a helper method for automatic template arguments resolution when creating traversal object.
+ * @param trees - list of tree nodes to make traversal object around.
+ * @return Level-order traversal object.
+ */
+template <class container_type>
+level_order_traversal<container_type> make_level_order_traversal(container_type& trees)
+{
+	return level_order_traversal<container_type>(trees);
+}
+
 } // namespace utki
@@ -278,4 +278,27 @@ struct is_scoped_enum<enum_type, true> :
 template <typename enum_type>
 constexpr bool is_scoped_enum_v = is_scoped_enum<enum_type>::value;
 
+/**
+ * @brief Get types of pointer to data member.
+ * Defines 'object_type' which is the class the member belongs to and 'value_type' which is the member type.
+ *
+ * Example:
+ * @code
+ * struct a{ int b; };
+ *
+ * static_assert(std::is_same_v<member_pointer_traits<decltype(&a::b)>::object_type, a>)
+ * static_assert(std::is_same_v<member_pointer_traits<decltype(&a::b)>::value_type, int>)
+ * @endcode
+ *
+ * @tparam member_pointer_type - pointer to data member type.
+ */
+template <typename member_pointer_type>
+struct member_pointer_traits;
+
+template <typename class_type, typename member_type>
+struct member_pointer_traits<member_type class_type::*> {
+	using object_type = class_type;
+	using value_type = member_type;
+};
+
 } // namespace utki
@@ -28,11 +28,126 @@ SOFTWARE.
 
 #include "unicode.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "cpu.hpp"
 #include "debug.hpp"
+#include "math.hpp"
+#include "string.hpp"
 #include "utility.hpp"
 
+#if defined(UTKI_SIMD_X86)
+#	include <immintrin.h>
+#endif
+
 using namespace utki;
 
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+constexpr char32_t replacement_character = 0xfffd;
+
+bool is_continuation_byte(uint8_t b) noexcept
+{
+	return (b & 0xc0) == 0x80;
+}
+
+// Returns size of the UTF-8 sequence starting at p if it is valid according to RFC 3629,
+// i.e. no overlong encodings, no surrogates, no code points above 0x10ffff. Returns 0 if the sequence is malformed.
+// The end can be nullptr for null-terminated strings, the terminating zero is never accepted as a continuation byte.
+size_t valid_utf8_sequence_size(const uint8_t* p, const uint8_t* end) noexcept
+{
+	uint8_t b = *p;
+
+	if (b < 0x80) {
+		return 1;
+	}
+
+	size_t size = 0;
+	// valid range of the second byte, the rest of the bytes are always 0x80-0xbf
+	uint8_t min = 0x80;
+	uint8_t max = 0xbf;
+
+	if (b >= 0xc2 && b <= 0xdf) {
+		size = 2;
+	} else if (b >= 0xe0 && b <= 0xef) {
+		size = 3;
+		if (b == 0xe0) {
+			// overlong
+			min = 0xa0;
+		} else if (b == 0xed) {
+			// surrogates
+			max = 0x9f;
+		}
+	} else if (b >= 0xf0 && b <= 0xf4) {
+		size = 4;
+		if (b == 0xf0) {
+			// overlong
+			min = 0x90;
+		} else if (b == 0xf4) {
+			// above 0x10ffff
+			max = 0x8f;
+		}
+	} else {
+		return 0;
+	}
+
+	if (p + 1 == end || p[1] < min || p[1] > max) {
+		return 0;
+	}
+
+	for (size_t i = 2; i != size; ++i) {
+		if (p + i == end || !is_continuation_byte(p[i])) {
+			return 0;
+		}
+	}
+
+	return size;
+}
+
+// Validates UTF-8 according to RFC 3629.
+// Returns pointer to the first byte of the first malformed sequence or end pointer if the string is valid.
+const uint8_t* validate_utf8_scalar(const uint8_t* p, const uint8_t* end) noexcept
+{
+	while (p != end) {
+		auto size = valid_utf8_sequence_size(p, end);
+		if (size == 0) {
+			return p;
+		}
+		p += size;
+	}
+	return end;
+}
+
+// Decodes one code point from valid UTF-8 string.
+char32_t decode_utf8_valid(const uint8_t*& p) noexcept
+{
+	uint8_t b = *p;
+
+	if (b < 0x80) {
+		++p;
+		return b;
+	} else if (b < 0xe0) {
+		char32_t c = (char32_t(b & 0x1f) << 6) | (p[1] & 0x3f);
+		p += 2;
+		return c;
+	} else if (b < 0xf0) {
+		char32_t c = (char32_t(b & 0x0f) << 12) | (char32_t(p[1] & 0x3f) << 6) | (p[2] & 0x3f);
+		p += 3;
+		return c;
+	}
+
+	char32_t c = (char32_t(b & 0x07) << 18) | (char32_t(p[1] & 0x3f) << 12) | (char32_t(p[2] & 0x3f) << 6) |
+		(p[3] & 0x3f);
+	p += 4;
+	return c;
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+} // namespace
+
 utf8_iterator::utf8_iterator(utki::span<const uint8_t> str) :
 	p(str.data()),
 	end(utki::end_pointer(str))
@@ -49,8 +164,6 @@ utf8_iterator::utf8_iterator(const char* str) :
 	this->operator++();
 }
 
-// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
-
 utf8_iterator& utf8_iterator::operator++() noexcept
 {
 	if (this->p == this->end) {
@@ -58,157 +171,1830 @@ utf8_iterator& utf8_iterator::operator++() noexcept
 		return *this;
 	}
 
-	uint8_t b = *this->p;
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-	++this->p;
-
-	if ((b & 0x80) == 0) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		this->c = char32_t(b);
+	if (valid_utf8_sequence_size(this->p, this->end) == 0) {
+		// every byte which is not a part of a valid sequence is a separate malformed character
+		this->c = replacement_character;
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++this->p;
 		return *this;
 	}
 
-	if (this->p == this->end) {
+	this->c = decode_utf8_valid(this->p);
+	return *this;
+}
+
+utf8_reverse_iterator::utf8_reverse_iterator(utki::span<const uint8_t> str) :
+	begin(str.data()),
+	p(utki::end_pointer(str))
+{
+	this->operator++();
+}
+
+utf8_reverse_iterator& utf8_reverse_iterator::operator++() noexcept
+{
+	if (this->p == this->begin) {
 		this->c = 0;
 		return *this;
 	}
 
-	this->c = (*this->p) & 0x3f; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-	++this->p;
+	const uint8_t* end = this->p;
 
-	unsigned i = 2;
-	for (; //
-		 (uint8_t(b << i) >> 7); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		 ++i,
-		 // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-		 ++this->p)
-	{
-		if (this->p == this->end) {
-			this->c = 0;
-			return *this;
-		}
+	// find the first byte of the character, valid sequence has at most 3 continuation bytes
+	// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const uint8_t* first = end - 1;
+	for (unsigned i = 0; i != 3 && first != this->begin && is_continuation_byte(*first); ++i) {
+		--first;
+	}
 
-		this->c <<= 6; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		this->c |= (*this->p) & 0x3f; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+	if (valid_utf8_sequence_size(first, end) != size_t(end - first)) {
+		// same as for utf8_iterator, every byte which is not a part of a valid sequence
+		// is a separate malformed character
+		this->p = end - 1;
+		this->c = replacement_character;
+		return *this;
 	}
-	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
-	this->c |= (char32_t(uint8_t(b << (i + 1)) >> (i + 1)) << (6 * (i - 1)));
+	// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
+	this->p = first;
+	this->c = decode_utf8_valid(first);
 	return *this;
 }
 
-std::array<char, max_size_of_utf8_encoded_character + 1> //
-utki::to_utf8(char32_t c)
+std::u32string utki::to_utf32(utf8_iterator str)
+{
+	std::u32string ret;
+	for (; !str.is_end(); ++str) {
+		ret.push_back(str.character());
+	}
+	return ret;
+}
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+size_t count_code_points_scalar(const uint8_t* p, const uint8_t* end) noexcept
 {
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-	std::array<char, 7> ret; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+	size_t ret = 0;
+	for (; p != end; ++p) {
+		if (!is_continuation_byte(*p)) {
+			++ret;
+		}
+	}
+	return ret;
+}
 
-	if (c <= 0x7f) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		ret[0] = char(c); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		ret[1] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		return ret;
+// Samples byte offsets of every stride-th code point of the [p, end) part of the string.
+// The offsets are relative to the string begin.
+// The until_sample is the number of code points to skip before taking the next sample.
+// Returns number of code points in the [p, end) part of the string.
+size_t sample_code_points_scalar(
+	const uint8_t* begin, //
+	const uint8_t* p,
+	const uint8_t* end,
+	size_t stride,
+	size_t until_sample,
+	std::vector<size_t>& samples
+)
+{
+	size_t ret = 0;
+	for (; p != end; ++p) {
+		if (is_continuation_byte(*p)) {
+			continue;
+		}
+		if (until_sample == 0) {
+			samples.push_back(size_t(p - begin));
+			until_sample = stride;
+		}
+		--until_sample;
+		++ret;
 	}
+	return ret;
+}
 
-	// NOLINTNEXTLINE(cppcoreguidelines-init-variables)
-	unsigned num_bytes;
+size_t sample_code_points_scalar(
+	const uint8_t* begin, //
+	const uint8_t* end,
+	size_t stride,
+	std::vector<size_t>& samples
+)
+{
+	return sample_code_points_scalar(begin, begin, end, stride, 0, samples);
+}
 
-	if (c <= 0x7ff) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		num_bytes = 2; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-	} else if (c <= 0xffff) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		num_bytes = 3; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-	} else if (c <= 0x1fffff) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		num_bytes = 4; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-	} else if (c <= 0x3ffffff) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		num_bytes = 5; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-	} else if (c <= 0x7fffffff) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		num_bytes = 6; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-	} else {
-		ret[0] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-		return ret;
+// Returns pointer to the first byte of the n-th code point starting from p, counting from 0,
+// or end pointer if there are not that many code points.
+const uint8_t* find_code_point_scalar(const uint8_t* p, const uint8_t* end, size_t n) noexcept
+{
+	for (; p != end; ++p) {
+		if (is_continuation_byte(*p)) {
+			continue;
+		}
+		if (n == 0) {
+			return p;
+		}
+		--n;
+	}
+	return end;
+}
+
+// Converts valid UTF-8 string to UTF-32, returns pointer to the end of the output.
+char32_t* utf8_to_utf32_scalar(const uint8_t* p, const uint8_t* end, char32_t* out) noexcept
+{
+	while (p != end) {
+		*out = decode_utf8_valid(p);
+		++out;
+	}
+	return out;
+}
+
+// Returns size of UTF-8 representation of the character.
+// Zero character and characters above 0x7fffffff have no UTF-8 representation.
+size_t utf8_sequence_size(char32_t c) noexcept
+{
+	if (c == 0 || c > 0x7fffffff) {
+		return 0;
+	}
+	return 1 + size_t(c > 0x7f) + size_t(c > 0x7ff) + size_t(c > 0xffff) + size_t(c > 0x1fffff) +
+		size_t(c > 0x3ffffff);
+}
+
+size_t utf8_encoded_size_scalar(const char32_t* p, const char32_t* end) noexcept
+{
+	size_t ret = 0;
+	for (; p != end; ++p) {
+		ret += utf8_sequence_size(*p);
 	}
+	return ret;
+}
+
+// Encodes one character to UTF-8, returns pointer to the end of the written sequence.
+char* encode_utf8(char32_t c, char* out) noexcept
+{
+	auto size = utf8_sequence_size(c);
 
-	switch (num_bytes) {
+	switch (size) {
+		case 0:
+			return out;
+		case 1:
+			*out = char(c);
+			return out + 1;
 		default:
-		case 1: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ASSERT(false)
-			break;
-		case 2: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			// 0xc0 = 0b11000000
-			ret[0] = char(0xc0 | ((c >> 6) & 0x1f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[1] = char(0x80 | (c & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[2] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
 			break;
-		case 3: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			// 0xe0 = 0b11100000
-			ret[0] = char(0xe0 | ((c >> 12) & 0xf)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[1] = char(0x80 | ((c >> 6) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[2] = char(0x80 | (c & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[3] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			break;
-		case 4: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			// 0xf0 = 0b11110000
-			ret[0] = char(0xf0 | ((c >> 18) & 0x7)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[1] = char(0x80 | ((c >> 12) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[2] = char(0x80 | ((c >> 6) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[3] = char(0x80 | (c & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[4] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+	}
+
+	for (size_t i = size - 1; i != 0; --i) {
+		out[i] = char(0x80 | (c & 0x3f));
+		c >>= 6;
+	}
+
+	// lead byte has as many high bits set as there are bytes in the sequence
+	out[0] = char((0xff00 >> size) | c);
+
+	return out + size;
+}
+
+// Converts UTF-32 string to UTF-8, returns pointer to the end of the output.
+char* utf32_to_utf8_scalar(const char32_t* p, const char32_t* end, char* out) noexcept
+{
+	for (; p != end; ++p) {
+		out = encode_utf8(*p, out);
+	}
+	return out;
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+// Moves pointer back to the beginning of the UTF-8 sequence which is not complete before the pointer.
+// The bytes before the pointer are known to be a valid UTF-8 string, except the last sequence which can be incomplete.
+// The sequence is at most 4 bytes long, so its lead byte is at most 3 bytes back.
+const uint8_t* rewind_to_sequence_start(const uint8_t* begin, const uint8_t* p) noexcept
+{
+	constexpr auto max_continuation_bytes = 3;
+	auto q = p;
+	for (unsigned i = 0; i != max_continuation_bytes && q != begin; ++i) {
+		q = std::prev(q);
+		if (*q < 0x80) { // NOLINT(cppcoreguidelines-avoid-magic-numbers)
 			break;
-		case 5: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			// 0xf8 = 0b11111000
-			ret[0] = char(0xf8 | ((c >> 24) & 0x3)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[1] = char(0x80 | ((c >> 18) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[2] = char(0x80 | ((c >> 12) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[3] = char(0x80 | ((c >> 6) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[4] = char(0x80 | (c & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[5] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+		}
+		if (!is_continuation_byte(*q)) {
+			return q;
+		}
+	}
+	return p;
+}
+
+#if defined(UTKI_SIMD_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, hicpp-signed-bitwise)
+
+// The SIMD UTF-8 validation uses the lookup algorithm by John Keiser and Daniel Lemire,
+// see "Validating UTF-8 In Less Than One Instruction Per Byte", https://arxiv.org/abs/2010.03090
+
+// error flags
+constexpr uint8_t too_short = 1 << 0;
+constexpr uint8_t too_long = 1 << 1;
+constexpr uint8_t overlong_3 = 1 << 2;
+constexpr uint8_t too_large = 1 << 3;
+constexpr uint8_t surrogate = 1 << 4;
+constexpr uint8_t overlong_2 = 1 << 5;
+constexpr uint8_t too_large_1000 = 1 << 6;
+constexpr uint8_t overlong_4 = 1 << 6;
+constexpr uint8_t two_conts = 1 << 7;
+constexpr uint8_t carry = too_short | too_long | two_conts;
+
+// error flags indexed by high nibble of the first byte of the byte pair
+constexpr std::array<uint8_t, 16> byte_1_high_table = {
+	too_long,
+	too_long,
+	too_long,
+	too_long,
+	too_long,
+	too_long,
+	too_long,
+	too_long,
+	two_conts,
+	two_conts,
+	two_conts,
+	two_conts,
+	too_short | overlong_2,
+	too_short,
+	too_short | overlong_3 | surrogate,
+	too_short | too_large | too_large_1000 | overlong_4
+};
+
+// error flags indexed by low nibble of the first byte of the byte pair
+constexpr std::array<uint8_t, 16> byte_1_low_table = {
+	carry | overlong_3 | overlong_2 | overlong_4,
+	carry | overlong_2,
+	carry,
+	carry,
+	carry | too_large,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000 | surrogate,
+	carry | too_large | too_large_1000,
+	carry | too_large | too_large_1000
+};
+
+// error flags indexed by high nibble of the second byte of the byte pair
+constexpr std::array<uint8_t, 16> byte_2_high_table = {
+	too_short,
+	too_short,
+	too_short,
+	too_short,
+	too_short,
+	too_short,
+	too_short,
+	too_short,
+	too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+	too_long | overlong_2 | two_conts | overlong_3 | too_large,
+	too_long | overlong_2 | two_conts | surrogate | too_large,
+	too_long | overlong_2 | two_conts | surrogate | too_large,
+	too_short,
+	too_short,
+	too_short,
+	too_short
+};
+
+UTKI_TARGET("ssse3")
+__m128i load_table_sse(const std::array<uint8_t, 16>& table) noexcept
+{
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data()));
+}
+
+// Returns non-zero vector if the block contains errors.
+// Sequences which are not complete within the block are not checked, those are checked with the next block.
+UTKI_TARGET("ssse3")
+__m128i check_utf8_block_sse(__m128i input, __m128i prev_input) noexcept
+{
+	const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+
+	__m128i prev1 = _mm_alignr_epi8(input, prev_input, 16 - 1);
+
+	__m128i byte_1_high = _mm_shuffle_epi8(
+		load_table_sse(byte_1_high_table), //
+		_mm_and_si128(_mm_srli_epi16(prev1, 4), nibble_mask)
+	);
+	__m128i byte_1_low = _mm_shuffle_epi8(load_table_sse(byte_1_low_table), _mm_and_si128(prev1, nibble_mask));
+	__m128i byte_2_high = _mm_shuffle_epi8(
+		load_table_sse(byte_2_high_table), //
+		_mm_and_si128(_mm_srli_epi16(input, 4), nibble_mask)
+	);
+
+	__m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+	__m128i prev2 = _mm_alignr_epi8(input, prev_input, 16 - 2);
+	__m128i prev3 = _mm_alignr_epi8(input, prev_input, 16 - 3);
+
+	// third and fourth bytes of 3 and 4 byte sequences must be continuation bytes
+	__m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80)));
+	__m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80)));
+	__m128i must_be_2_3_continuation = _mm_and_si128(
+		_mm_or_si128(is_third_byte, is_fourth_byte), //
+		_mm_set1_epi8(char(0x80))
+	);
+
+	return _mm_xor_si128(must_be_2_3_continuation, special_cases);
+}
+
+UTKI_TARGET("ssse3")
+const uint8_t* validate_utf8_ssse3(const uint8_t* begin, const uint8_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i);
+
+	const uint8_t* p = begin;
+	__m128i prev_input = _mm_setzero_si128();
+
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		__m128i error = check_utf8_block_sse(input, prev_input);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xffff) {
 			break;
-		case 6: // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			// 0xfc = 0b11111100
-			ret[0] = char(0xfc | ((c >> 30) & 0x1)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[1] = char(0x80 | ((c >> 24) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[2] = char(0x80 | ((c >> 18) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[3] = char(0x80 | ((c >> 12) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[4] = char(0x80 | ((c >> 6) & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[5] = char(0x80 | (c & 0x3f)); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
-			ret[6] = 0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+		}
+
+		prev_input = input;
+	}
+
+	// sequences not complete within the last checked block, the tail and the block with errors are checked by
+	// the scalar validation
+	return validate_utf8_scalar(rewind_to_sequence_start(begin, p), end);
+}
+
+UTKI_TARGET("avx2")
+__m256i load_table_avx2(const std::array<uint8_t, 16>& table) noexcept
+{
+	return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+}
+
+UTKI_TARGET("avx2")
+const uint8_t* validate_utf8_avx2(const uint8_t* begin, const uint8_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m256i);
+
+	const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+	const __m256i byte_1_high_lut = load_table_avx2(byte_1_high_table);
+	const __m256i byte_1_low_lut = load_table_avx2(byte_1_low_table);
+	const __m256i byte_2_high_lut = load_table_avx2(byte_2_high_table);
+
+	const uint8_t* p = begin;
+	__m256i prev_input = _mm256_setzero_si256();
+
+	for (; size_t(end - p) >= step; p += step) {
+		__m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+
+		// bytes of the previous block's high lane followed by bytes of the input's low lane
+		__m256i shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+
+		__m256i prev1 = _mm256_alignr_epi8(input, shifted, 16 - 1);
+
+		__m256i byte_1_high = _mm256_shuffle_epi8(
+			byte_1_high_lut, //
+			_mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble_mask)
+		);
+		__m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_lut, _mm256_and_si256(prev1, nibble_mask));
+		__m256i byte_2_high = _mm256_shuffle_epi8(
+			byte_2_high_lut, //
+			_mm256_and_si256(_mm256_srli_epi16(input, 4), nibble_mask)
+		);
+
+		__m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+		__m256i prev2 = _mm256_alignr_epi8(input, shifted, 16 - 2);
+		__m256i prev3 = _mm256_alignr_epi8(input, shifted, 16 - 3);
+
+		__m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+		__m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+		__m256i must_be_2_3_continuation = _mm256_and_si256(
+			_mm256_or_si256(is_third_byte, is_fourth_byte), //
+			_mm256_set1_epi8(char(0x80))
+		);
+
+		__m256i error = _mm256_xor_si256(must_be_2_3_continuation, special_cases);
+		if (!_mm256_testz_si256(error, error)) {
 			break;
+		}
+
+		prev_input = input;
 	}
 
-	return ret;
+	return validate_utf8_ssse3(rewind_to_sequence_start(begin, p), end);
 }
 
-// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+UTKI_TARGET("sse2")
+size_t count_code_points_sse2(const uint8_t* p, const uint8_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i);
+
+	// continuation bytes are 0x80-0xbf, i.e. -128...-65 as signed bytes
+	const __m128i max_continuation = _mm_set1_epi8(-65);
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i zero = _mm_setzero_si128();
 
-std::string utki::to_utf8(utki::span<const char32_t> str)
+	// two 64-bit counters
+	__m128i counters = _mm_setzero_si128();
+
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i is_not_continuation = _mm_and_si128(_mm_cmpgt_epi8(v, max_continuation), one);
+		counters = _mm_add_epi64(counters, _mm_sad_epu8(is_not_continuation, zero));
+	}
+
+	std::array<uint64_t, 2> counts{};
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+	return size_t(counts[0] + counts[1]) + count_code_points_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+size_t sample_code_points_sse2(
+	const uint8_t* begin, //
+	const uint8_t* end,
+	size_t stride,
+	std::vector<size_t>& samples
+)
 {
-	std::stringstream ss;
+	constexpr auto step = sizeof(__m128i);
+
+	// continuation bytes are 0x80-0xbf, i.e. -128...-65 as signed bytes
+	const __m128i max_continuation = _mm_set1_epi8(-65);
+
+	size_t ret = 0;
+
+	// number of code points to skip before taking the next sample
+	size_t until_sample = 0;
+
+	const uint8_t* p = begin;
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		// bit mask of the first bytes of code points
+		auto mask = unsigned(_mm_movemask_epi8(_mm_cmpgt_epi8(v, max_continuation)));
+
+		auto n = size_t(utki::popcount(mask));
+		ret += n;
 
-	for (auto c : str) {
-		auto buf = to_utf8(c);
-		ss << buf.data();
+		// take the samples which fall into the block
+		while (until_sample < n) {
+			// drop the code points to skip, then the sample is the lowest set bit
+			for (size_t i = 0; i != until_sample; ++i) {
+				mask &= mask - 1;
+			}
+			samples.push_back(size_t(p - begin) + size_t(utki::countr_zero(mask)));
+			mask &= mask - 1;
+
+			n -= until_sample + 1;
+			until_sample = stride - 1;
+		}
+		until_sample -= n;
 	}
 
-	return ss.str();
+	return ret + sample_code_points_scalar(begin, p, end, stride, until_sample, samples);
 }
 
-std::u32string utki::to_utf32(utf8_iterator str)
+UTKI_TARGET("sse2")
+const uint8_t* find_code_point_sse2(const uint8_t* p, const uint8_t* end, size_t n) noexcept
 {
-	std::vector<char32_t> buf;
-	for (; !str.is_end(); ++str) {
-		buf.push_back(str.character());
+	constexpr auto step = sizeof(__m128i);
+
+	const __m128i max_continuation = _mm_set1_epi8(-65);
+
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		auto mask = unsigned(_mm_movemask_epi8(_mm_cmpgt_epi8(v, max_continuation)));
+
+		auto num_in_block = size_t(utki::popcount(mask));
+		if (n < num_in_block) {
+			for (; n != 0; --n) {
+				mask &= mask - 1;
+			}
+			return p + utki::countr_zero(mask);
+		}
+		n -= num_in_block;
 	}
-	return std::u32string{buf.begin(), buf.end()};
+
+	return find_code_point_scalar(p, end, n);
 }
 
-std::u32string utki::to_utf32(utki::span<const uint8_t> str)
+UTKI_TARGET("sse2")
+char32_t* utf8_to_utf32_sse2(const uint8_t* p, const uint8_t* end, char32_t* out) noexcept
+{
+	constexpr auto step = sizeof(__m128i);
+
+	const __m128i zero = _mm_setzero_si128();
+
+	while (size_t(end - p) >= step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		if (_mm_movemask_epi8(v) == 0) {
+			// all 16 characters are ASCII
+			__m128i lo = _mm_unpacklo_epi8(v, zero);
+			__m128i hi = _mm_unpackhi_epi8(v, zero);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+			p += step;
+			out += step;
+			continue;
+		}
+
+		// decode the characters of the block one by one, the last one can go beyond the block
+		for (auto block_end = p + step; p < block_end; ++out) {
+			*out = decode_utf8_valid(p);
+		}
+	}
+
+	return utf8_to_utf32_scalar(p, end, out);
+}
+
+UTKI_TARGET("avx2")
+char32_t* utf8_to_utf32_avx2(const uint8_t* p, const uint8_t* end, char32_t* out) noexcept
+{
+	constexpr auto step = sizeof(__m256i);
+
+	while (size_t(end - p) >= step) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+
+		if (_mm256_movemask_epi8(v) == 0) {
+			// all 32 characters are ASCII
+			for (size_t i = 0; i != step; i += 8) {
+				_mm256_storeu_si256(
+					reinterpret_cast<__m256i*>(out + i),
+					_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + i)))
+				);
+			}
+			p += step;
+			out += step;
+			continue;
+		}
+
+		for (auto block_end = p + step; p < block_end; ++out) {
+			*out = decode_utf8_valid(p);
+		}
+	}
+
+	return utf8_to_utf32_sse2(p, end, out);
+}
+
+UTKI_TARGET("sse2")
+size_t utf8_encoded_size_sse2(const char32_t* p, const char32_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char32_t);
+
+	// the counters grow by at most 6 per iteration, so those are flushed before they can overflow
+	constexpr size_t max_iterations = 0x10000;
+
+	const __m128i zero = _mm_setzero_si128();
+
+	size_t ret = 0;
+	while (size_t(end - p) >= step) {
+		__m128i counters = _mm_setzero_si128();
+
+		for (size_t i = 0; i != max_iterations && size_t(end - p) >= step; ++i, p += step) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			// Comparison gives -1 for true, so subtracting the comparison results counts the bytes.
+			// Characters above 0x7fffffff are negative as signed integers, so all comparisons give false for those,
+			// same as for zero character.
+			__m128i sum = _mm_add_epi32(
+				_mm_add_epi32(_mm_cmpgt_epi32(v, zero), _mm_cmpgt_epi32(v, _mm_set1_epi32(0x7f))),
+				_mm_add_epi32(_mm_cmpgt_epi32(v, _mm_set1_epi32(0x7ff)), _mm_cmpgt_epi32(v, _mm_set1_epi32(0xffff)))
+			);
+			sum = _mm_add_epi32(
+				sum, //
+				_mm_add_epi32(
+					_mm_cmpgt_epi32(v, _mm_set1_epi32(0x1fffff)), //
+					_mm_cmpgt_epi32(v, _mm_set1_epi32(0x3ffffff))
+				)
+			);
+			counters = _mm_sub_epi32(counters, sum);
+		}
+
+		std::array<uint32_t, step> counts{};
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+		for (auto c : counts) {
+			ret += c;
+		}
+	}
+
+	return ret + utf8_encoded_size_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+char* utf32_to_utf8_sse2(const char32_t* p, const char32_t* end, char* out) noexcept
+{
+	constexpr auto step = 2 * sizeof(__m128i) / sizeof(char32_t);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ascii_end = _mm_set1_epi32(0x80);
+
+	while (size_t(end - p) >= step) {
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + step / 2));
+
+		// ASCII characters are 0x01-0x7f, zero character is not encoded
+		__m128i is_ascii = _mm_and_si128(
+			_mm_and_si128(_mm_cmpgt_epi32(lo, zero), _mm_cmplt_epi32(lo, ascii_end)),
+			_mm_and_si128(_mm_cmpgt_epi32(hi, zero), _mm_cmplt_epi32(hi, ascii_end))
+		);
+
+		if (_mm_movemask_epi8(is_ascii) == 0xffff) {
+			// all 8 characters are ASCII
+			__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(lo, hi), zero);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+			p += step;
+			out += step;
+			continue;
+		}
+
+		for (auto block_end = p + step; p != block_end; ++p) {
+			out = encode_utf8(*p, out);
+		}
+	}
+
+	return utf32_to_utf8_scalar(p, end, out);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, hicpp-signed-bitwise)
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+
+#endif // ~UTKI_SIMD_X86
+
+struct utf8_functions {
+	decltype(&validate_utf8_scalar) validate = &validate_utf8_scalar;
+	decltype(&count_code_points_scalar) count_code_points = &count_code_points_scalar;
+	size_t (*sample_code_points)(const uint8_t*, const uint8_t*, size_t, std::vector<size_t>&) =
+		&sample_code_points_scalar;
+	decltype(&find_code_point_scalar) find_code_point = &find_code_point_scalar;
+	decltype(&utf8_to_utf32_scalar) to_utf32 = &utf8_to_utf32_scalar;
+	decltype(&utf8_encoded_size_scalar) encoded_size = &utf8_encoded_size_scalar;
+	decltype(&utf32_to_utf8_scalar) from_utf32 = &utf32_to_utf8_scalar;
+};
+
+utf8_functions select_utf8_functions() noexcept
+{
+	utf8_functions ret;
+#if defined(UTKI_SIMD_X86)
+	const auto& features = utki::get_cpu_features();
+	if (features.sse2) {
+		ret.count_code_points = &count_code_points_sse2;
+		ret.sample_code_points = &sample_code_points_sse2;
+		ret.find_code_point = &find_code_point_sse2;
+		ret.to_utf32 = &utf8_to_utf32_sse2;
+		ret.encoded_size = &utf8_encoded_size_sse2;
+		ret.from_utf32 = &utf32_to_utf8_sse2;
+	}
+	if (features.ssse3) {
+		ret.validate = &validate_utf8_ssse3;
+	}
+	if (features.avx2) {
+		ret.validate = &validate_utf8_avx2;
+		ret.to_utf32 = &utf8_to_utf32_avx2;
+	}
+#endif
+	return ret;
+}
+
+const utf8_functions& get_utf8_functions() noexcept
 {
-	utf8_iterator iter(str);
+	static const auto functions = select_utf8_functions();
+	return functions;
+}
+
+const uint8_t* to_uint8_t_pointer(const char* p) noexcept
+{
+	static_assert(sizeof(char) == sizeof(uint8_t), "unexpected char size");
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+	return reinterpret_cast<const uint8_t*>(p);
+}
+} // namespace
 
-	std::vector<char32_t> buf;
+size_t utki::find_invalid_utf8(std::string_view str) noexcept
+{
+	auto begin = to_uint8_t_pointer(str.data());
+	auto end = to_uint8_t_pointer(utki::end_pointer(str));
 
-	for (; !iter.is_end(); ++iter) {
-		buf.push_back(iter.character());
+	auto p = get_utf8_functions().validate(begin, end);
+	if (p == end) {
+		return std::string_view::npos;
 	}
+	return size_t(p - begin);
+}
 
-	return std::u32string{buf.begin(), buf.end()};
+size_t utki::utf8_length(std::string_view str) noexcept
+{
+	return get_utf8_functions().count_code_points(
+		to_uint8_t_pointer(str.data()), //
+		to_uint8_t_pointer(utki::end_pointer(str))
+	);
 }
+
+std::string_view utki::utf8_truncate(std::string_view str, size_t max_code_points) noexcept
+{
+	auto begin = to_uint8_t_pointer(str.data());
+
+	auto p = get_utf8_functions().find_code_point(
+		begin, //
+		to_uint8_t_pointer(utki::end_pointer(str)),
+		max_code_points
+	);
+
+	return str.substr(0, size_t(p - begin));
+}
+
+utf_conversion_result utki::to_utf32(std::string_view str, utki::span<char32_t> out) noexcept
+{
+	const auto& functions = get_utf8_functions();
+
+	auto invalid_pos = find_invalid_utf8(str);
+
+	// the valid part of the string
+	auto valid = str.substr(0, invalid_pos);
+
+	auto begin = to_uint8_t_pointer(valid.data());
+	auto end = to_uint8_t_pointer(utki::end_pointer(valid));
+
+	auto size = functions.count_code_points(begin, end);
+	if (out.size() < size) {
+		return {0, 0, std::errc::value_too_large};
+	}
+
+	auto out_end = functions.to_utf32(begin, end, out.data());
+
+	auto num_written = size_t(out_end - out.data());
+	ASSERT(num_written == size)
+
+	if (invalid_pos != std::string_view::npos) {
+		return {num_written, invalid_pos, std::errc::illegal_byte_sequence};
+	}
+
+	return {num_written, str.size(), std::errc()};
+}
+
+std::u32string utki::to_utf32(utki::span<const uint8_t> str)
+{
+	// for compatibility with utf8_iterator, the string ends at first zero character
+	auto zero_pos = utki::find_char(utki::make_string_view(str), '\0');
+	if (zero_pos != std::string_view::npos) {
+		str = str.subspan(0, zero_pos);
+	}
+
+	auto begin = str.data();
+	auto end = utki::end_pointer(str);
+
+	const auto& functions = get_utf8_functions();
+
+	if (functions.validate(begin, end) != end) {
+		// malformed UTF-8, decode it with replacement characters
+		return to_utf32(utf8_iterator(str));
+	}
+
+	std::u32string ret(functions.count_code_points(begin, end), U'\0');
+
+	[[maybe_unused]] auto out_end = functions.to_utf32(begin, end, ret.data());
+	ASSERT(out_end == utki::end_pointer(ret))
+
+	return ret;
+}
+
+std::array<char, max_size_of_utf8_encoded_character + 1> //
+utki::to_utf8(char32_t c)
+{
+	std::array<char, max_size_of_utf8_encoded_character + 1> ret{};
+	encode_utf8(c, ret.data());
+	return ret;
+}
+
+size_t utki::utf8_encoded_size(utki::span<const char32_t> str) noexcept
+{
+	return get_utf8_functions().encoded_size(str.data(), utki::end_pointer(str));
+}
+
+std::string utki::to_utf8(utki::span<const char32_t> str)
+{
+	std::string ret;
+	append_utf8(ret, str);
+	return ret;
+}
+
+void utki::append_utf8(std::string& out, utki::span<const char32_t> str)
+{
+	const auto& functions = get_utf8_functions();
+
+	auto begin = str.data();
+	auto end = utki::end_pointer(str);
+
+	auto old_size = out.size();
+	out.resize(old_size + functions.encoded_size(begin, end));
+
+	[[maybe_unused]] auto out_end = functions.from_utf32(begin, end, std::next(out.data(), ptrdiff_t(old_size)));
+	ASSERT(out_end == utki::end_pointer(out))
+}
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+bool is_surrogate(char32_t c) noexcept
+{
+	return (c & 0xfffff800) == 0xd800;
+}
+
+bool is_high_surrogate(char32_t c) noexcept
+{
+	return (c & 0xfffffc00) == 0xd800;
+}
+
+bool is_low_surrogate(char32_t c) noexcept
+{
+	return (c & 0xfffffc00) == 0xdc00;
+}
+
+char32_t combine_surrogates(char32_t high, char32_t low) noexcept
+{
+	return 0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00);
+}
+
+// Returns pointer to the next UTF-16 sequence or nullptr if the sequence is malformed.
+const char16_t* skip_utf16_sequence(const char16_t* p, const char16_t* end) noexcept
+{
+	if (!is_surrogate(*p)) {
+		return p + 1;
+	}
+	if (is_high_surrogate(*p) && end - p >= 2 && is_low_surrogate(p[1])) {
+		return p + 2;
+	}
+	return nullptr;
+}
+
+// Returns pointer to the first unpaired surrogate or end pointer if the string is valid.
+const char16_t* validate_utf16_scalar(const char16_t* p, const char16_t* end) noexcept
+{
+	while (p != end) {
+		auto next = skip_utf16_sequence(p, end);
+		if (!next) {
+			return p;
+		}
+		p = next;
+	}
+	return end;
+}
+
+// Returns pointer to the first code point which is a surrogate or is above 0x10ffff,
+// or end pointer if the string is valid.
+const char32_t* validate_utf32_scalar(const char32_t* p, const char32_t* end) noexcept
+{
+	for (; p != end; ++p) {
+		if (*p > 0x10ffff || is_surrogate(*p)) {
+			return p;
+		}
+	}
+	return end;
+}
+
+// Decodes one code point from valid UTF-16 string.
+char32_t decode_utf16_valid(const char16_t*& p) noexcept
+{
+	char32_t u = *p;
+	++p;
+
+	if (is_high_surrogate(u)) {
+		char32_t c = combine_surrogates(u, *p);
+		++p;
+		return c;
+	}
+
+	return u;
+}
+
+// Encodes valid code point to UTF-16, returns pointer to the end of the written sequence.
+char16_t* encode_utf16(char32_t c, char16_t* out) noexcept
+{
+	if (c < 0x10000) {
+		*out = char16_t(c);
+		return out + 1;
+	}
+
+	c -= 0x10000;
+	out[0] = char16_t(0xd800 + (c >> 10));
+	out[1] = char16_t(0xdc00 + (c & 0x3ff));
+	return out + 2;
+}
+
+// Encodes valid code point to UTF-8, returns pointer to the end of the written sequence.
+// Unlike encode_utf8(), the zero character is encoded.
+char* encode_utf8_valid(char32_t c, char* out) noexcept
+{
+	if (c < 0x80) {
+		out[0] = char(c);
+		return out + 1;
+	} else if (c < 0x800) {
+		out[0] = char(0xc0 | (c >> 6));
+		out[1] = char(0x80 | (c & 0x3f));
+		return out + 2;
+	} else if (c < 0x10000) {
+		out[0] = char(0xe0 | (c >> 12));
+		out[1] = char(0x80 | ((c >> 6) & 0x3f));
+		out[2] = char(0x80 | (c & 0x3f));
+		return out + 3;
+	}
+
+	out[0] = char(0xf0 | (c >> 18));
+	out[1] = char(0x80 | ((c >> 12) & 0x3f));
+	out[2] = char(0x80 | ((c >> 6) & 0x3f));
+	out[3] = char(0x80 | (c & 0x3f));
+	return out + 4;
+}
+
+size_t count_utf16_code_points_scalar(const char16_t* p, const char16_t* end) noexcept
+{
+	size_t ret = 0;
+	for (; p != end; ++p) {
+		if (!is_low_surrogate(*p)) {
+			++ret;
+		}
+	}
+	return ret;
+}
+
+// Number of UTF-16 code units needed to represent valid UTF-8 string.
+size_t utf16_size_of_utf8_scalar(const uint8_t* p, const uint8_t* end) noexcept
+{
+	size_t ret = 0;
+	for (; p != end; ++p) {
+		// 4 byte sequences are represented by surrogate pairs
+		ret += size_t(!is_continuation_byte(*p)) + size_t(*p >= 0xf0);
+	}
+	return ret;
+}
+
+// Number of UTF-16 code units needed to represent valid UTF-32 string.
+size_t utf16_size_of_utf32_scalar(const char32_t* p, const char32_t* end) noexcept
+{
+	auto ret = size_t(end - p);
+	for (; p != end; ++p) {
+		ret += size_t(*p > 0xffff);
+	}
+	return ret;
+}
+
+// Number of UTF-8 bytes needed to represent valid UTF-32 string, zero characters included.
+size_t utf8_size_of_utf32_scalar(const char32_t* p, const char32_t* end) noexcept
+{
+	auto ret = size_t(end - p);
+	for (; p != end; ++p) {
+		ret += size_t(*p > 0x7f) + size_t(*p > 0x7ff) + size_t(*p > 0xffff);
+	}
+	return ret;
+}
+
+// Number of UTF-8 bytes needed to represent valid UTF-16 string.
+size_t utf8_size_of_utf16_scalar(const char16_t* p, const char16_t* end) noexcept
+{
+	size_t ret = 0;
+	for (; p != end; ++p) {
+		char16_t u = *p;
+		if (u < 0x80) {
+			ret += 1;
+		} else if (u < 0x800 || is_surrogate(u)) {
+			// surrogate pair is represented by 4 bytes, i.e. 2 bytes per surrogate
+			ret += 2;
+		} else {
+			ret += 3;
+		}
+	}
+	return ret;
+}
+
+char16_t* utf8_to_utf16_scalar(const uint8_t* p, const uint8_t* end, char16_t* out) noexcept
+{
+	while (p != end) {
+		out = encode_utf16(decode_utf8_valid(p), out);
+	}
+	return out;
+}
+
+char* utf16_to_utf8_scalar(const char16_t* p, const char16_t* end, char* out) noexcept
+{
+	while (p != end) {
+		out = encode_utf8_valid(decode_utf16_valid(p), out);
+	}
+	return out;
+}
+
+char32_t* utf16_to_utf32_scalar(const char16_t* p, const char16_t* end, char32_t* out) noexcept
+{
+	while (p != end) {
+		*out = decode_utf16_valid(p);
+		++out;
+	}
+	return out;
+}
+
+char16_t* utf32_to_utf16_scalar(const char32_t* p, const char32_t* end, char16_t* out) noexcept
+{
+	for (; p != end; ++p) {
+		out = encode_utf16(*p, out);
+	}
+	return out;
+}
+
+// Converts valid UTF-32 string to UTF-8, unlike utf32_to_utf8_scalar() zero characters are encoded.
+char* utf32_to_utf8_valid_scalar(const char32_t* p, const char32_t* end, char* out) noexcept
+{
+	for (; p != end; ++p) {
+		out = encode_utf8_valid(*p, out);
+	}
+	return out;
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+#if defined(UTKI_SIMD_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, hicpp-signed-bitwise)
+
+UTKI_TARGET("sse2")
+bool has_surrogates_sse2(__m128i v) noexcept
+{
+	__m128i is_surrogate = _mm_cmpeq_epi16(
+		_mm_and_si128(v, _mm_set1_epi16(short(0xf800))), //
+		_mm_set1_epi16(short(0xd800))
+	);
+	return _mm_movemask_epi8(is_surrogate) != 0;
+}
+
+UTKI_TARGET("sse2")
+const char16_t* validate_utf16_sse2(const char16_t* p, const char16_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char16_t);
+
+	while (size_t(end - p) >= step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		if (!has_surrogates_sse2(v)) {
+			p += step;
+			continue;
+		}
+
+		// validate the block sequence by sequence, the last surrogate pair can go beyond the block
+		for (auto block_end = p + step; p < block_end;) {
+			auto next = skip_utf16_sequence(p, end);
+			if (!next) {
+				return p;
+			}
+			p = next;
+		}
+	}
+
+	return validate_utf16_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+size_t count_utf16_code_points_sse2(const char16_t* p, const char16_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char16_t);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+
+	// two 64-bit counters of low surrogates
+	__m128i counters = _mm_setzero_si128();
+
+	auto begin = p;
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i is_low_surrogate = _mm_cmpeq_epi16(
+			_mm_and_si128(v, _mm_set1_epi16(short(0xfc00))), //
+			_mm_set1_epi16(short(0xdc00))
+		);
+		counters = _mm_add_epi64(counters, _mm_sad_epu8(_mm_and_si128(is_low_surrogate, one), zero));
+	}
+
+	std::array<uint64_t, 2> counts{};
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+	return size_t(p - begin) - size_t(counts[0] + counts[1]) + count_utf16_code_points_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+const char32_t* validate_utf32_sse2(const char32_t* p, const char32_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char32_t);
+
+	const __m128i surrogate_mask = _mm_set1_epi32(int(0xfffff800));
+	const __m128i surrogate = _mm_set1_epi32(0xd800);
+	const __m128i max_code_point = _mm_set1_epi32(0x10ffff);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		// values above 0x7fffffff are negative as signed integers
+		__m128i is_invalid = _mm_or_si128(
+			_mm_or_si128(_mm_cmpgt_epi32(v, max_code_point), _mm_cmplt_epi32(v, zero)),
+			_mm_cmpeq_epi32(_mm_and_si128(v, surrogate_mask), surrogate)
+		);
+
+		if (_mm_movemask_epi8(is_invalid) != 0) {
+			break;
+		}
+	}
+
+	return validate_utf32_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+size_t utf16_size_of_utf32_sse2(const char32_t* p, const char32_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char32_t);
+
+	// the counters grow by at most 1 per iteration, so those are flushed before they can overflow
+	constexpr size_t max_iterations = 0x10000000;
+
+	const __m128i max_bmp_code_point = _mm_set1_epi32(0xffff);
+
+	auto ret = size_t(end - p) - size_t(end - p) % step;
+
+	while (size_t(end - p) >= step) {
+		__m128i counters = _mm_setzero_si128();
+
+		for (size_t i = 0; i != max_iterations && size_t(end - p) >= step; ++i, p += step) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			// the string is valid, so all code points are below 0x110000 and the signed comparison works,
+			// comparison gives -1 for true, so subtracting it counts the surrogate pairs
+			counters = _mm_sub_epi32(counters, _mm_cmpgt_epi32(v, max_bmp_code_point));
+		}
+
+		std::array<uint32_t, step> counts{};
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+		for (auto c : counts) {
+			ret += c;
+		}
+	}
+
+	return ret + utf16_size_of_utf32_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+size_t utf16_size_of_utf8_sse2(const uint8_t* p, const uint8_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i);
+
+	// continuation bytes are 0x80-0xbf, i.e. -128...-65 as signed bytes
+	const __m128i max_continuation = _mm_set1_epi8(-65);
+	const __m128i four_byte_lead = _mm_set1_epi8(char(0xf0));
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i zero = _mm_setzero_si128();
+
+	// two 64-bit counters
+	__m128i counters = _mm_setzero_si128();
+
+	for (; size_t(end - p) >= step; p += step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i is_not_continuation = _mm_and_si128(_mm_cmpgt_epi8(v, max_continuation), one);
+		__m128i is_four_byte_lead = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, four_byte_lead), v), one);
+		counters = _mm_add_epi64(counters, _mm_sad_epu8(_mm_add_epi8(is_not_continuation, is_four_byte_lead), zero));
+	}
+
+	std::array<uint64_t, 2> counts{};
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+	return size_t(counts[0] + counts[1]) + utf16_size_of_utf8_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+size_t utf8_size_of_utf16_sse2(const char16_t* p, const char16_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char16_t);
+
+	// the counters decrease by at most 6 per iteration, so those are flushed before they can overflow
+	constexpr size_t max_iterations = 0x100000;
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i mask_1_byte = _mm_set1_epi16(short(0xff80));
+	const __m128i mask_2_bytes = _mm_set1_epi16(short(0xf800));
+	const __m128i surrogate = _mm_set1_epi16(short(0xd800));
+
+	// every code unit takes 3 bytes, except those which are known to take less
+	auto ret = ptrdiff_t(end - p) - ptrdiff_t((end - p) % step);
+	ret *= 3;
+
+	while (size_t(end - p) >= step) {
+		__m128i counters = _mm_setzero_si128();
+
+		for (size_t i = 0; i != max_iterations && size_t(end - p) >= step; ++i, p += step) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			__m128i high_bits = _mm_and_si128(v, mask_2_bytes);
+
+			// comparison gives -1 for true, i.e. the number of bytes is decreased for each of the following cases
+			__m128i is_1_byte = _mm_cmpeq_epi16(_mm_and_si128(v, mask_1_byte), zero);
+			__m128i is_2_bytes = _mm_cmpeq_epi16(high_bits, zero);
+			__m128i is_surrogate = _mm_cmpeq_epi16(high_bits, surrogate);
+
+			__m128i sum = _mm_add_epi16(_mm_add_epi16(is_1_byte, is_2_bytes), is_surrogate);
+
+			// sum adjacent 16-bit values into 32-bit values
+			counters = _mm_add_epi32(counters, _mm_madd_epi16(sum, one));
+		}
+
+		std::array<int32_t, 4> counts{};
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+		for (auto c : counts) {
+			ret += c;
+		}
+	}
+
+	return size_t(ret) + utf8_size_of_utf16_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+char16_t* utf8_to_utf16_sse2(const uint8_t* p, const uint8_t* end, char16_t* out) noexcept
+{
+	constexpr auto step = sizeof(__m128i);
+
+	const __m128i zero = _mm_setzero_si128();
+
+	while (size_t(end - p) >= step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		if (_mm_movemask_epi8(v) == 0) {
+			// all 16 characters are ASCII
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + step / 2), _mm_unpackhi_epi8(v, zero));
+			p += step;
+			out += step;
+			continue;
+		}
+
+		// decode the characters of the block one by one, the last one can go beyond the block
+		for (auto block_end = p + step; p < block_end;) {
+			out = encode_utf16(decode_utf8_valid(p), out);
+		}
+	}
+
+	return utf8_to_utf16_scalar(p, end, out);
+}
+
+UTKI_TARGET("sse2")
+char* utf16_to_utf8_sse2(const char16_t* p, const char16_t* end, char* out) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char16_t);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i non_ascii_mask = _mm_set1_epi16(short(0xff80));
+
+	while (size_t(end - p) >= step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, non_ascii_mask), zero)) == 0xffff) {
+			// all 8 characters are ASCII
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, zero));
+			p += step;
+			out += step;
+			continue;
+		}
+
+		// the last surrogate pair can go beyond the block
+		for (auto block_end = p + step; p < block_end;) {
+			out = encode_utf8_valid(decode_utf16_valid(p), out);
+		}
+	}
+
+	return utf16_to_utf8_scalar(p, end, out);
+}
+
+UTKI_TARGET("sse2")
+char32_t* utf16_to_utf32_sse2(const char16_t* p, const char16_t* end, char32_t* out) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char16_t);
+
+	const __m128i zero = _mm_setzero_si128();
+
+	while (size_t(end - p) >= step) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+		if (!has_surrogates_sse2(v)) {
+			// all 8 characters are from basic multilingual plane
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(v, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + step / 2), _mm_unpackhi_epi16(v, zero));
+			p += step;
+			out += step;
+			continue;
+		}
+
+		// the last surrogate pair can go beyond the block
+		for (auto block_end = p + step; p < block_end; ++out) {
+			*out = decode_utf16_valid(p);
+		}
+	}
+
+	return utf16_to_utf32_scalar(p, end, out);
+}
+
+UTKI_TARGET("sse2")
+char16_t* utf32_to_utf16_sse2(const char32_t* p, const char32_t* end, char16_t* out) noexcept
+{
+	constexpr auto step = 2 * sizeof(__m128i) / sizeof(char32_t);
+
+	const __m128i surrogates_begin = _mm_set1_epi32(0xd800);
+
+	while (size_t(end - p) >= step) {
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + step / 2));
+
+		// the string is valid, so all code points are below 0x110000 and the signed comparison works
+		__m128i is_single_unit = _mm_and_si128(
+			_mm_cmplt_epi32(lo, surrogates_begin), //
+			_mm_cmplt_epi32(hi, surrogates_begin)
+		);
+
+		if (_mm_movemask_epi8(is_single_unit) == 0xffff) {
+			// All 8 characters are from basic multilingual plane.
+			// Sign extend the low 16 bits, so that signed saturation of the packing keeps the values intact.
+			lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+			hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packs_epi32(lo, hi));
+			p += step;
+			out += step;
+			continue;
+		}
+
+		for (auto block_end = p + step; p != block_end; ++p) {
+			out = encode_utf16(*p, out);
+		}
+	}
+
+	return utf32_to_utf16_scalar(p, end, out);
+}
+
+UTKI_TARGET("sse2")
+size_t utf8_size_of_utf32_sse2(const char32_t* p, const char32_t* end) noexcept
+{
+	constexpr auto step = sizeof(__m128i) / sizeof(char32_t);
+
+	// the counters grow by at most 3 per iteration, so those are flushed before they can overflow
+	constexpr size_t max_iterations = 0x10000;
+
+	const __m128i max_1_byte = _mm_set1_epi32(0x7f);
+	const __m128i max_2_bytes = _mm_set1_epi32(0x7ff);
+	const __m128i max_3_bytes = _mm_set1_epi32(0xffff);
+
+	// every character takes at least 1 byte
+	auto ret = size_t(end - p) - size_t(end - p) % step;
+
+	while (size_t(end - p) >= step) {
+		__m128i counters = _mm_setzero_si128();
+
+		for (size_t i = 0; i != max_iterations && size_t(end - p) >= step; ++i, p += step) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+			// The string is valid, so all code points are below 0x110000 and the signed comparison works.
+			// Comparison gives -1 for true, so subtracting the comparison results counts the extra bytes.
+			__m128i sum = _mm_add_epi32(
+				_mm_add_epi32(_mm_cmpgt_epi32(v, max_1_byte), _mm_cmpgt_epi32(v, max_2_bytes)),
+				_mm_cmpgt_epi32(v, max_3_bytes)
+			);
+			counters = _mm_sub_epi32(counters, sum);
+		}
+
+		std::array<uint32_t, step> counts{};
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(counts.data()), counters);
+
+		for (auto c : counts) {
+			ret += c;
+		}
+	}
+
+	return ret + utf8_size_of_utf32_scalar(p, end);
+}
+
+UTKI_TARGET("sse2")
+char* utf32_to_utf8_valid_sse2(const char32_t* p, const char32_t* end, char* out) noexcept
+{
+	constexpr auto step = 2 * sizeof(__m128i) / sizeof(char32_t);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ascii_end = _mm_set1_epi32(0x80);
+
+	while (size_t(end - p) >= step) {
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + step / 2));
+
+		// the string is valid, so all code points are below 0x110000 and the signed comparison works
+		__m128i is_ascii = _mm_and_si128(
+			_mm_cmplt_epi32(lo, ascii_end), //
+			_mm_cmplt_epi32(hi, ascii_end)
+		);
+
+		if (_mm_movemask_epi8(is_ascii) == 0xffff) {
+			// all 8 characters are ASCII
+			__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(lo, hi), zero);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+			p += step;
+			out += step;
+			continue;
+		}
+
+		for (auto block_end = p + step; p != block_end; ++p) {
+			out = encode_utf8_valid(*p, out);
+		}
+	}
+
+	return utf32_to_utf8_valid_scalar(p, end, out);
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, hicpp-signed-bitwise)
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-*)
+
+#endif // ~UTKI_SIMD_X86
+
+// Functions needed to convert a string from one encoding to another.
+// The source string is validated first, then the size of the result is calculated,
+// then the valid string is converted.
+template <typename from_char_type, typename to_char_type>
+struct transcoder {
+	const from_char_type* (*validate)(const from_char_type*, const from_char_type*) noexcept;
+	size_t (*size)(const from_char_type*, const from_char_type*) noexcept;
+	to_char_type* (*convert)(const from_char_type*, const from_char_type*, to_char_type*) noexcept;
+};
+
+struct utf16_functions {
+	decltype(&validate_utf16_scalar) validate = &validate_utf16_scalar;
+	decltype(&count_utf16_code_points_scalar) count_code_points = &count_utf16_code_points_scalar;
+	transcoder<uint8_t, char16_t> from_utf8 = {
+		&validate_utf8_scalar, //
+		&utf16_size_of_utf8_scalar,
+		&utf8_to_utf16_scalar
+	};
+	transcoder<char16_t, char> to_utf8 = {
+		&validate_utf16_scalar, //
+		&utf8_size_of_utf16_scalar,
+		&utf16_to_utf8_scalar
+	};
+	transcoder<char32_t, char16_t> from_utf32 = {
+		&validate_utf32_scalar, //
+		&utf16_size_of_utf32_scalar,
+		&utf32_to_utf16_scalar
+	};
+	transcoder<char16_t, char32_t> to_utf32 = {
+		&validate_utf16_scalar, //
+		&count_utf16_code_points_scalar,
+		&utf16_to_utf32_scalar
+	};
+};
+
+utf16_functions select_utf16_functions() noexcept
+{
+	utf16_functions ret;
+
+	// reuse the UTF-8 validation which is already selected for the CPU
+	ret.from_utf8.validate = get_utf8_functions().validate;
+
+#if defined(UTKI_SIMD_X86)
+	const auto& features = utki::get_cpu_features();
+	if (features.sse2) {
+		ret.validate = &validate_utf16_sse2;
+		ret.count_code_points = &count_utf16_code_points_sse2;
+
+		ret.from_utf8.size = &utf16_size_of_utf8_sse2;
+		ret.from_utf8.convert = &utf8_to_utf16_sse2;
+
+		ret.to_utf8.validate = &validate_utf16_sse2;
+		ret.to_utf8.size = &utf8_size_of_utf16_sse2;
+		ret.to_utf8.convert = &utf16_to_utf8_sse2;
+
+		ret.from_utf32.validate = &validate_utf32_sse2;
+		ret.from_utf32.size = &utf16_size_of_utf32_sse2;
+		ret.from_utf32.convert = &utf32_to_utf16_sse2;
+
+		ret.to_utf32.validate = &validate_utf16_sse2;
+		ret.to_utf32.size = &count_utf16_code_points_sse2;
+		ret.to_utf32.convert = &utf16_to_utf32_sse2;
+	}
+#endif
+	return ret;
+}
+
+const utf16_functions& get_utf16_functions() noexcept
+{
+	static const auto functions = select_utf16_functions();
+	return functions;
+}
+
+transcoder<char32_t, char> select_utf32_to_utf8_transcoder() noexcept
+{
+	transcoder<char32_t, char> ret = {
+		// reuse the UTF-32 validation which is already selected for the CPU
+		get_utf16_functions().from_utf32.validate, //
+		&utf8_size_of_utf32_scalar,
+		&utf32_to_utf8_valid_scalar
+	};
+
+#if defined(UTKI_SIMD_X86)
+	if (utki::get_cpu_features().sse2) {
+		ret.size = &utf8_size_of_utf32_sse2;
+		ret.convert = &utf32_to_utf8_valid_sse2;
+	}
+#endif
+	return ret;
+}
+
+const transcoder<char32_t, char>& get_utf32_to_utf8_transcoder() noexcept
+{
+	static const auto functions = select_utf32_to_utf8_transcoder();
+	return functions;
+}
+
+template <typename from_char_type, typename to_char_type>
+utf_conversion_result transcode(
+	const transcoder<from_char_type, to_char_type>& t, //
+	utki::span<const from_char_type> str,
+	utki::span<to_char_type> out
+) noexcept
+{
+	auto begin = str.data();
+	auto end = utki::end_pointer(str);
+
+	// the valid part of the string is converted
+	auto valid_end = t.validate(begin, end);
+
+	auto size = t.size(begin, valid_end);
+	if (out.size() < size) {
+		return {0, 0, std::errc::value_too_large};
+	}
+
+	[[maybe_unused]] auto out_end = t.convert(begin, valid_end, out.data());
+	ASSERT(out_end == std::next(out.data(), ptrdiff_t(size)))
+
+	if (valid_end != end) {
+		return {size, size_t(valid_end - begin), std::errc::illegal_byte_sequence};
+	}
+
+	return {size, str.size(), std::errc()};
+}
+
+template <typename string_type, typename from_char_type, typename to_char_type>
+string_type transcode(
+	const transcoder<from_char_type, to_char_type>& t, //
+	utki::span<const from_char_type> str,
+	std::string_view function_name,
+	std::string_view encoding_name
+)
+{
+	auto begin = str.data();
+	auto end = utki::end_pointer(str);
+
+	auto valid_end = t.validate(begin, end);
+	if (valid_end != end) {
+		throw std::invalid_argument(utki::cat(
+			function_name, //
+			"(): malformed ",
+			encoding_name,
+			" string: invalid sequence at offset ",
+			valid_end - begin
+		));
+	}
+
+	string_type ret(t.size(begin, end), 0);
+
+	[[maybe_unused]] auto out_end = t.convert(begin, end, ret.data());
+	ASSERT(out_end == utki::end_pointer(ret))
+
+	return ret;
+}
+} // namespace
+
+utf16_iterator::utf16_iterator(utki::span<const char16_t> str) :
+	p(str.data()),
+	end(utki::end_pointer(str))
+{
+	this->operator++();
+}
+
+utf16_iterator::utf16_iterator(const char16_t* str) :
+	p(str)
+{
+	this->operator++();
+}
+
+utf16_iterator& utf16_iterator::operator++() noexcept
+{
+	if (this->p == this->end) {
+		this->c = 0;
+		return *this;
+	}
+
+	char32_t u = *this->p;
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	++this->p;
+
+	if (is_high_surrogate(u) && this->p != this->end && is_low_surrogate(*this->p)) {
+		this->c = combine_surrogates(u, *this->p);
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		++this->p;
+	} else {
+		// unpaired surrogates are returned as is
+		this->c = u;
+	}
+
+	return *this;
+}
+
+size_t utki::find_invalid_utf16(std::u16string_view str) noexcept
+{
+	auto begin = str.data();
+	auto end = utki::end_pointer(str);
+
+	auto p = get_utf16_functions().validate(begin, end);
+	if (p == end) {
+		return std::u16string_view::npos;
+	}
+	return size_t(p - begin);
+}
+
+size_t utki::utf16_length(std::u16string_view str) noexcept
+{
+	return get_utf16_functions().count_code_points(str.data(), utki::end_pointer(str));
+}
+
+size_t utki::utf16_encoded_size(std::string_view str) noexcept
+{
+	return get_utf16_functions().from_utf8.size(
+		to_uint8_t_pointer(str.data()), //
+		to_uint8_t_pointer(utki::end_pointer(str))
+	);
+}
+
+size_t utki::utf16_encoded_size(utki::span<const char32_t> str) noexcept
+{
+	return get_utf16_functions().from_utf32.size(str.data(), utki::end_pointer(str));
+}
+
+size_t utki::utf8_encoded_size(std::u16string_view str) noexcept
+{
+	return get_utf16_functions().to_utf8.size(str.data(), utki::end_pointer(str));
+}
+
+std::u16string utki::to_utf16(std::string_view str)
+{
+	return transcode<std::u16string>(
+		get_utf16_functions().from_utf8, //
+		utki::to_uint8_t(utki::make_span(str)),
+		"to_utf16",
+		"UTF-8"
+	);
+}
+
+std::u16string utki::to_utf16(utki::span<const char32_t> str)
+{
+	return transcode<std::u16string>(
+		get_utf16_functions().from_utf32, //
+		str,
+		"to_utf16",
+		"UTF-32"
+	);
+}
+
+std::string utki::to_utf8(std::u16string_view str)
+{
+	return transcode<std::string>(
+		get_utf16_functions().to_utf8, //
+		utki::make_span(str),
+		"to_utf8",
+		"UTF-16"
+	);
+}
+
+std::u32string utki::to_utf32(std::u16string_view str)
+{
+	return transcode<std::u32string>(
+		get_utf16_functions().to_utf32, //
+		utki::make_span(str),
+		"to_utf32",
+		"UTF-16"
+	);
+}
+
+utf_conversion_result utki::to_utf16(std::string_view str, utki::span<char16_t> out) noexcept
+{
+	return transcode(get_utf16_functions().from_utf8, utki::to_uint8_t(utki::make_span(str)), out);
+}
+
+utf_conversion_result utki::to_utf16(utki::span<const char32_t> str, utki::span<char16_t> out) noexcept
+{
+	return transcode(get_utf16_functions().from_utf32, str, out);
+}
+
+utf_conversion_result utki::to_utf8(std::u16string_view str, utki::span<char> out) noexcept
+{
+	return transcode(get_utf16_functions().to_utf8, utki::make_span(str), out);
+}
+
+utf_conversion_result utki::to_utf8(utki::span<const char32_t> str, utki::span<char> out) noexcept
+{
+	return transcode(get_utf32_to_utf8_transcoder(), str, out);
+}
+
+utf_conversion_result utki::to_utf32(std::u16string_view str, utki::span<char32_t> out) noexcept
+{
+	return transcode(get_utf16_functions().to_utf32, utki::make_span(str), out);
+}
+
+utf8_index::utf8_index(std::string_view str, size_t stride) :
+	str(str),
+	stride(stride),
+	num_code_points(0)
+{
+	if (stride == 0) {
+		throw std::invalid_argument("utf8_index::utf8_index(): stride must be greater than zero");
+	}
+
+	this->samples.reserve(str.size() / stride + 1);
+
+	this->num_code_points = get_utf8_functions().sample_code_points(
+		to_uint8_t_pointer(str.data()), //
+		to_uint8_t_pointer(utki::end_pointer(str)),
+		stride,
+		this->samples
+	);
+}
+
+size_t utf8_index::offset(size_t index) const
+{
+	if (index > this->num_code_points) {
+		throw std::out_of_range("utf8_index::offset(): index is out of range");
+	}
+
+	if (index == this->num_code_points) {
+		return this->str.size();
+	}
+
+	auto begin = to_uint8_t_pointer(this->str.data());
+
+	auto p = get_utf8_functions().find_code_point(
+		std::next(begin, ptrdiff_t(this->samples[index / this->stride])), //
+		to_uint8_t_pointer(utki::end_pointer(this->str)),
+		index % this->stride
+	);
+
+	return size_t(p - begin);
+}
+
+size_t utf8_index::index_of(size_t offset) const
+{
+	if (offset > this->str.size()) {
+		throw std::out_of_range("utf8_index::index_of(): offset is out of range");
+	}
+
+	// last sample which is not after the offset
+	auto i = std::upper_bound(this->samples.begin(), this->samples.end(), offset);
+	if (i == this->samples.begin()) {
+		// empty string
+		return 0;
+	}
+	i = std::prev(i);
+
+	auto sample_index = size_t(std::distance(this->samples.begin(), i));
+
+	return sample_index * this->stride + utf8_length(this->str.substr(*i, offset - *i));
+}
+
+char32_t utf8_index::at(size_t index) const
+{
+	if (index >= this->num_code_points) {
+		throw std::out_of_range("utf8_index::at(): index is out of range");
+	}
+
+	return utf8_iterator(this->str.substr(this->offset(index))).character();
+}
+
+std::string_view utf8_index::substr(size_t pos, size_t count) const
+{
+	if (pos > this->num_code_points) {
+		throw std::out_of_range("utf8_index::substr(): pos is out of range");
+	}
+
+	auto end_index = count < this->num_code_points - pos ? pos + count : this->num_code_points;
+
+	auto begin_offset = this->offset(pos);
+	auto end_offset = this->offset(end_index);
+
+	return this->str.substr(begin_offset, end_offset - begin_offset);
+}
+
@@ -30,6 +30,8 @@ SOFTWARE.
 
 #include <array>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
 #include "span.hpp"
@@ -38,6 +40,8 @@ namespace utki {
 
 /**
  * @brief Iterator to iterate through utf-8 encoded unicode characters.
+ * The iteration ends at zero character.
+ * Each byte which is not a part of a valid utf-8 sequence (RFC 3629) is returned as U+FFFD replacement character.
  */
 class utf8_iterator
 {
@@ -103,6 +107,89 @@ public:
 	}
 };
 
+/**
+ * @brief Iterator to iterate through utf-8 encoded unicode characters in reverse order.
+ * The iteration starts from the last character of the string.
+ * The iteration ends at zero character.
+ * Malformed input is handled the same way as by utf8_iterator, i.e. each byte which is not a part of
+ * a valid utf-8 sequence is returned as U+FFFD replacement character, so the reverse iteration
+ * gives exactly the same characters as the forward iteration, but in reverse order.
+ */
+class utf8_reverse_iterator
+{
+	char32_t c = 0;
+	const uint8_t* begin = nullptr;
+	// points to the first byte of the current character
+	const uint8_t* p = nullptr;
+
+public:
+	/**
+	 * @brief Create undefined iterator.
+	 */
+	utf8_reverse_iterator() = default;
+
+	/**
+	 * @brief Create iterator pointing to the last character of the given utf-8 encoded string.
+	 * @param str - utf-8 encoded string.
+	 */
+	utf8_reverse_iterator(utki::span<const uint8_t> str);
+
+	/**
+	 * @brief Create iterator pointing to the last character of the given utf-8 encoded string.
+	 * @param str - utf-8 encoded string.
+	 */
+	utf8_reverse_iterator(std::string_view str) :
+		utf8_reverse_iterator(utki::to_uint8_t(utki::make_span(str)))
+	{}
+
+	/**
+	 * @brief Get current unicode character.
+	 * @return unicode value of the character this interator is currently pointing to.
+	 */
+	char32_t character() const noexcept
+	{
+		return this->c;
+	}
+
+	/**
+	 * @brief Get byte offset of the current character.
+	 * @return byte offset of the current character from the beginning of the string.
+	 */
+	size_t offset() const noexcept
+	{
+		return size_t(this->p - this->begin);
+	}
+
+	/**
+	 * @brief Prefix increment.
+	 * Move iterator to the previous character in the string.
+	 * If iterator points to the end of the string before this operation then the result of this operation is undefined.
+	 * @return reference to this iterator object.
+	 */
+	utf8_reverse_iterator& operator++() noexcept;
+
+	/**
+	 * @brief Check if iterator points to the end of the string.
+	 * The end of the string for the reverse iterator is before the first character.
+	 * @return true if iterator points to the end of the string.
+	 * @return false otherwise.
+	 */
+	bool is_end() const noexcept
+	{
+		return this->c == 0;
+	}
+};
+
+/**
+ * @brief Truncate UTF-8 string to a number of characters.
+ * Does not allocate any memory.
+ * The string is assumed to be a valid UTF-8 string.
+ * @param str - UTF-8 string to truncate.
+ * @param max_code_points - maximum number of unicode characters to leave.
+ * @return The beginning of the string containing at most max_code_points unicode characters.
+ */
+std::string_view utf8_truncate(std::string_view str, size_t max_code_points) noexcept;
+
 /**
  * @brief Convert UTF-8 to UTF-32.
  * @param str - string to convert.
@@ -117,7 +204,7 @@ std::u32string to_utf32(utf8_iterator str);
  */
 inline std::u32string to_utf32(const char* str)
 {
-	return to_utf32(utf8_iterator(str));
+	return to_utf32(std::string_view(str));
 }
 
 /**
@@ -127,11 +214,14 @@ inline std::u32string to_utf32(const char* str)
  */
 inline std::u32string to_utf32(const std::string& str)
 {
-	return to_utf32(str.c_str());
+	return to_utf32(std::string_view(str));
 }
 
 /**
  * @brief Convert UTF-8 to UTF-32.
+ * The string is converted up to the first zero character.
+ * Each byte of malformed UTF-8 sequences is converted to U+FFFD replacement character, same as by utf8_iterator,
+ * use to_utf32(std::string_view, utki::span<char32_t>) to detect those.
  * @param str - string to convert.
  * @return UTF-32 string.
  */
@@ -158,6 +248,70 @@ inline std::u32string to_utf32(std::string_view str)
 	return to_utf32(utki::make_span(str));
 }
 
+/**
+ * @brief Find first malformed UTF-8 sequence.
+ * The string is validated according to RFC 3629, i.e. overlong encodings, surrogates,
+ * code points above 0x10ffff and truncated sequences are considered malformed.
+ * @param str - UTF-8 string to validate.
+ * @return Offset of the first byte of the first malformed sequence.
+ * @return std::string_view::npos if the string is a valid UTF-8 string.
+ */
+size_t find_invalid_utf8(std::string_view str) noexcept;
+
+/**
+ * @brief Check if string is a valid UTF-8 string.
+ * See find_invalid_utf8() for details.
+ * @param str - string to check.
+ * @return true if the string is a valid UTF-8 string.
+ * @return false otherwise.
+ */
+inline bool is_valid_utf8(std::string_view str) noexcept
+{
+	return find_invalid_utf8(str) == std::string_view::npos;
+}
+
+/**
+ * @brief Get number of unicode characters in UTF-8 string.
+ * The string is assumed to be a valid UTF-8 string.
+ * @param str - UTF-8 string.
+ * @return Number of unicode characters in the string.
+ */
+size_t utf8_length(std::string_view str) noexcept;
+
+/**
+ * @brief Result of UTF conversion.
+ */
+struct utf_conversion_result {
+	/**
+	 * @brief Number of characters written to the output buffer.
+	 */
+	size_t num_written;
+
+	/**
+	 * @brief Offset of the first character of the input string which could not be converted.
+	 * In case of success it is equal to the input string length.
+	 */
+	size_t offset;
+
+	/**
+	 * @brief Error code.
+	 * std::errc() in case of success.
+	 * std::errc::illegal_byte_sequence in case the input string is malformed,
+	 * the valid part of the string before the malformed sequence is converted in this case.
+	 * std::errc::value_too_large in case the output buffer is too small, nothing is converted in this case.
+	 */
+	std::errc ec;
+};
+
+/**
+ * @brief Convert UTF-8 to UTF-32 into a buffer.
+ * The function does not allocate any memory.
+ * @param str - UTF-8 string to convert.
+ * @param out - buffer to write the UTF-32 characters to. Must be at least utf8_length() characters long.
+ * @return Conversion result.
+ */
+utf_conversion_result to_utf32(std::string_view str, utki::span<char32_t> out) noexcept;
+
 constexpr unsigned max_size_of_utf8_encoded_character = 6;
 
 /**
@@ -167,13 +321,42 @@ constexpr unsigned max_size_of_utf8_encoded_character = 6;
  */
 std::array<char, max_size_of_utf8_encoded_character + 1> to_utf8(char32_t c);
 
+/**
+ * @brief Get size of UTF-8 representation of UTF-32 string.
+ * Zero characters and characters above 0x7fffffff have no UTF-8 representation, so those are skipped.
+ * @param str - UTF-32 string.
+ * @return Number of bytes in UTF-8 representation of the string.
+ */
+size_t utf8_encoded_size(utki::span<const char32_t> str) noexcept;
+
 /**
  * @brief Convert UTF-32 string to UTF-8 string.
+ * Zero characters and characters above 0x7fffffff are skipped.
  * @param str - UTF-32 string to convert.
  * @return UTF-8 string.
  */
 std::string to_utf8(utki::span<const char32_t> str);
 
+/**
+ * @brief Convert UTF-32 string to UTF-8 and append it to a string.
+ * Zero characters and characters above 0x7fffffff are skipped.
+ * @param out - string to append the UTF-8 representation to.
+ * @param str - UTF-32 string to convert.
+ */
+void append_utf8(std::string& out, utki::span<const char32_t> str);
+
+/**
+ * @brief Convert UTF-32 string to UTF-8 into a buffer.
+ * The function does not allocate any memory.
+ * Unlike to_utf8(utki::span<const char32_t>), the input string is validated and zero characters are encoded.
+ * Surrogates and characters above 0x10ffff are treated as malformed input.
+ * @param str - UTF-32 string to convert.
+ * @param out - buffer to write the UTF-8 string to. Must be at least utf8_encoded_size() bytes long
+ *              plus one byte per zero character.
+ * @return Conversion result.
+ */
+utf_conversion_result to_utf8(utki::span<const char32_t> str, utki::span<char> out) noexcept;
+
 /**
  * @brief Convert UTF-32 string to UTF-8 string.
  * @param str - UTF-32 string to convert.
@@ -184,4 +367,278 @@ inline std::string to_utf8(const std::u32string& str)
 	return to_utf8(utki::make_span(str));
 }
 
+/**
+ * @brief Iterator to iterate through utf-16 encoded unicode characters.
+ * Unpaired surrogates are returned as is.
+ */
+class utf16_iterator
+{
+	char32_t c = 0;
+	const char16_t* p = nullptr;
+	const char16_t* end = nullptr;
+
+public:
+	/**
+	 * @brief Create undefined iterator.
+	 */
+	utf16_iterator() = default;
+
+	/**
+	 * @brief Create iterator pointing to the begin of the given utf-16 encoded string.
+	 * @param str - utf-16 encoded string.
+	 */
+	utf16_iterator(utki::span<const char16_t> str);
+
+	/**
+	 * @brief Create iterator pointing to the begin of the given utf-16 encoded string.
+	 * @param str - utf-16 encoded string.
+	 */
+	utf16_iterator(std::u16string_view str) :
+		utf16_iterator(utki::make_span(str))
+	{}
+
+	/**
+	 * @brief Create iterator pointing to the begin of the given utf-16 encoded string.
+	 * Resolves the ambiguity between utki::span and std::u16string_view constructors.
+	 * @param str - utf-16 encoded string.
+	 */
+	utf16_iterator(const std::u16string& str) :
+		utf16_iterator(std::u16string_view(str))
+	{}
+
+	/**
+	 * @brief Create iterator pointing to the begin of the given utf-16 encoded string.
+	 * @param str - pointer to the null-terminated utf-16 encoded string.
+	 */
+	utf16_iterator(const char16_t* str);
+
+	/**
+	 * @brief Get current unicode character.
+	 * @return unicode value of the character this interator is currently pointing to.
+	 */
+	char32_t character() const noexcept
+	{
+		return this->c;
+	}
+
+	/**
+	 * @brief Prefix increment.
+	 * Move iterator to the next character in the string.
+	 * If iterator points to the end of the string before this operation then the result of this operation is undefined.
+	 * @return reference to this iterator object.
+	 */
+	utf16_iterator& operator++() noexcept;
+
+	/**
+	 * @brief Check if iterator points to the end of the string.
+	 * @return true if iterator points to the end of the string.
+	 * @return false otherwise.
+	 */
+	bool is_end() const noexcept
+	{
+		return this->c == 0;
+	}
+};
+
+/**
+ * @brief Find first unpaired surrogate in UTF-16 string.
+ * @param str - UTF-16 string to validate.
+ * @return Offset of the first unpaired surrogate.
+ * @return std::u16string_view::npos if the string is a valid UTF-16 string.
+ */
+size_t find_invalid_utf16(std::u16string_view str) noexcept;
+
+/**
+ * @brief Check if string is a valid UTF-16 string.
+ * @param str - string to check.
+ * @return true if the string is a valid UTF-16 string.
+ * @return false otherwise.
+ */
+inline bool is_valid_utf16(std::u16string_view str) noexcept
+{
+	return find_invalid_utf16(str) == std::u16string_view::npos;
+}
+
+/**
+ * @brief Get number of unicode characters in UTF-16 string.
+ * The string is assumed to be a valid UTF-16 string.
+ * @param str - UTF-16 string.
+ * @return Number of unicode characters in the string.
+ */
+size_t utf16_length(std::u16string_view str) noexcept;
+
+/**
+ * @brief Get size of UTF-16 representation of UTF-8 string.
+ * The string is assumed to be a valid UTF-8 string.
+ * @param str - UTF-8 string.
+ * @return Number of UTF-16 code units in UTF-16 representation of the string.
+ */
+size_t utf16_encoded_size(std::string_view str) noexcept;
+
+/**
+ * @brief Get size of UTF-16 representation of UTF-32 string.
+ * The string is assumed to be a valid UTF-32 string.
+ * @param str - UTF-32 string.
+ * @return Number of UTF-16 code units in UTF-16 representation of the string.
+ */
+size_t utf16_encoded_size(utki::span<const char32_t> str) noexcept;
+
+/**
+ * @brief Get size of UTF-8 representation of UTF-16 string.
+ * The string is assumed to be a valid UTF-16 string.
+ * @param str - UTF-16 string.
+ * @return Number of bytes in UTF-8 representation of the string.
+ */
+size_t utf8_encoded_size(std::u16string_view str) noexcept;
+
+/**
+ * @brief Convert UTF-8 to UTF-16.
+ * @param str - UTF-8 string to convert.
+ * @return UTF-16 string.
+ * @throw std::invalid_argument - in case the string is not a valid UTF-8 string.
+ */
+std::u16string to_utf16(std::string_view str);
+
+/**
+ * @brief Convert UTF-32 to UTF-16.
+ * @param str - UTF-32 string to convert.
+ * @return UTF-16 string.
+ * @throw std::invalid_argument - in case the string contains surrogates or characters above 0x10ffff.
+ */
+std::u16string to_utf16(utki::span<const char32_t> str);
+
+/**
+ * @brief Convert UTF-16 to UTF-8.
+ * @param str - UTF-16 string to convert.
+ * @return UTF-8 string.
+ * @throw std::invalid_argument - in case the string contains unpaired surrogates.
+ */
+std::string to_utf8(std::u16string_view str);
+
+/**
+ * @brief Convert UTF-16 to UTF-32.
+ * @param str - UTF-16 string to convert.
+ * @return UTF-32 string.
+ * @throw std::invalid_argument - in case the string contains unpaired surrogates.
+ */
+std::u32string to_utf32(std::u16string_view str);
+
+/**
+ * @brief Convert UTF-8 to UTF-16 into a buffer.
+ * The function does not allocate any memory.
+ * @param str - UTF-8 string to convert.
+ * @param out - buffer to write the UTF-16 string to. Must be at least utf16_encoded_size() code units long.
+ * @return Conversion result.
+ */
+utf_conversion_result to_utf16(std::string_view str, utki::span<char16_t> out) noexcept;
+
+/**
+ * @brief Convert UTF-32 to UTF-16 into a buffer.
+ * The function does not allocate any memory.
+ * @param str - UTF-32 string to convert.
+ * @param out - buffer to write the UTF-16 string to. Must be at least utf16_encoded_size() code units long.
+ * @return Conversion result.
+ */
+utf_conversion_result to_utf16(utki::span<const char32_t> str, utki::span<char16_t> out) noexcept;
+
+/**
+ * @brief Convert UTF-16 to UTF-8 into a buffer.
+ * The function does not allocate any memory.
+ * @param str - UTF-16 string to convert.
+ * @param out - buffer to write the UTF-8 string to. Must be at least utf8_encoded_size() bytes long.
+ * @return Conversion result.
+ */
+utf_conversion_result to_utf8(std::u16string_view str, utki::span<char> out) noexcept;
+
+/**
+ * @brief Convert UTF-16 to UTF-32 into a buffer.
+ * The function does not allocate any memory.
+ * @param str - UTF-16 string to convert.
+ * @param out - buffer to write the UTF-32 string to. Must be at least utf16_length() characters long.
+ * @return Conversion result.
+ */
+utf_conversion_result to_utf32(std::u16string_view str, utki::span<char32_t> out) noexcept;
+
+/**
+ * @brief Index of code points of UTF-8 string.
+ * The index allows random access to the code points of UTF-8 string by code point index.
+ * It stores byte offsets of every stride-th code point, so accessing a code point
+ * requires skipping at most stride - 1 code points from the nearest sample.
+ * The index does not own the string, the string must outlive the index.
+ * The string is assumed to be a valid UTF-8 string.
+ */
+class utf8_index
+{
+	std::string_view str;
+	size_t stride;
+	size_t num_code_points;
+
+	// byte offsets of code points 0, stride, 2 * stride, ...
+	std::vector<size_t> samples;
+
+public:
+	constexpr static const size_t default_stride = 64;
+
+	/**
+	 * @brief Build index of UTF-8 string.
+	 * @param str - UTF-8 string to build the index for.
+	 * @param stride - number of code points between samples.
+	 * @throw std::invalid_argument - in case the stride is zero.
+	 */
+	utf8_index(std::string_view str, size_t stride = default_stride);
+
+	/**
+	 * @brief Get indexed string.
+	 * @return The indexed UTF-8 string.
+	 */
+	std::string_view string() const noexcept
+	{
+		return this->str;
+	}
+
+	/**
+	 * @brief Get number of code points in the string.
+	 * @return Number of code points in the string.
+	 */
+	size_t size() const noexcept
+	{
+		return this->num_code_points;
+	}
+
+	/**
+	 * @brief Get byte offset of code point.
+	 * @param index - index of the code point. Can be equal to size(), then the string size is returned.
+	 * @return Byte offset of the code point in the string.
+	 * @throw std::out_of_range - in case the index is greater than size().
+	 */
+	size_t offset(size_t index) const;
+
+	/**
+	 * @brief Get code point index by byte offset.
+	 * @param offset - byte offset in the string. Must point to the beginning of a code point or to the end of the
+	 * string.
+	 * @return Index of the code point which begins at the given byte offset.
+	 * @throw std::out_of_range - in case the offset is greater than the string size.
+	 */
+	size_t index_of(size_t offset) const;
+
+	/**
+	 * @brief Get code point.
+	 * @param index - index of the code point.
+	 * @return The code point.
+	 * @throw std::out_of_range - in case the index is not less than size().
+	 */
+	char32_t at(size_t index) const;
+
+	/**
+	 * @brief Get substring by code point range.
+	 * Same as std::string_view::substr(), but positions are in code points.
+	 * @param pos - index of the first code point of the substring.
+	 * @param count - maximum number of code points in the substring.
+	 * @return UTF-8 substring.
+	 * @throw std::out_of_range - in case the pos is greater than size().
+	 */
+	std::string_view substr(size_t pos, size_t count = std::string_view::npos) const;
+};
+
 } // namespace utki
@@ -29,10 +29,12 @@ SOFTWARE.
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <map>
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
 
 #include "config.hpp"
@@ -40,10 +42,46 @@ SOFTWARE.
 #include "span.hpp"
 #include "type_traits.hpp"
 
+#if CFG_COMPILER == CFG_COMPILER_MSVC
+#	include <cstdlib>
+#endif
+
 #ifdef min
 #	undef min
 #endif
 
+/**
+ * @brief Whether the compiler can detect constant evaluation.
+ * Defined to 1 in case utki::is_constant_evaluated() is able to tell constant evaluation from runtime evaluation,
+ * to 0 otherwise.
+ */
+#if CFG_CPP >= 20
+#	define UTKI_IS_CONSTANT_EVALUATED_SUPPORTED 1
+#elif CFG_COMPILER == CFG_COMPILER_GCC && CFG_COMPILER_VERSION_MAJOR >= 9
+#	define UTKI_IS_CONSTANT_EVALUATED_SUPPORTED 1
+#elif CFG_COMPILER == CFG_COMPILER_MSVC && _MSC_VER >= 1925
+#	define UTKI_IS_CONSTANT_EVALUATED_SUPPORTED 1
+#elif defined(__has_builtin)
+#	if __has_builtin(__builtin_is_constant_evaluated)
+#		define UTKI_IS_CONSTANT_EVALUATED_SUPPORTED 1
+#	endif
+#endif
+#ifndef UTKI_IS_CONSTANT_EVALUATED_SUPPORTED
+#	define UTKI_IS_CONSTANT_EVALUATED_SUPPORTED 0
+#endif
+
+/**
+ * @brief Specifier for serialization functions.
+ * The serialization functions select the fast runtime code path with utki::is_constant_evaluated().
+ * In case the compiler cannot detect constant evaluation, the functions are not constexpr and always
+ * take the fast runtime code path.
+ */
+#if UTKI_IS_CONSTANT_EVALUATED_SUPPORTED
+#	define UTKI_CONSTEXPR_SERIALIZATION constexpr
+#else
+#	define UTKI_CONSTEXPR_SERIALIZATION inline
+#endif
+
 namespace utki {
 
 /**
@@ -279,6 +317,88 @@ public:
 	}
 };
 
+/**
+ * @brief Check if the function call is evaluated at compile time.
+ * Drop-in replacement for std::is_constant_evaluated() from C++20.
+ * In case the compiler does not provide a way to detect constant evaluation, always returns false,
+ * see UTKI_IS_CONSTANT_EVALUATED_SUPPORTED.
+ * @return true if called within constant evaluation.
+ * @return false otherwise.
+ */
+constexpr bool is_constant_evaluated() noexcept
+{
+#if CFG_CPP >= 20
+	return std::is_constant_evaluated();
+#elif UTKI_IS_CONSTANT_EVALUATED_SUPPORTED
+	return __builtin_is_constant_evaluated();
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Byte order.
+ * Drop-in replacement for std::endian from C++20.
+ * In case the host byte order is unknown, native is neither little nor big.
+ */
+enum class endian {
+	little,
+	big,
+#if CFG_ENDIANNESS == CFG_ENDIANNESS_LITTLE
+	native = little
+#elif CFG_ENDIANNESS == CFG_ENDIANNESS_BIG
+	native = big
+#else
+	native
+#endif
+};
+
+/**
+ * @brief Reverse byte order of unsigned integral value.
+ * Drop-in replacement for std::byteswap() from C++23.
+ * Uses compiler intrinsics where available.
+ * @param value - value to reverse byte order of.
+ * @return Value with reversed byte order.
+ */
+template <typename unsigned_type>
+constexpr unsigned_type byte_swap(unsigned_type value) noexcept
+{
+	static_assert(std::is_integral_v<unsigned_type>, "value type must be integral");
+	static_assert(std::is_unsigned_v<unsigned_type>, "value type must be unsigned");
+
+	if constexpr (sizeof(value) == sizeof(uint8_t)) {
+		return value;
+	}
+
+#if CFG_COMPILER == CFG_COMPILER_GCC || CFG_COMPILER == CFG_COMPILER_CLANG
+	if constexpr (sizeof(value) == sizeof(uint16_t)) {
+		return __builtin_bswap16(value);
+	} else if constexpr (sizeof(value) == sizeof(uint32_t)) {
+		return __builtin_bswap32(value);
+	} else if constexpr (sizeof(value) == sizeof(uint64_t)) {
+		return __builtin_bswap64(value);
+	}
+#elif CFG_COMPILER == CFG_COMPILER_MSVC && UTKI_IS_CONSTANT_EVALUATED_SUPPORTED
+	// MSVC byte swap intrinsics are not constexpr
+	if (!is_constant_evaluated()) {
+		if constexpr (sizeof(value) == sizeof(uint16_t)) {
+			return _byteswap_ushort(value);
+		} else if constexpr (sizeof(value) == sizeof(uint32_t)) {
+			return _byteswap_ulong(value);
+		} else if constexpr (sizeof(value) == sizeof(uint64_t)) {
+			return _byteswap_uint64(value);
+		}
+	}
+#endif
+
+	unsigned_type ret = 0;
+	for (unsigned i = 0; i != sizeof(value); ++i) {
+		ret = unsigned_type((ret << byte_bits) | (value & byte_mask));
+		value = unsigned_type(value >> byte_bits);
+	}
+	return ret;
+}
+
 /**
  * @brief Serialize unsigned integral value, little-endian.
  * @param value - value to serialize.
@@ -286,19 +406,29 @@ public:
  * @return Pointer to the next byte after serialized value.
  */
 template <typename unsigned_type>
-uint8_t* serialize_le(unsigned_type value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize_le(unsigned_type value, uint8_t* out_buf) noexcept
 {
 	static_assert(std::is_integral_v<unsigned_type>, "serialized type must be integral");
 	static_assert(std::is_unsigned_v<unsigned_type>, "serialized type must be unsigned");
 
-	unsigned index = 0;
-	auto span = utki::make_span(out_buf, sizeof(value));
-	for (auto& b : span) {
-		b = uint8_t((value >> (byte_bits * index)) & byte_mask);
-		++index;
+	if constexpr (endian::native == endian::little || endian::native == endian::big) {
+		if (!is_constant_evaluated()) {
+			if constexpr (endian::native == endian::big) {
+				value = byte_swap(value);
+			}
+			std::memcpy(out_buf, &value, sizeof(value));
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			return out_buf + sizeof(value);
+		}
+	}
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (unsigned index = 0; index != sizeof(value); ++index) {
+		out_buf[index] = uint8_t((value >> (byte_bits * index)) & byte_mask);
 	}
 
-	return utki::end_pointer(span);
+	return out_buf + sizeof(value);
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 }
 
 /**
@@ -308,7 +438,7 @@ uint8_t* serialize_le(unsigned_type value, uint8_t* out_buf) noexcept
  * @param out_buf - pointer to the 2 byte buffer where the result will be placed.
  * @return pointer to the next byte after serialized value.
  */
-inline uint8_t* serialize16le(uint16_t value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize16le(uint16_t value, uint8_t* out_buf) noexcept
 {
 	return serialize_le(value, out_buf);
 }
@@ -320,7 +450,7 @@ inline uint8_t* serialize16le(uint16_t value, uint8_t* out_buf) noexcept
  * @param out_buf - pointer to the 4 byte buffer where the result will be placed.
  * @return pointer to the next byte after serialized value.
  */
-inline uint8_t* serialize32le(uint32_t value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize32le(uint32_t value, uint8_t* out_buf) noexcept
 {
 	return serialize_le(value, out_buf);
 }
@@ -332,7 +462,7 @@ inline uint8_t* serialize32le(uint32_t value, uint8_t* out_buf) noexcept
  * @param out_buf - pointer to the 8 byte buffer where the result will be placed.
  * @return pointer to the next byte after serialized value.
  */
-inline uint8_t* serialize64le(uint64_t value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize64le(uint64_t value, uint8_t* out_buf) noexcept
 {
 	return serialize_le(value, out_buf);
 }
@@ -343,18 +473,27 @@ inline uint8_t* serialize64le(uint64_t value, uint8_t* out_buf) noexcept
  * @return Deserialized value.
  */
 template <typename unsigned_type>
-unsigned_type deserialize_le(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION unsigned_type deserialize_le(const uint8_t* buf) noexcept
 {
 	static_assert(std::is_integral_v<unsigned_type>, "deserialized type must be integral");
 	static_assert(std::is_unsigned_v<unsigned_type>, "deserialized type must be unsigned");
 
-	unsigned_type ret = 0;
+	if constexpr (endian::native == endian::little || endian::native == endian::big) {
+		if (!is_constant_evaluated()) {
+			unsigned_type value = 0;
+			std::memcpy(&value, buf, sizeof(value));
+			if constexpr (endian::native == endian::big) {
+				value = byte_swap(value);
+			}
+			return value;
+		}
+	}
 
-	unsigned index = 0;
+	unsigned_type ret = 0;
 
-	for (auto b : utki::make_span(buf, sizeof(ret))) {
-		ret |= (decltype(ret)(b) << (byte_bits * index));
-		++index;
+	for (unsigned index = 0; index != sizeof(ret); ++index) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		ret |= (decltype(ret)(buf[index]) << (byte_bits * index));
 	}
 
 	return ret;
@@ -367,7 +506,7 @@ unsigned_type deserialize_le(const uint8_t* buf) noexcept
  * @param buf - pointer to buffer containing 2 bytes to convert from little-endian format.
  * @return 16 bit unsigned integer converted from little-endian byte order to native byte order.
  */
-inline uint16_t deserialize16le(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint16_t deserialize16le(const uint8_t* buf) noexcept
 {
 	return deserialize_le<uint16_t>(buf);
 }
@@ -379,7 +518,7 @@ inline uint16_t deserialize16le(const uint8_t* buf) noexcept
  * @param buf - pointer to buffer containing 4 bytes to convert from little-endian format.
  * @return 32 bit unsigned integer converted from little-endian byte order to native byte order.
  */
-inline uint32_t deserialize32le(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint32_t deserialize32le(const uint8_t* buf) noexcept
 {
 	return deserialize_le<uint32_t>(buf);
 }
@@ -391,7 +530,7 @@ inline uint32_t deserialize32le(const uint8_t* buf) noexcept
  * @param buf - pointer to buffer containing 8 bytes to convert from little-endian format.
  * @return 64 bit unsigned integer converted from little-endian byte order to native byte order.
  */
-inline uint64_t deserialize64le(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint64_t deserialize64le(const uint8_t* buf) noexcept
 {
 	return deserialize_le<uint64_t>(buf);
 }
@@ -404,10 +543,10 @@ inline uint64_t deserialize64le(const uint8_t* buf) noexcept
  */
 inline uint8_t* serialize_float_le(float value, uint8_t* out_buf) noexcept
 {
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	auto p = reinterpret_cast<uint8_t*>(&value);
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	return serialize32le(*reinterpret_cast<uint32_t*>(p), out_buf);
+	static_assert(sizeof(value) == sizeof(uint32_t), "float is not 32 bit");
+	uint32_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(value));
+	return serialize32le(bits, out_buf);
 }
 
 /**
@@ -417,11 +556,39 @@ inline uint8_t* serialize_float_le(float value, uint8_t* out_buf) noexcept
  */
 inline float deserialize_float_le(const uint8_t* buf) noexcept
 {
-	auto val = deserialize32le(buf);
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	auto p = reinterpret_cast<uint8_t*>(&val);
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	return *reinterpret_cast<float*>(p);
+	auto bits = deserialize32le(buf);
+	float ret{};
+	static_assert(sizeof(ret) == sizeof(bits), "float is not 32 bit");
+	std::memcpy(&ret, &bits, sizeof(ret));
+	return ret;
+}
+
+/**
+ * @brief Serialize double to IEEE 754, little-endian.
+ * @param value - double value to serialize.
+ * @param out_buf - pointer to the 8 byte buffer where the result will be placed.
+ * @return pointer to the next byte after serialized value.
+ */
+inline uint8_t* serialize_double_le(double value, uint8_t* out_buf) noexcept
+{
+	static_assert(sizeof(value) == sizeof(uint64_t), "double is not 64 bit");
+	uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(value));
+	return serialize64le(bits, out_buf);
+}
+
+/**
+ * @brief De-serialize IEEE 754 double precision floating point value, little-endian.
+ * @param buf - pointer to buffer containing 8 bytes to convert from IEEE 754 little-endian format.
+ * @return floating point value.
+ */
+inline double deserialize_double_le(const uint8_t* buf) noexcept
+{
+	auto bits = deserialize64le(buf);
+	double ret{};
+	static_assert(sizeof(ret) == sizeof(bits), "double is not 64 bit");
+	std::memcpy(&ret, &bits, sizeof(ret));
+	return ret;
 }
 
 /**
@@ -431,23 +598,31 @@ inline float deserialize_float_le(const uint8_t* buf) noexcept
  * @return Pointer to the next byte after serialized value.
  */
 template <typename unsigned_type>
-uint8_t* serialize_be(unsigned_type value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize_be(unsigned_type value, uint8_t* out_buf) noexcept
 {
 	static_assert(std::is_integral_v<unsigned_type>, "serialized type must be integral");
 	static_assert(std::is_unsigned_v<unsigned_type>, "serialized type must be unsigned");
 
-	unsigned index = sizeof(value);
-	auto span = utki::make_span(out_buf, sizeof(value));
-	for (auto& b : span) {
-		ASSERT(index > 0)
-		--index;
-		auto num_bits_to_shift = byte_bits * index;
-		ASSERT(num_bits_to_shift <= sizeof(value) * byte_bits)
+	if constexpr (endian::native == endian::little || endian::native == endian::big) {
+		if (!is_constant_evaluated()) {
+			if constexpr (endian::native == endian::little) {
+				value = byte_swap(value);
+			}
+			std::memcpy(out_buf, &value, sizeof(value));
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			return out_buf + sizeof(value);
+		}
+	}
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (unsigned index = 0; index != sizeof(value); ++index) {
+		auto num_bits_to_shift = byte_bits * (sizeof(value) - 1 - index);
 		// NOLINTNEXTLINE(clang-analyzer-core.UndefinedBinaryOperatorResult, clang-analyzer-core.BitwiseShift)
-		b = uint8_t((value >> num_bits_to_shift) & byte_mask);
+		out_buf[index] = uint8_t((value >> num_bits_to_shift) & byte_mask);
 	}
 
-	return utki::end_pointer(span);
+	return out_buf + sizeof(value);
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 }
 
 /**
@@ -457,7 +632,7 @@ uint8_t* serialize_be(unsigned_type value, uint8_t* out_buf) noexcept
  * @param out_buf - pointer to the 2 byte buffer where the result will be placed.
  * @return pointer to the next byte after serialized value.
  */
-inline uint8_t* serialize16be(uint16_t value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize16be(uint16_t value, uint8_t* out_buf) noexcept
 {
 	return serialize_be(value, out_buf);
 }
@@ -469,7 +644,7 @@ inline uint8_t* serialize16be(uint16_t value, uint8_t* out_buf) noexcept
  * @param out_buf - pointer to the 4 byte buffer where the result will be placed.
  * @return pointer to the next byte after serialized value.
  */
-inline uint8_t* serialize32be(uint32_t value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize32be(uint32_t value, uint8_t* out_buf) noexcept
 {
 	return serialize_be(value, out_buf);
 }
@@ -481,7 +656,7 @@ inline uint8_t* serialize32be(uint32_t value, uint8_t* out_buf) noexcept
  * @param out_buf - pointer to the 8 byte buffer where the result will be placed.
  * @return pointer to the next byte after serialized value.
  */
-inline uint8_t* serialize64be(uint64_t value, uint8_t* out_buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint8_t* serialize64be(uint64_t value, uint8_t* out_buf) noexcept
 {
 	return serialize_be(value, out_buf);
 }
@@ -492,20 +667,27 @@ inline uint8_t* serialize64be(uint64_t value, uint8_t* out_buf) noexcept
  * @return Deserialized value.
  */
 template <typename unsigned_type>
-unsigned_type deserialize_be(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION unsigned_type deserialize_be(const uint8_t* buf) noexcept
 {
 	static_assert(std::is_integral_v<unsigned_type>, "deserialized type must be integral");
 	static_assert(std::is_unsigned_v<unsigned_type>, "deserialized type must be unsigned");
 
-	unsigned_type ret = 0;
+	if constexpr (endian::native == endian::little || endian::native == endian::big) {
+		if (!is_constant_evaluated()) {
+			unsigned_type value = 0;
+			std::memcpy(&value, buf, sizeof(value));
+			if constexpr (endian::native == endian::little) {
+				value = byte_swap(value);
+			}
+			return value;
+		}
+	}
 
-	unsigned index = sizeof(ret);
+	unsigned_type ret = 0;
 
-	for (auto b : utki::make_span(buf, sizeof(ret))) {
-		--index;
-		ASSERT(index <= sizeof(ret))
-		// NOLINTNEXTLINE(clang-analyzer-core.BitwiseShift)
-		ret |= (decltype(ret)(b) << (byte_bits * index));
+	for (unsigned index = 0; index != sizeof(ret); ++index) {
+		// NOLINTNEXTLINE(clang-analyzer-core.BitwiseShift, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		ret |= (decltype(ret)(buf[index]) << (byte_bits * (sizeof(ret) - 1 - index)));
 	}
 
 	return ret;
@@ -518,7 +700,7 @@ unsigned_type deserialize_be(const uint8_t* buf) noexcept
  * @param buf - pointer to buffer containing 2 bytes to convert from big-endian format.
  * @return 16 bit unsigned integer converted from big-endian byte order to native byte order.
  */
-inline uint16_t deserialize16be(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint16_t deserialize16be(const uint8_t* buf) noexcept
 {
 	return deserialize_be<uint16_t>(buf);
 }
@@ -530,7 +712,7 @@ inline uint16_t deserialize16be(const uint8_t* buf) noexcept
  * @param buf - pointer to buffer containing 4 bytes to convert from big-endian format.
  * @return 32 bit unsigned integer converted from big-endian byte order to native byte order.
  */
-inline uint32_t deserialize32be(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint32_t deserialize32be(const uint8_t* buf) noexcept
 {
 	return deserialize_be<uint32_t>(buf);
 }
@@ -542,7 +724,7 @@ inline uint32_t deserialize32be(const uint8_t* buf) noexcept
  * @param buf - pointer to buffer containing 4 bytes to convert from big-endian format.
  * @return 64 bit unsigned integer converted from big-endian byte order to native byte order.
  */
-inline uint64_t deserialize64be(const uint8_t* buf) noexcept
+UTKI_CONSTEXPR_SERIALIZATION uint64_t deserialize64be(const uint8_t* buf) noexcept
 {
 	return deserialize_be<uint64_t>(buf);
 }
@@ -555,10 +737,10 @@ inline uint64_t deserialize64be(const uint8_t* buf) noexcept
  */
 inline uint8_t* serialize_float_be(float value, uint8_t* out_buf) noexcept
 {
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	auto p = reinterpret_cast<uint8_t*>(&value);
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	return serialize32be(*reinterpret_cast<uint32_t*>(p), out_buf);
+	static_assert(sizeof(value) == sizeof(uint32_t), "float is not 32 bit");
+	uint32_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(value));
+	return serialize32be(bits, out_buf);
 }
 
 /**
@@ -568,11 +750,203 @@ inline uint8_t* serialize_float_be(float value, uint8_t* out_buf) noexcept
  */
 inline float deserialize_float_be(const uint8_t* buf) noexcept
 {
-	auto val = deserialize32be(buf);
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	auto p = reinterpret_cast<uint8_t*>(&val);
-	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-	return *reinterpret_cast<float*>(p);
+	auto bits = deserialize32be(buf);
+	float ret{};
+	static_assert(sizeof(ret) == sizeof(bits), "float is not 32 bit");
+	std::memcpy(&ret, &bits, sizeof(ret));
+	return ret;
+}
+
+/**
+ * @brief Serialize double to IEEE 754, big-endian.
+ * @param value - double value to serialize.
+ * @param out_buf - pointer to the 8 byte buffer where the result will be placed.
+ * @return pointer to the next byte after serialized value.
+ */
+inline uint8_t* serialize_double_be(double value, uint8_t* out_buf) noexcept
+{
+	static_assert(sizeof(value) == sizeof(uint64_t), "double is not 64 bit");
+	uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(value));
+	return serialize64be(bits, out_buf);
+}
+
+/**
+ * @brief De-serialize IEEE 754 double precision floating point value, big-endian.
+ * @param buf - pointer to buffer containing 8 bytes to convert from IEEE 754 big-endian format.
+ * @return floating point value.
+ */
+inline double deserialize_double_be(const uint8_t* buf) noexcept
+{
+	auto bits = deserialize64be(buf);
+	double ret{};
+	static_assert(sizeof(ret) == sizeof(bits), "double is not 64 bit");
+	std::memcpy(&ret, &bits, sizeof(ret));
+	return ret;
+}
+
+/**
+ * @brief Number of value bits in each byte of LEB128 encoded value.
+ */
+constexpr unsigned varint_payload_bits = 7;
+
+/**
+ * @brief Bit which is set in all bytes of LEB128 encoded value except the last one.
+ */
+constexpr uint8_t varint_continuation_bit = 0x80;
+
+/**
+ * @brief Maximum size of LEB128 encoded unsigned integral value.
+ * @tparam unsigned_type - type of the value.
+ */
+template <typename unsigned_type>
+constexpr size_t max_varuint_size = (sizeof(unsigned_type) * byte_bits + varint_payload_bits - 1) / varint_payload_bits;
+
+/**
+ * @brief Zigzag encode signed integral value.
+ * Maps signed values to unsigned ones so that values of small magnitude get small unsigned values:
+ * 0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3, etc.
+ * @param value - value to encode.
+ * @return Zigzag encoded value.
+ */
+template <typename signed_type>
+constexpr std::make_unsigned_t<signed_type> zigzag_encode(signed_type value) noexcept
+{
+	static_assert(std::is_integral_v<signed_type>, "encoded type must be integral");
+	static_assert(std::is_signed_v<signed_type>, "encoded type must be signed");
+
+	using unsigned_type = std::make_unsigned_t<signed_type>;
+
+	// NOLINTNEXTLINE(hicpp-signed-bitwise)
+	auto sign = unsigned_type(value >> (sizeof(value) * byte_bits - 1));
+	return unsigned_type(unsigned_type(unsigned_type(value) << 1) ^ sign);
+}
+
+/**
+ * @brief Zigzag decode signed integral value.
+ * Inverse of zigzag_encode().
+ * @param value - zigzag encoded value.
+ * @return Decoded value.
+ */
+template <typename unsigned_type>
+constexpr std::make_signed_t<unsigned_type> zigzag_decode(unsigned_type value) noexcept
+{
+	static_assert(std::is_integral_v<unsigned_type>, "decoded type must be integral");
+	static_assert(std::is_unsigned_v<unsigned_type>, "decoded type must be unsigned");
+
+	auto sign = unsigned_type(-unsigned_type(value & 1));
+	return std::make_signed_t<unsigned_type>(unsigned_type(value >> 1) ^ sign);
+}
+
+/**
+ * @brief Get size of LEB128 encoded unsigned integral value.
+ * @param value - value to get encoded size of.
+ * @return Number of bytes serialize_varuint() writes for the value.
+ */
+template <typename unsigned_type>
+constexpr size_t varuint_size(unsigned_type value) noexcept
+{
+	static_assert(std::is_integral_v<unsigned_type>, "serialized type must be integral");
+	static_assert(std::is_unsigned_v<unsigned_type>, "serialized type must be unsigned");
+
+	size_t ret = 1;
+	for (; value >= varint_continuation_bit; value = unsigned_type(value >> varint_payload_bits)) {
+		++ret;
+	}
+	return ret;
+}
+
+/**
+ * @brief Serialize unsigned integral value, LEB128 variable length encoding.
+ * @param value - value to serialize.
+ * @param out_buf - output buffer, must be at least varuint_size(value) bytes long.
+ * @return Pointer to the next byte after serialized value.
+ */
+template <typename unsigned_type>
+uint8_t* serialize_varuint(unsigned_type value, uint8_t* out_buf) noexcept
+{
+	static_assert(std::is_integral_v<unsigned_type>, "serialized type must be integral");
+	static_assert(std::is_unsigned_v<unsigned_type>, "serialized type must be unsigned");
+
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (; value >= varint_continuation_bit; value = unsigned_type(value >> varint_payload_bits)) {
+		*out_buf = uint8_t(value | varint_continuation_bit);
+		++out_buf;
+	}
+	*out_buf = uint8_t(value);
+	return out_buf + 1;
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+/**
+ * @brief Serialize signed integral value, zigzag LEB128 variable length encoding.
+ * @param value - value to serialize.
+ * @param out_buf - output buffer, must be at least varuint_size(zigzag_encode(value)) bytes long.
+ * @return Pointer to the next byte after serialized value.
+ */
+template <typename signed_type>
+uint8_t* serialize_varint(signed_type value, uint8_t* out_buf) noexcept
+{
+	return serialize_varuint(zigzag_encode(value), out_buf);
+}
+
+/**
+ * @brief Deserialize unsigned integral value, LEB128 variable length encoding.
+ * @param buf - buffer to deserialize from.
+ * @param out_value - the deserialized value is written here.
+ * @return Number of bytes the encoded value occupies.
+ * @return 0 in case the buffer does not start with a complete encoded value
+ *         or the value does not fit into the unsigned_type.
+ */
+template <typename unsigned_type>
+size_t deserialize_varuint(utki::span<const uint8_t> buf, unsigned_type& out_value) noexcept
+{
+	static_assert(std::is_integral_v<unsigned_type>, "deserialized type must be integral");
+	static_assert(std::is_unsigned_v<unsigned_type>, "deserialized type must be unsigned");
+
+	constexpr auto max_size = max_varuint_size<unsigned_type>;
+
+	// number of value bits in the last byte of the longest possible encoded value
+	constexpr auto last_byte_bits = sizeof(unsigned_type) * byte_bits - varint_payload_bits * (max_size - 1);
+
+	unsigned_type value = 0;
+
+	for (size_t i = 0; i != std::min(buf.size(), max_size); ++i) {
+		auto b = buf[i];
+
+		if (i == max_size - 1 && (b >> last_byte_bits) != 0) {
+			// value does not fit into the unsigned_type
+			return 0;
+		}
+
+		value |= unsigned_type(unsigned_type(b & ~varint_continuation_bit) << (varint_payload_bits * i));
+
+		if ((b & varint_continuation_bit) == 0) {
+			out_value = value;
+			return i + 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Deserialize signed integral value, zigzag LEB128 variable length encoding.
+ * @param buf - buffer to deserialize from.
+ * @param out_value - the deserialized value is written here.
+ * @return Number of bytes the encoded value occupies.
+ * @return 0 in case the buffer does not start with a complete encoded value
+ *         or the value does not fit into the signed_type.
+ */
+template <typename signed_type>
+size_t deserialize_varint(utki::span<const uint8_t> buf, signed_type& out_value) noexcept
+{
+	std::make_unsigned_t<signed_type> value = 0;
+	auto ret = deserialize_varuint(buf, value);
+	if (ret != 0) {
+		out_value = zigzag_decode(value);
+	}
+	return ret;
 }
 
 /**
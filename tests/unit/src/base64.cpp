@@ -32,5 +32,224 @@ const tst::set set("base64", [](tst::suite& suite) {
 			tst::check(res == p.second, SL);
 		}
 	);
+
+	suite.add<std::pair<std::string_view, size_t>>( //
+		"decode_invalid_string",
+		{
+			{"SGVsbG8gd2=ybGQh"sv, 10},
+			{"SGVsbG8gd29yb GQh"sv, 13},
+			{"SGVsbG8gd29ybGQ\n"sv, 15},
+			{"SGVsbG8-"sv, 7},
+			{"SGVsbA="sv, 6},
+			{"SGVs="sv, 4},
+			{"SA="sv, 2},
+			{"S"sv, 1},
+			{"SGVsb"sv, 5},
+			{"S==="sv, 1}
+    },
+		[](const auto& p) {
+			std::array<uint8_t, 32> buf{};
+			auto res = utki::base64_decode(p.first, utki::make_span(buf));
+			tst::check(res.ec == std::errc::invalid_argument, SL);
+			tst::check_eq(res.offset, p.second, SL);
+
+			bool thrown = false;
+			try {
+				utki::base64_decode(p.first);
+				tst::check(false, SL);
+			} catch (std::invalid_argument&) {
+				thrown = true;
+			}
+			tst::check(thrown, SL);
+		}
+	);
+
+	suite.add("decode_into_span", []() {
+		std::array<uint8_t, 12> buf{};
+
+		auto res = utki::base64_decode("SGVsbG8gd29ybGQh"sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(res.num_bytes, size_t(12), SL);
+		tst::check_eq(res.offset, size_t(16), SL);
+		tst::check(utki::deep_equals(utki::make_span(buf), utki::to_uint8_t(utki::make_span("Hello world!"sv))), SL);
+
+		res = utki::base64_decode("SGVsbG8gd29ybGQhIQ=="sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc::value_too_large, SL);
+		tst::check_eq(res.num_bytes, size_t(0), SL);
+	});
+
+	suite.add("decode_url_alphabet", []() {
+		auto expected = std::vector<uint8_t>{0xfb, 0xff, 0xbf, 0xfb};
+
+		tst::check(utki::base64_decode("-_-_-w"sv, utki::base64_alphabet::url) == expected, SL);
+		tst::check(utki::base64_decode("-_-_-w=="sv, utki::base64_alphabet::url) == expected, SL);
+		tst::check(utki::base64_decode("+/+/+w=="sv) == expected, SL);
+
+		std::array<uint8_t, 4> buf{};
+		auto res = utki::base64_decode("+/+/+w=="sv, utki::make_span(buf), utki::base64_alphabet::url);
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check_eq(res.offset, size_t(0), SL);
+	});
+
+	suite.add<std::pair<std::string_view, size_t>>( //
+		"decoded_size",
+		{
+			{""sv, 0},
+			{"SA=="sv, 1},
+			{"SA"sv, 1},
+			{"SGU="sv, 2},
+			{"SGU"sv, 2},
+			{"SGVs"sv, 3},
+			{"SGVsbG8gd29ybGQh"sv, 12}
+    },
+		[](const auto& p) {
+			tst::check_eq(utki::base64_decoded_size(p.first), p.second, SL);
+		}
+	);
+
+	suite.add<std::pair<std::string_view, std::string_view>>( //
+		"encode_samples",
+		{
+			{              ""sv,               ""sv},
+			{             "H"sv,           "SA=="sv},
+			{            "He"sv,           "SGU="sv},
+			{           "Hel"sv,           "SGVs"sv},
+			{          "Hell"sv,       "SGVsbA=="sv},
+			{         "Hello"sv,       "SGVsbG8="sv},
+			{        "Hello "sv,       "SGVsbG8g"sv},
+			{  "Hello world!"sv, "SGVsbG8gd29ybGQh"sv},
+			{"\xfb\xff\xbf"sv,           "+/+/"sv}
+    },
+		[](const auto& p) {
+			auto res = utki::base64_encode(utki::to_uint8_t(utki::make_span(p.first)));
+			tst::check_eq(res, std::string(p.second), SL);
+		}
+	);
+
+	suite.add("encode_url_alphabet_without_padding", []() {
+		auto data = utki::to_uint8_t(utki::make_span("\xfb\xff\xbf\xfb"sv));
+
+		tst::check_eq(utki::base64_encode(data, utki::base64_alphabet::url, false), std::string("-_-_-w"), SL);
+		tst::check_eq(utki::base64_encode(data, utki::base64_alphabet::url, true), std::string("-_-_-w=="), SL);
+		tst::check_eq(utki::base64_encode(data, utki::base64_alphabet::standard, false), std::string("+/+/+w"), SL);
+	});
+
+	suite.add("encode_long_data", []() {
+		std::vector<uint8_t> data;
+		for (unsigned i = 0; i != 1000; ++i) {
+			data.push_back(uint8_t(i * 7));
+		}
+
+		for (size_t size = 0; size != data.size(); ++size) {
+			auto span = utki::make_span(data).subspan(0, size);
+			auto encoded = utki::base64_encode(span);
+			tst::check_eq(encoded.size(), utki::base64_encoded_size(size), SL);
+			tst::check(utki::base64_decode(encoded) == std::vector<uint8_t>(span.begin(), span.end()), SL)
+				<< "size = " << size;
+		}
+	});
+
+	suite.add("encode_into_span", []() {
+		auto data = utki::to_uint8_t(utki::make_span("Hello"sv));
+
+		std::array<char, 8> buf{};
+		auto num_chars = utki::base64_encode(data, utki::make_span(buf));
+		tst::check_eq(num_chars, size_t(8), SL);
+		tst::check_eq(std::string_view(buf.data(), num_chars), "SGVsbG8="sv, SL);
+
+		num_chars = utki::base64_encode(data, utki::make_span(buf), utki::base64_alphabet::standard, false);
+		tst::check_eq(num_chars, size_t(7), SL);
+		tst::check_eq(std::string_view(buf.data(), num_chars), "SGVsbG8"sv, SL);
+
+		bool thrown = false;
+		try {
+			utki::base64_encode(data, utki::make_span(buf).subspan(0, 7));
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+	});
+
+	suite.add("streaming_encoder", []() {
+		auto data = utki::to_uint8_t(utki::make_span("Hello world!!"sv));
+
+		for (size_t chunk_size = 1; chunk_size != data.size() + 1; ++chunk_size) {
+			utki::base64_encoder encoder;
+			std::string str;
+
+			for (auto chunk = data; !chunk.empty();) {
+				auto c = chunk.subspan(0, std::min(chunk_size, chunk.size()));
+				chunk = chunk.subspan(c.size());
+
+				std::string buf(encoder.encoded_size(c.size()), '\0');
+				tst::check_eq(encoder.encode(c, utki::make_span(buf)), buf.size(), SL);
+				str.append(buf);
+			}
+
+			std::array<char, utki::base64_encoder::max_finish_size> buf{};
+			auto num_chars = encoder.finish(utki::make_span(buf));
+			str.append(buf.data(), num_chars);
+
+			tst::check_eq(str, std::string("SGVsbG8gd29ybGQhIQ=="), SL) << "chunk_size = " << chunk_size;
+		}
+	});
+
+	suite.add("streaming_decoder", []() {
+		auto str = "SGVsbG8gd29ybGQhIQ=="sv;
+
+		for (size_t chunk_size = 1; chunk_size != str.size() + 1; ++chunk_size) {
+			utki::base64_decoder decoder;
+			std::vector<uint8_t> data;
+
+			for (auto chunk = str; !chunk.empty();) {
+				auto c = chunk.substr(0, chunk_size);
+				chunk = chunk.substr(c.size());
+
+				std::vector<uint8_t> buf(decoder.decoded_size(c.size()));
+				auto res = decoder.decode(c, utki::make_span(buf));
+				tst::check(res.ec == std::errc(), SL);
+				data.insert(data.end(), buf.begin(), std::next(buf.begin(), ptrdiff_t(res.num_bytes)));
+			}
+
+			std::array<uint8_t, utki::base64_decoder::max_finish_size> buf{};
+			auto res = decoder.finish(utki::make_span(buf));
+			tst::check(res.ec == std::errc(), SL);
+			tst::check_eq(res.offset, str.size(), SL);
+			data.insert(data.end(), buf.begin(), std::next(buf.begin(), ptrdiff_t(res.num_bytes)));
+
+			auto expected = utki::to_uint8_t(utki::make_span("Hello world!!"sv));
+			tst::check(utki::deep_equals(utki::make_span(data), expected), SL) << "chunk_size = " << chunk_size;
+		}
+	});
+
+	suite.add("streaming_decoder_invalid_string", []() {
+		utki::base64_decoder decoder;
+		std::array<uint8_t, 16> buf{};
+
+		auto res = decoder.decode("SGVs"sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(res.num_bytes, size_t(3), SL);
+
+		res = decoder.decode("bG8g*29y"sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check_eq(res.offset, size_t(8), SL);
+
+		decoder.reset();
+
+		res = decoder.decode("SGVsbA="sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc(), SL);
+		res = decoder.finish(utki::make_span(buf));
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check_eq(res.offset, size_t(6), SL);
+
+		decoder.reset();
+
+		res = decoder.decode("SGVsbA="sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc(), SL);
+		res = decoder.decode("=S"sv, utki::make_span(buf));
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check_eq(res.offset, size_t(6), SL);
+	});
 });
 } // namespace
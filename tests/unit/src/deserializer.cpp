@@ -203,6 +203,379 @@ const tst::set set("deserializer", [](tst::suite& suite) {
 		}
 	);
 
+	suite.add<std::pair<double, std::array<uint8_t, 8>>>( //
+		"read_double_le",
+		// clang-format off
+		{
+			{ 13, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0x40}},
+			{ 13666, {0x00, 0x00, 0x00, 0x00, 0x00, 0xb1, 0xca, 0x40}},
+			{ 13666e100, {0x5e, 0x7b, 0x81, 0x68, 0x08, 0x82, 0x8e, 0x55}},
+			{ 13.666, {0xa2, 0x45, 0xb6, 0xf3, 0xfd, 0x54, 0x2b, 0x40}},
+			{ -13, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0xc0}},
+			{ -13666, {0x00, 0x00, 0x00, 0x00, 0x00, 0xb1, 0xca, 0xc0}},
+			{ -13666e100, {0x5e, 0x7b, 0x81, 0x68, 0x08, 0x82, 0x8e, 0xd5}},
+			{ -13.666, {0xa2, 0x45, 0xb6, 0xf3, 0xfd, 0x54, 0x2b, 0xc0}},
+		},
+		// clang-format on
+		[](const auto& p) {
+			std::array<uint8_t, 8> buf{};
+			utki::serialize_double_le(p.first, buf.data());
+
+			tst::check(buf == p.second, SL);
+
+			utki::deserializer d(buf);
+
+			double f = d.read_double_le();
+
+			tst::check_eq(f, p.first, SL);
+			tst::check(d.empty(), SL);
+			tst::check_eq(d.size(), size_t(0), SL);
+		}
+	);
+
+	suite.add<std::pair<double, std::array<uint8_t, 8>>>( //
+		"read_double_be",
+		// clang-format off
+		{
+			{ 13, {0x40, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			{ 13666, {0x40, 0xca, 0xb1, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			{ 13666e100, {0x55, 0x8e, 0x82, 0x08, 0x68, 0x81, 0x7b, 0x5e}},
+			{ 13.666, {0x40, 0x2b, 0x54, 0xfd, 0xf3, 0xb6, 0x45, 0xa2}},
+			{ -13, {0xc0, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			{ -13666, {0xc0, 0xca, 0xb1, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			{ -13666e100, {0xd5, 0x8e, 0x82, 0x08, 0x68, 0x81, 0x7b, 0x5e}},
+			{ -13.666, {0xc0, 0x2b, 0x54, 0xfd, 0xf3, 0xb6, 0x45, 0xa2}},
+		},
+		// clang-format on
+		[](const auto& p) {
+			std::array<uint8_t, 8> buf{};
+			utki::serialize_double_be(p.first, buf.data());
+
+			tst::check(buf == p.second, SL);
+
+			utki::deserializer d(buf);
+
+			double f = d.read_double_be();
+
+			tst::check_eq(f, p.first, SL);
+			tst::check(d.empty(), SL);
+			tst::check_eq(d.size(), size_t(0), SL);
+		}
+	);
+
+	suite.add("read_array", []() {
+		std::vector<uint8_t> buf = {
+			0xa1, 0xb2, // uint16
+			0xa1, 0xb2, 0xc3, 0xd4, // uint32
+			0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6, 0x17, 0x28, // uint64
+			0x00, 0x00, 0x50, 0xc1, // float
+			0x41, 0x50, 0x00, 0x00, // float
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0xc0, // double
+			0xff, 0xfe, // int16
+			0x13, // extra byte
+		};
+
+		utki::deserializer d(buf);
+
+		std::array<uint16_t, 1> u16{};
+		std::array<uint32_t, 1> u32{};
+		std::array<uint64_t, 1> u64{};
+		std::array<float, 1> f_le{};
+		std::array<float, 1> f_be{};
+		std::array<double, 1> d_le{};
+		std::array<int16_t, 1> i16{};
+
+		d.read_array_be(utki::make_span(u16));
+		d.read_array_le(utki::make_span(u32));
+		d.read_array_be(utki::make_span(u64));
+		d.read_array_le(utki::make_span(f_le));
+		d.read_array_be(utki::make_span(f_be));
+		d.read_array_le(utki::make_span(d_le));
+		d.read_array_be(utki::make_span(i16));
+
+		tst::check_eq(u16[0], uint16_t(0xa1b2), SL);
+		tst::check_eq(u32[0], uint32_t(0xd4c3b2a1), SL);
+		tst::check_eq(u64[0], uint64_t(0xa1b2c3d4e5f61728), SL);
+		tst::check_eq(f_le[0], -13.0f, SL);
+		tst::check_eq(f_be[0], 13.0f, SL);
+		tst::check_eq(d_le[0], -13.0, SL);
+		tst::check_eq(i16[0], int16_t(-2), SL);
+		tst::check_eq(d.size(), size_t(1), SL);
+
+		std::array<uint8_t, 2> u8{};
+
+		bool thrown = false;
+		try {
+			d.read_array_le(utki::make_span(u8));
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+		tst::check_eq(d.size(), size_t(1), SL);
+
+		d.read_array_le(utki::make_span(u8).subspan(1));
+		tst::check_eq(u8[1], uint8_t(0x13), SL);
+		tst::check(d.empty(), SL);
+	});
+
+	// arrays long enough to be processed by SIMD code, with tails of various length
+	suite.add<size_t>( //
+		"read_array_long",
+		{0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100, 1001},
+		[](const auto& num_values) {
+			std::vector<uint8_t> buf(num_values * sizeof(uint64_t));
+			for (size_t i = 0; i != buf.size(); ++i) {
+				buf[i] = uint8_t(i * 7 + 3);
+			}
+
+			auto check_array = [&](auto value) {
+				using value_type = decltype(value);
+
+				std::vector<value_type> le(buf.size() / sizeof(value_type));
+				std::vector<value_type> be(le.size());
+
+				utki::deserializer d_le(buf);
+				d_le.read_array_le(utki::make_span(le));
+				tst::check(d_le.empty(), SL);
+
+				utki::deserializer d_be(buf);
+				d_be.read_array_be(utki::make_span(be));
+				tst::check(d_be.empty(), SL);
+
+				for (size_t i = 0; i != le.size(); ++i) {
+					const auto* p = &buf[i * sizeof(value_type)];
+					tst::check_eq(le[i], utki::deserialize_le<value_type>(p), SL);
+					tst::check_eq(be[i], utki::deserialize_be<value_type>(p), SL);
+				}
+			};
+
+			check_array(uint8_t());
+			check_array(uint16_t());
+			check_array(uint32_t());
+			check_array(uint64_t());
+		}
+	);
+
+	suite.add("read_varint", []() {
+		std::vector<uint8_t> buf = {
+			0xac, 0x02, // 300
+			0x03, // -2 zigzag
+			0xff, 0xff, 0xff, 0xff, 0x0f, // 0xffffffff
+			0x80, // truncated
+		};
+
+		utki::deserializer d(buf);
+
+		tst::check_eq(d.read_varuint<uint16_t>(), uint16_t(300), SL);
+		tst::check_eq(d.read_varint<int64_t>(), int64_t(-2), SL);
+
+		bool thrown = false;
+		try {
+			d.read_varuint<uint16_t>();
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+
+		tst::check_eq(d.read_varuint<uint32_t>(), uint32_t(0xffffffff), SL);
+
+		thrown = false;
+		try {
+			d.read_varuint<uint32_t>();
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+		tst::check_eq(d.size(), size_t(1), SL);
+	});
+
+	// arrays long enough to be processed block-wise, with values of various encoded sizes
+	suite.add<std::pair<size_t, unsigned>>( //
+		"read_varuint_array",
+		{
+			{0, 0},
+			{1, 7},
+			{15, 7},
+			{16, 7},
+			{17, 7},
+			{100, 7},
+			{1000, 7},
+			{1000, 8},
+			{1000, 14},
+			{1000, 20},
+			{1000, 32},
+			{1000, 40},
+			{1000, 64},
+		},
+		[](const auto& p) {
+			auto num_values = p.first;
+			auto max_bits = p.second;
+
+			std::vector<uint64_t> values;
+			std::vector<int64_t> signed_values;
+			std::vector<uint8_t> buf;
+			uint64_t x = 0x123456789abcdef;
+			for (size_t i = 0; i != num_values; ++i) {
+				x = x * 6364136223846793005 + 1442695040888963407;
+				auto v = max_bits == 0 ? 0 : (x >> (64 - max_bits)) >> (x % max_bits);
+				values.push_back(v);
+				signed_values.push_back(int64_t(v) >> 1);
+
+				std::array<uint8_t, utki::max_varuint_size<uint64_t>> b{};
+				auto end = utki::serialize_varuint(v, b.data());
+				buf.insert(buf.end(), b.data(), end);
+			}
+
+			std::vector<uint64_t> out(num_values);
+			utki::deserializer d(buf);
+			d.read_varuint_array(utki::make_span(out));
+			tst::check(d.empty(), SL);
+			tst::check(out == values, SL);
+
+			if (max_bits <= 32) {
+				std::vector<uint32_t> out32(num_values);
+				utki::deserializer d32(buf);
+				d32.read_varuint_array(utki::make_span(out32));
+				tst::check(d32.empty(), SL);
+				tst::check(std::equal(out32.begin(), out32.end(), values.begin()), SL);
+			} else if (num_values != 0) {
+				std::vector<uint32_t> out32(num_values);
+				utki::deserializer d32(buf);
+				bool thrown = false;
+				try {
+					d32.read_varuint_array(utki::make_span(out32));
+					tst::check(false, SL);
+				} catch (std::invalid_argument&) {
+					thrown = true;
+				}
+				tst::check(thrown, SL);
+				tst::check_eq(d32.size(), buf.size(), SL);
+			}
+
+			std::vector<int64_t> signed_out(num_values);
+			std::vector<uint8_t> signed_buf;
+			for (auto v : signed_values) {
+				std::array<uint8_t, utki::max_varuint_size<uint64_t>> b{};
+				auto end = utki::serialize_varint(v, b.data());
+				signed_buf.insert(signed_buf.end(), b.data(), end);
+			}
+			utki::deserializer ds(signed_buf);
+			ds.read_varint_array(utki::make_span(signed_out));
+			tst::check(ds.empty(), SL);
+			tst::check(signed_out == signed_values, SL);
+
+			// one more value than there is in the buffer
+			std::vector<uint64_t> too_many(num_values + 1);
+			utki::deserializer dt(buf);
+			bool thrown = false;
+			try {
+				dt.read_varuint_array(utki::make_span(too_many));
+				tst::check(false, SL);
+			} catch (std::invalid_argument&) {
+				thrown = true;
+			}
+			tst::check(thrown, SL);
+		}
+	);
+
+	suite.add("checked_deserializer", []() {
+		std::vector<uint8_t> buf = {
+			0x03, 'a', 'b', 'c', // string
+			0xa1, // uint8
+			0xb2, 0xa1, // uint16 be
+			0xa1, 0xb2, 0xc3, 0xd4, // uint32 le
+			0x00, 0x00, 0x50, 0x41, // float le
+			0xac, 0x02, // varuint
+			0x03, // varint
+			0xa1, 0xb2, 0xa1, 0xb2 // array of uint16 le
+		};
+
+		utki::checked_deserializer d(buf);
+
+		auto str = d.read_string(d.read_uint8());
+		auto u8 = d.read_uint8();
+		auto u16 = d.read_uint16_be();
+		auto u32 = d.read_uint32_le();
+		auto f = d.read_float_le();
+		auto vu = d.read_varuint<uint32_t>();
+		auto vi = d.read_varint<int32_t>();
+		std::array<uint16_t, 2> arr{};
+		d.read_array_le(utki::make_span(arr));
+
+		tst::check(!d.error(), SL);
+		tst::check(d.empty(), SL);
+
+		tst::check_eq(str, "abc"sv, SL);
+		tst::check_eq(u8, uint8_t(0xa1), SL);
+		tst::check_eq(u16, uint16_t(0xb2a1), SL);
+		tst::check_eq(u32, uint32_t(0xd4c3b2a1), SL);
+		tst::check_eq(f, 13.0f, SL);
+		tst::check_eq(vu, uint32_t(300), SL);
+		tst::check_eq(vi, int32_t(-2), SL);
+		tst::check_eq(arr[0], uint16_t(0xb2a1), SL);
+		tst::check_eq(arr[1], uint16_t(0xb2a1), SL);
+	});
+
+	suite.add("checked_deserializer_sticky_error", []() {
+		std::vector<uint8_t> buf = {0xa1, 0xb2, 0xc3, 0xd4, 0xe5};
+
+		utki::checked_deserializer d(buf);
+
+		tst::check_eq(d.read_uint16_le(), uint16_t(0xb2a1), SL);
+		tst::check(!d.error(), SL);
+
+		// not enough data
+		tst::check_eq(d.read_uint64_be(), uint64_t(0), SL);
+		tst::check(d.error(), SL);
+
+		// there would be enough data for these reads, but the error is sticky
+		tst::check_eq(d.read_uint8(), uint8_t(0), SL);
+		tst::check_eq(d.read_double_le(), 0.0, SL);
+		tst::check(d.read_span(1).empty(), SL);
+		tst::check(d.read_string(1).empty(), SL);
+
+		std::array<uint32_t, 2> arr = {1, 2};
+		d.read_array_be(utki::make_span(arr));
+		tst::check_eq(arr[0], uint32_t(0), SL);
+		tst::check_eq(arr[1], uint32_t(0), SL);
+
+		tst::check(d.error(), SL);
+		tst::check(d.empty(), SL);
+	});
+
+	suite.add("checked_deserializer_malformed_varint", []() {
+		std::vector<uint8_t> buf = {0x01, 0x02, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01};
+
+		{
+			utki::checked_deserializer d(buf);
+			tst::check_eq(d.read_varuint<uint32_t>(), uint32_t(1), SL);
+			tst::check_eq(d.read_varint<int32_t>(), int32_t(1), SL);
+			tst::check(!d.error(), SL);
+			tst::check_eq(d.read_varuint<uint32_t>(), uint32_t(0), SL);
+			tst::check(d.error(), SL);
+		}
+
+		{
+			utki::checked_deserializer d(buf);
+			std::array<uint32_t, 3> arr = {1, 2, 3};
+			d.read_varuint_array(utki::make_span(arr));
+			tst::check(d.error(), SL);
+			tst::check(arr == (std::array<uint32_t, 3>{0, 0, 0}), SL);
+		}
+
+		{
+			utki::checked_deserializer d(buf);
+			std::array<int64_t, 3> arr = {};
+			d.read_varint_array(utki::make_span(arr));
+			tst::check(!d.error(), SL);
+			tst::check(d.empty(), SL);
+			tst::check(arr == (std::array<int64_t, 3>{-1, 1, -34'359'738'368}), SL);
+		}
+	});
+
 	suite.add("skip", []() {
 		auto str = "bbbHello world!ccc"sv;
 
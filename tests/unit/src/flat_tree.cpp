@@ -0,0 +1,182 @@
+#include <tst/check.hpp>
+#include <tst/set.hpp>
+#include <utki/flat_tree.hpp>
+
+namespace {
+using tree = utki::tree<int>;
+
+tree::container_type make_sample_trees()
+{
+	return {
+		tree(1, {34, 45}),
+		tree( //
+			2,
+			{//
+			 tree(3, {78, 89, 96}),
+			 tree(4, {32, 64, 128}),
+			 tree(42, {98, 99, 100})
+			}
+		)
+	};
+}
+} // namespace
+
+namespace {
+const tst::set set("flat_tree", [](tst::suite& suite) {
+	suite.add("construction_from_trees_is_pre_order", []() {
+		const utki::flat_tree<int> ft(make_sample_trees());
+
+		const std::vector<int> expected = {1, 34, 45, 2, 3, 78, 89, 96, 4, 32, 64, 128, 42, 98, 99, 100};
+
+		tst::check_eq(ft.size(), expected.size(), SL);
+		tst::check(std::equal(ft.values().begin(), ft.values().end(), expected.begin(), expected.end()), SL);
+
+		std::vector<int> encountered;
+		for (auto i = ft.cbegin(); i != ft.cend(); ++i) {
+			encountered.push_back(*i);
+		}
+		tst::check(encountered == expected, SL);
+	});
+
+	suite.add("construction_from_single_tree", []() {
+		const utki::flat_tree<int> ft(tree(13, {tree(1, {2, 3}), 4}));
+
+		tst::check_eq(ft.size(), size_t(5), SL);
+		tst::check_eq(ft.cbegin().subtree_size(), size_t(5), SL);
+		tst::check_eq(ft[{0, 0, 1}], 3, SL);
+		tst::check_eq(ft[{0, 1}], 4, SL);
+	});
+
+	suite.add("conversion_to_trees", []() {
+		const auto trees = make_sample_trees();
+
+		const utki::flat_tree<int> ft(trees);
+
+		tst::check(ft.to_trees() == trees, SL);
+		tst::check(utki::flat_tree<int>().to_trees().empty(), SL);
+	});
+
+	suite.add("reverse_traversal", []() {
+		utki::flat_tree<int> ft(make_sample_trees());
+
+		std::vector<int> encountered;
+		for (auto i = ft.rbegin(); i != ft.rend(); ++i) {
+			encountered.push_back(*i);
+		}
+
+		const std::vector<int> expected = {100, 99, 98, 42, 128, 64, 32, 4, 96, 89, 78, 3, 2, 45, 34, 1};
+		tst::check(encountered == expected, SL);
+	});
+
+	suite.add("skip_subtree", []() {
+		const utki::flat_tree<int> ft(make_sample_trees());
+
+		std::vector<int> encountered;
+		for (auto i = ft.cbegin(); i != ft.cend();) {
+			encountered.push_back(*i);
+			if (*i == 3 || *i == 1) {
+				i.skip_subtree();
+			} else {
+				++i;
+			}
+		}
+
+		const std::vector<int> expected = {1, 2, 3, 4, 32, 64, 128, 42, 98, 99, 100};
+		tst::check(encountered == expected, SL);
+	});
+
+	suite.add("index_depth_and_at_level", []() {
+		utki::flat_tree<int> ft(make_sample_trees());
+
+		for (auto i = ft.begin(); i != ft.end(); ++i) {
+			auto index = i.index();
+			tst::check(ft.is_valid(utki::make_span(index)), SL);
+			tst::check(ft.make_iterator(utki::make_span(index)) == i, SL);
+			tst::check_eq(i.depth(), index.size(), SL);
+		}
+
+		auto i = ft.make_iterator({1, 2, 2});
+		tst::check_eq(*i, 100, SL);
+		tst::check(i.index() == std::vector<size_t>{1, 2, 2}, SL);
+		tst::check_eq(i.at_level(0), 2, SL);
+		tst::check_eq(i.at_level(1), 42, SL);
+		tst::check_eq(i.at_level(2), 100, SL);
+		tst::check(i.is_last_child(), SL);
+		tst::check(!ft.make_iterator({1, 1}).is_last_child(), SL);
+		tst::check(ft.make_iterator({1}).is_last_child(), SL);
+
+		bool thrown = false;
+		try {
+			i.at_level(3);
+		} catch (std::out_of_range&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+
+		tst::check_eq(ft.end().depth(), size_t(0), SL);
+		tst::check(ft.end().index().empty(), SL);
+	});
+
+	suite.add("check_index_is_valid", []() {
+		const utki::flat_tree<int> ft(make_sample_trees());
+
+		tst::check(!ft.is_valid(utki::span<size_t>()), SL);
+		tst::check(ft.is_valid({0}), SL);
+		tst::check(ft.is_valid({0, 0}), SL);
+		tst::check(ft.is_valid({0, 1}), SL);
+		tst::check(!ft.is_valid({0, 1, 0}), SL);
+		tst::check(!ft.is_valid({0, 2}), SL);
+		tst::check(ft.is_valid({1}), SL);
+		tst::check(ft.is_valid({1, 0}), SL);
+		tst::check(ft.is_valid({1, 0, 0}), SL);
+		tst::check(ft.is_valid({1, 1, 0}), SL);
+		tst::check(!ft.is_valid({1, 1, 0, 2}), SL);
+		tst::check(!ft.is_valid({3, 1}), SL);
+
+		bool thrown = false;
+		try {
+			ft.make_const_iterator({1, 3});
+		} catch (std::out_of_range&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+	});
+
+	suite.add("insert_insert_after_and_erase", []() {
+		auto trees = make_sample_trees();
+		utki::flat_tree<int> ft(trees);
+
+		auto i = ft.insert(ft.make_iterator({1, 1}), tree(5, {6}));
+		tst::check_eq(*i, 5, SL);
+		trees[1].children.insert(std::next(trees[1].children.begin()), tree(5, {6}));
+		tst::check(ft.to_trees() == trees, SL);
+		tst::check(ft == utki::flat_tree<int>(trees), SL);
+
+		i = ft.insert_after(ft.make_iterator({0}), tree(7, {8, 9}));
+		tst::check_eq(*i, 7, SL);
+		trees.insert(std::next(trees.begin()), tree(7, {8, 9}));
+		tst::check(ft == utki::flat_tree<int>(trees), SL);
+
+		i = ft.push_back(tree(10));
+		tst::check_eq(*i, 10, SL);
+		trees.emplace_back(10);
+		tst::check(ft == utki::flat_tree<int>(trees), SL);
+
+		i = ft.erase(ft.make_iterator({2, 0}));
+		tst::check_eq(*i, 5, SL);
+		trees[2].children.erase(trees[2].children.begin());
+		tst::check(ft == utki::flat_tree<int>(trees), SL);
+
+		i = ft.erase(ft.make_iterator({2, 2}));
+		tst::check_eq(*i, 10, SL);
+		trees[2].children.pop_back();
+		tst::check(ft == utki::flat_tree<int>(trees), SL);
+
+		i = ft.erase(ft.make_iterator({3}));
+		tst::check(i == ft.end(), SL);
+		trees.pop_back();
+		tst::check(ft == utki::flat_tree<int>(trees), SL);
+		tst::check(ft.to_trees() == trees, SL);
+	});
+});
+} // namespace
@@ -0,0 +1,165 @@
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+
+#include <tst/check.hpp>
+#include <tst/set.hpp>
+#include <utki/parallel_tree.hpp>
+
+namespace {
+using tree = utki::tree<int>;
+
+// make a tree with every node having num_children children, down to the given depth
+void fill(tree::container_type& list, size_t num_children, size_t depth, int& value)
+{
+	if (depth == 0) {
+		return;
+	}
+	for (size_t i = 0; i != num_children; ++i) {
+		list.emplace_back(value++);
+		fill(list.back().children, num_children, depth - 1, value);
+	}
+}
+
+tree::container_type make_tree(size_t num_children, size_t depth)
+{
+	tree::container_type ret;
+	int value = 0;
+	fill(ret, num_children, depth, value);
+	return ret;
+}
+
+int sum_subtree(const tree& t)
+{
+	return std::accumulate(t.children.begin(), t.children.end(), t.value, [](int s, const tree& c) {
+		return s + sum_subtree(c);
+	});
+}
+} // namespace
+
+namespace {
+const tst::set set("parallel_tree", [](tst::suite& suite) {
+	suite.add<std::pair<size_t, size_t>>(
+		"parallel_for_each_node",
+		{
+			{1, 1},
+			{4, 1},
+			{4, 7},
+			{4, 100},
+			{16, 3}
+    },
+		[](const auto& p) {
+			auto roots = make_tree(4, 5);
+			auto expected = roots;
+
+			for (auto& n : utki::make_traversal(expected)) {
+				n.value *= 2;
+			}
+
+			std::atomic<size_t> num_calls{0};
+			utki::parallel_for_each_node(
+				roots,
+				[&](tree& n) {
+					n.value *= 2;
+					++num_calls;
+				},
+				p.first,
+				p.second
+			);
+
+			tst::check(roots == expected, SL);
+			tst::check_eq(num_calls.load(), size_t(4 + 16 + 64 + 256 + 1024), SL);
+		}
+	);
+
+	suite.add<std::pair<size_t, size_t>>(
+		"parallel_reduce_subtrees",
+		{
+			{1, 1},
+			{4, 1},
+			{4, 7},
+			{4, 100},
+			{16, 3}
+    },
+		[](const auto& p) {
+			const auto roots = make_tree(3, 6);
+
+			auto res = utki::parallel_reduce_subtrees<int>(
+				roots,
+				[](const tree& n, utki::span<int> children) {
+					tst::check_eq(children.size(), n.children.size(), SL);
+					return std::accumulate(children.begin(), children.end(), n.value);
+				},
+				p.first,
+				p.second
+			);
+
+			tst::check_eq(res.size(), roots.size(), SL);
+			for (size_t i = 0; i != roots.size(); ++i) {
+				tst::check_eq(res[i], sum_subtree(roots[i]), SL);
+			}
+		}
+	);
+
+	suite.add("parallel_reduce_subtrees_deep_narrow_tree", []() {
+		auto roots = make_tree(1, 1000);
+
+		auto res = utki::parallel_reduce_subtrees<size_t>(
+			roots,
+			[](const tree& n, utki::span<size_t> children) {
+				return children.empty() ? size_t(1) : children.front() + 1;
+			},
+			4,
+			1
+		);
+
+		tst::check_eq(res.size(), size_t(1), SL);
+		tst::check_eq(res.front(), size_t(1000), SL);
+	});
+
+	suite.add("parallel_tree_empty", []() {
+		tree::container_type roots;
+
+		utki::parallel_for_each_node(
+			roots,
+			[](tree&) {
+				tst::check(false, SL);
+			},
+			4,
+			1
+		);
+
+		auto res = utki::parallel_reduce_subtrees<int>(
+			roots,
+			[](tree&, utki::span<int>) {
+				tst::check(false, SL);
+				return 0;
+			},
+			4,
+			1
+		);
+		tst::check(res.empty(), SL);
+	});
+
+	suite.add("parallel_for_each_node_exception", []() {
+		auto roots = make_tree(4, 5);
+
+		bool thrown = false;
+		try {
+			utki::parallel_for_each_node(
+				roots,
+				[](tree& n) {
+					if (n.value == 1000) {
+						throw std::runtime_error("test");
+					}
+				},
+				4,
+				8
+			);
+		} catch (std::runtime_error&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+	});
+});
+} // namespace
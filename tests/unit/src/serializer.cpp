@@ -0,0 +1,186 @@
+#include <tst/check.hpp>
+#include <tst/set.hpp>
+#include <utki/deserializer.hpp>
+#include <utki/serializer.hpp>
+#include <utki/string.hpp>
+
+using namespace std::string_view_literals;
+
+namespace {
+const tst::set set("serializer", [](tst::suite& suite) {
+	suite.add("write_string_and_span", []() {
+		utki::serializer s;
+
+		tst::check(s.empty(), SL);
+
+		s.write_string("bbb"sv);
+		s.write_span(utki::to_uint8_t(utki::make_span("Hello world!"sv)));
+		s.write_string(""sv);
+		s.write_string("ccc"sv);
+
+		tst::check(!s.empty(), SL);
+		tst::check_eq(s.size(), size_t(18), SL);
+		tst::check_eq(utki::make_string_view(s.data()), "bbbHello world!ccc"sv, SL);
+	});
+
+	suite.add("write_le", []() {
+		utki::serializer s;
+
+		s.write_uint8(0xa1);
+		s.write_uint16_le(0xb2a1);
+		s.write_uint32_le(0xd4c3b2a1);
+		s.write_uint64_le(0x2817f6e5d4c3b2a1);
+
+		auto buf = s.release();
+
+		tst::check(s.empty(), SL);
+
+		std::vector<uint8_t> expected = {
+			0xa1, // uint8
+			0xa1, 0xb2, // uint16
+			0xa1, 0xb2, 0xc3, 0xd4, // uint32
+			0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6, 0x17, 0x28 // uint64
+		};
+		tst::check(buf == expected, SL);
+	});
+
+	suite.add("write_be", []() {
+		utki::serializer s;
+
+		s.write_uint8(0xa1);
+		s.write_uint16_be(0xb2a1);
+		s.write_uint32_be(0xd4c3b2a1);
+		s.write_uint64_be(0x2817f6e5d4c3b2a1);
+
+		auto buf = s.release();
+
+		std::vector<uint8_t> expected = {
+			0xa1, // uint8
+			0xb2, 0xa1, // uint16
+			0xd4, 0xc3, 0xb2, 0xa1, // uint32
+			0x28, 0x17, 0xf6, 0xe5, 0xd4, 0xc3, 0xb2, 0xa1 // uint64
+		};
+		tst::check(buf == expected, SL);
+	});
+
+	suite.add("write_batch", []() {
+		utki::serializer s;
+
+		s.write_le(uint8_t(0xa1), uint16_t(0xb2a1), uint32_t(0xd4c3b2a1));
+		s.write_be(uint16_t(0xb2a1), uint8_t(0xa1));
+
+		std::vector<uint8_t> expected = {0xa1, 0xa1, 0xb2, 0xa1, 0xb2, 0xc3, 0xd4, 0xb2, 0xa1, 0xa1};
+		tst::check(s.release() == expected, SL);
+	});
+
+	suite.add("write_floating_point", []() {
+		utki::serializer s;
+
+		s.write_float_le(13.666f);
+		s.write_float_be(-13666e10f);
+		s.write_double_le(13.666);
+		s.write_double_be(-13666e100);
+
+		tst::check_eq(s.size(), size_t(24), SL);
+
+		utki::deserializer d(s.data());
+
+		tst::check_eq(d.read_float_le(), 13.666f, SL);
+		tst::check_eq(d.read_float_be(), -13666e10f, SL);
+		tst::check_eq(d.read_double_le(), 13.666, SL);
+		tst::check_eq(d.read_double_be(), -13666e100, SL);
+		tst::check(d.empty(), SL);
+	});
+
+	suite.add("write_varint", []() {
+		utki::serializer s;
+
+		s.write_varuint(uint16_t(300));
+		s.write_varint(int32_t(-2));
+		s.write_varuint(uint64_t(0));
+
+		std::vector<uint32_t> values = {1, 0x80, 0xffffffff};
+		s.write_varuint_array(utki::make_span(values));
+
+		std::vector<int16_t> signed_values = {-1, 1, -32768};
+		s.write_varint_array(utki::make_span(signed_values));
+
+		std::vector<uint8_t> expected = {
+			0xac, 0x02, // 300
+			0x03, // -2
+			0x00, // 0
+			0x01, // 1
+			0x80, 0x01, // 0x80
+			0xff, 0xff, 0xff, 0xff, 0x0f, // 0xffffffff
+			0x01, // -1
+			0x02, // 1
+			0xff, 0xff, 0x03 // -32768
+		};
+		tst::check(s.release() == expected, SL);
+	});
+
+	suite.add("write_many_values", []() {
+		utki::serializer s;
+
+		constexpr uint32_t num_values = 10000;
+
+		for (uint32_t i = 0; i != num_values; ++i) {
+			s.write_uint32_be(i);
+		}
+
+		tst::check_eq(s.size(), size_t(num_values * sizeof(uint32_t)), SL);
+
+		utki::deserializer d(s.data());
+		for (uint32_t i = 0; i != num_values; ++i) {
+			tst::check_eq(d.read_uint32_be(), i, SL);
+		}
+	});
+
+	suite.add("reserve", []() {
+		utki::serializer s;
+
+		s.write_uint8(1);
+		s.reserve(100);
+		tst::check(s.capacity() >= 100, SL);
+
+		auto capacity = s.capacity();
+		for (unsigned i = 1; i != 100; ++i) {
+			s.write_uint8(uint8_t(i));
+		}
+		tst::check_eq(s.capacity(), capacity, SL);
+		tst::check_eq(s.size(), size_t(100), SL);
+		tst::check_eq(s.data()[99], uint8_t(99), SL);
+	});
+
+	suite.add("fixed_size_buffer", []() {
+		std::array<uint8_t, 6> buf{};
+
+		utki::serializer s(buf);
+
+		tst::check_eq(s.capacity(), buf.size(), SL);
+
+		s.write_uint32_le(0xd4c3b2a1);
+		s.write_uint8(0xe5);
+
+		bool thrown = false;
+		try {
+			s.write_uint16_le(0);
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+
+		s.write_uint8(0xf6);
+
+		std::array<uint8_t, 6> expected = {0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6};
+		tst::check(buf == expected, SL);
+		tst::check_eq(s.size(), buf.size(), SL);
+		tst::check(s.data().data() == buf.data(), SL);
+
+		std::vector<uint8_t> expected_vector(expected.begin(), expected.end());
+		tst::check(s.release() == expected_vector, SL);
+		tst::check(s.empty(), SL);
+	});
+});
+} // namespace
@@ -3,6 +3,7 @@
 #if CFG_COMPILER != CFG_COMPILER_MSVC || CFG_COMPILER_MSVC_TOOLS_V >= 142
 
 #	include <clocale>
+#	include <iomanip>
 #	include <tst/check.hpp>
 #	include <tst/set.hpp>
 #	include <utki/string.hpp>
@@ -10,6 +11,23 @@
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
+namespace {
+// type which is convertible to std::string_view, but has its own output operator
+struct named {
+	std::string name;
+
+	operator std::string_view() const noexcept
+	{
+		return this->name;
+	}
+
+	friend std::ostream& operator<<(std::ostream& o, const named& n)
+	{
+		return o << '<' << n.name << '>';
+	}
+};
+} // namespace
+
 namespace {
 const tst::set set("string", [](tst::suite& suite) {
 	suite.add("make_string_from_const_char_ptr", []() {
@@ -376,6 +394,154 @@ const tst::set set("string", [](tst::suite& suite) {
 		tst::check_eq(r[4], "!"s, SL);
 	});
 
+	suite.add("find_char", []() {
+		// long string to make sure SIMD code path is covered
+		auto str = "0123456789abcdef0123456789abcdef0123456789abcdef/0123456789"sv;
+
+		tst::check_eq(utki::find_char(str, '/'), size_t(48), SL);
+		tst::check_eq(utki::find_char(str, '0'), size_t(0), SL);
+		tst::check_eq(utki::find_char(str, '#'), std::string_view::npos, SL);
+		tst::check_eq(utki::find_char(""sv, '#'), std::string_view::npos, SL);
+	});
+
+	suite.add("find_any_of", []() {
+		auto str = "0123456789abcdef0123456789abcdef0123456789abcdef;0123456789,"sv;
+
+		tst::check_eq(utki::find_any_of(str, {',', ';'}), size_t(48), SL);
+		tst::check_eq(utki::find_any_of(str, {'#', ','}), size_t(59), SL);
+		tst::check_eq(utki::find_any_of(str, {'#', '$'}), std::string_view::npos, SL);
+		tst::check_eq(utki::find_any_of(str, {}), std::string_view::npos, SL);
+
+		// big char set
+		tst::check_eq(
+			utki::find_any_of(str, {'#', '$', '%', '&', '*', '(', ')', '[', ']', ';', ','}),
+			size_t(48),
+			SL
+		);
+	});
+
+	suite.add("find_space", []() {
+		auto str = "0123456789abcdef0123456789abcdef0123456789abcdef\v0123456789\t"sv;
+
+		tst::check_eq(utki::find_space(str), size_t(48), SL);
+		tst::check_eq(utki::find_space(str.substr(49)), size_t(10), SL);
+		tst::check_eq(utki::find_space(str.substr(0, 48)), std::string_view::npos, SL);
+
+		tst::check_eq(utki::find_space_or(str, 'f'), size_t(15), SL);
+		tst::check_eq(utki::find_space_or(str, '#'), size_t(48), SL);
+
+		// characters around the whitespace characters range are not whitespaces
+		tst::check_eq(
+			utki::find_space("0123456789abcdef0123456789abcdef\x08\x0e\x1f!\x7f\x80\xff"sv),
+			std::string_view::npos,
+			SL
+		);
+	});
+
+	suite.add("find_non_space", []() {
+		auto str = " \t\n\r\v\f                                              \t\tx "sv;
+
+		tst::check_eq(utki::find_non_space(str), size_t(54), SL);
+		tst::check_eq(utki::find_non_space(str.substr(0, 54)), std::string_view::npos, SL);
+		tst::check_eq(utki::find_non_space("x"sv), size_t(0), SL);
+	});
+
+	suite.add("split_view_by_delimiter", []() {
+		auto str = "qwe/rtyu/io/p//[]/"sv;
+
+		std::vector<std::string_view> r;
+		for (auto t : utki::split_view(str, '/')) {
+			r.push_back(t);
+		}
+
+		tst::check_eq(
+			r.size(),
+			size_t(7),
+			[&](auto& o) {
+				o << "r.size() = " << r.size();
+			},
+			SL
+		);
+		tst::check_eq(r[0], "qwe"sv, SL);
+		tst::check_eq(r[1], "rtyu"sv, SL);
+		tst::check_eq(r[2], "io"sv, SL);
+		tst::check_eq(r[3], "p"sv, SL);
+		tst::check_eq(r[4], ""sv, SL);
+		tst::check_eq(r[5], "[]"sv, SL);
+		tst::check_eq(r[6], ""sv, SL);
+
+		// tokens point into the original string
+		tst::check(r[1].data() == std::next(str.data(), 4), SL);
+	});
+
+	suite.add("split_view_empty_string", []() {
+		auto v = utki::split_view(""sv, '/');
+
+		tst::check_eq(std::distance(v.begin(), v.end()), std::ptrdiff_t(1), SL);
+		tst::check_eq(*v.begin(), ""sv, SL);
+	});
+
+	suite.add("split_view_u32string", []() {
+		auto str = U"qwe/rtyu"s;
+
+		auto v = utki::split_view(str, U'/');
+
+		auto i = v.begin();
+		tst::check(*i == U"qwe"sv, SL);
+		++i;
+		tst::check(*i == U"rtyu"sv, SL);
+		++i;
+		tst::check(i == v.end(), SL);
+	});
+
+	suite.add("split_view_into_words", []() {
+		auto str = " hello world    bla\tblah\n!\n"sv;
+
+		auto v = utki::split_view(str);
+		std::vector<std::string_view> r(v.begin(), v.end());
+
+		tst::check_eq(
+			r.size(),
+			size_t(5),
+			[&](auto& o) {
+				o << "r.size() = " << r.size();
+			},
+			SL
+		);
+		tst::check_eq(r[0], "hello"sv, SL);
+		tst::check_eq(r[1], "world"sv, SL);
+		tst::check_eq(r[2], "bla"sv, SL);
+		tst::check_eq(r[3], "blah"sv, SL);
+		tst::check_eq(r[4], "!"sv, SL);
+	});
+
+	suite.add("split_view_into_words_whitespaces_only", []() {
+		auto v = utki::split_view(" \t\n  "sv);
+
+		tst::check(v.begin() == v.end(), SL);
+	});
+
+	suite.add("split_into_buffer", []() {
+		std::array<std::string_view, 4> buf;
+
+		auto num = utki::split_into("qwe/rtyu/io"sv, '/', utki::make_span(buf));
+
+		tst::check_eq(num, size_t(3), SL);
+		tst::check_eq(buf[0], "qwe"sv, SL);
+		tst::check_eq(buf[1], "rtyu"sv, SL);
+		tst::check_eq(buf[2], "io"sv, SL);
+	});
+
+	suite.add("split_into_too_small_buffer", []() {
+		std::array<std::string_view, 2> buf;
+
+		auto num = utki::split_into(" hello world  bla "sv, utki::make_span(buf));
+
+		tst::check_eq(num, size_t(3), SL);
+		tst::check_eq(buf[0], "hello"sv, SL);
+		tst::check_eq(buf[1], "world"sv, SL);
+	});
+
 	suite.add("join_vector_of_strings", []() {
 		std::vector<std::string> strings = {"hello", "world", "!"};
 
@@ -885,6 +1051,160 @@ const tst::set set("string", [](tst::suite& suite) {
 		}
 	});
 
+	suite.add("string_parser_try_methods", []() {
+		utki::string_parser p("ab  13 -1.5 x"sv);
+
+		tst::check(p.try_peek_char() == 'a', SL);
+		tst::check(p.try_peek_char(1) == 'b', SL);
+		tst::check(p.try_peek_char(3) == ' ', SL);
+		tst::check(!p.try_peek_char(13).has_value(), SL);
+
+		tst::check(p.try_read_char() == 'a', SL);
+		tst::check(p.try_read_char() == 'b', SL);
+
+		{
+			int n = 0;
+			auto res = p.try_read_number(n);
+			tst::check(res.ec == std::errc(), SL);
+			tst::check_eq(n, 13, SL);
+			tst::check(res.ptr == p.get_view().data(), SL);
+			tst::check_eq(p.get_view(), " -1.5 x"sv, SL);
+		}
+
+		{
+			float n = 0;
+			auto res = p.try_read_number(n);
+			tst::check(res.ec == std::errc(), SL);
+			tst::check_eq(n, -1.5f, SL);
+		}
+
+		{
+			float n = 0;
+			auto res = p.try_read_number(n);
+			tst::check(res.ec == std::errc::invalid_argument, SL);
+			tst::check_eq(p.get_view(), "x"sv, SL);
+			tst::check(res.ptr == p.get_view().data(), SL);
+		}
+
+		tst::check(p.try_read_char() == 'x', SL);
+		tst::check(p.empty(), SL);
+		tst::check(!p.try_read_char().has_value(), SL);
+		tst::check(!p.try_peek_char().has_value(), SL);
+
+		{
+			unsigned n = 0;
+			auto res = p.try_read_number(n);
+			tst::check(res.ec == std::errc::invalid_argument, SL);
+		}
+	});
+
+	suite.add("string_parser_read_numbers_to_span", []() {
+		utki::string_parser p("  3.5, -1e2 7,\t0.25\n, 13 ]"sv);
+
+		std::array<float, 4> buf{};
+		auto res = p.read_numbers(utki::make_span(buf));
+
+		tst::check_eq(res.num_read, size_t(4), SL);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(buf[0], 3.5f, SL);
+		tst::check_eq(buf[1], -100.0f, SL);
+		tst::check_eq(buf[2], 7.0f, SL);
+		tst::check_eq(buf[3], 0.25f, SL);
+
+		tst::check(res.ptr == p.get_view().data(), SL);
+		tst::check_eq(p.get_view(), "\n, 13 ]"sv, SL);
+	});
+
+	suite.add("string_parser_read_numbers_to_vector", []() {
+		utki::string_parser p("13, 0x1f 010,0b11 , 0 "sv);
+
+		std::vector<unsigned> v;
+		auto res = p.read_numbers(v);
+
+		tst::check_eq(res.num_read, size_t(5), SL);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check(v == std::vector<unsigned>{13, 31, 8, 3, 0}, SL);
+		tst::check(p.empty(), SL);
+		tst::check(res.ptr == p.get_view().data(), SL);
+	});
+
+	suite.add("string_parser_read_numbers_stops_on_non_number", []() {
+		auto str = "[1, -2, 3 , x, 4]"sv;
+		utki::string_parser p(str.substr(1));
+
+		std::vector<int> v;
+		auto res = p.read_numbers(v);
+
+		tst::check_eq(res.num_read, size_t(3), SL);
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check(v == std::vector<int>{1, -2, 3}, SL);
+		tst::check_eq(std::distance(str.data(), res.ptr), std::ptrdiff_t(12), SL);
+		tst::check_eq(p.get_view(), "x, 4]"sv, SL);
+	});
+
+	suite.add("string_parser_read_numbers_double_comma", []() {
+		utki::string_parser p("1.5,,2.5"sv);
+
+		std::vector<double> v;
+		auto res = p.read_numbers(v);
+
+		tst::check_eq(res.num_read, size_t(1), SL);
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check_eq(p.get_view(), ",2.5"sv, SL);
+	});
+
+	suite.add("string_parser_read_numbers_trailing_comma", []() {
+		utki::string_parser p("1,2,3 , "sv);
+
+		std::vector<int> v;
+		auto res = p.read_numbers(v);
+
+		tst::check_eq(res.num_read, size_t(3), SL);
+		tst::check(res.ec == std::errc::invalid_argument, SL);
+		tst::check(v == std::vector<int>{1, 2, 3}, SL);
+		tst::check_eq(p.get_view(), ", "sv, SL);
+		tst::check(res.ptr == p.get_view().data(), SL);
+	});
+
+	suite.add("string_parser_read_numbers_no_separator", []() {
+		{
+			utki::string_parser p("1-2"sv);
+
+			std::vector<int> v;
+			auto res = p.read_numbers(v);
+
+			tst::check_eq(res.num_read, size_t(1), SL);
+			tst::check(res.ec == std::errc::invalid_argument, SL);
+			tst::check(v == std::vector<int>{1}, SL);
+			tst::check_eq(p.get_view(), "-2"sv, SL);
+			tst::check(res.ptr == p.get_view().data(), SL);
+		}
+		{
+			utki::string_parser p("0.5, 1.5.5"sv);
+
+			std::vector<double> v;
+			auto res = p.read_numbers(v);
+
+			tst::check_eq(res.num_read, size_t(2), SL);
+			tst::check(res.ec == std::errc::invalid_argument, SL);
+			tst::check(v == std::vector<double>{0.5, 1.5}, SL);
+			tst::check_eq(p.get_view(), ".5"sv, SL);
+			tst::check(res.ptr == p.get_view().data(), SL);
+		}
+	});
+
+	suite.add("string_parser_read_numbers_empty_string", []() {
+		utki::string_parser p("   "sv);
+
+		std::vector<double> v;
+		auto res = p.read_numbers(v);
+
+		tst::check_eq(res.num_read, size_t(0), SL);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check(v.empty(), SL);
+		tst::check(p.empty(), SL);
+	});
+
 	suite.add("string_parser_skip_inclusive_until_one_of", []() {
 		auto str = "Hello _ World!";
 
@@ -1034,6 +1354,102 @@ const tst::set set("string", [](tst::suite& suite) {
 		}
 	);
 
+	suite.add<std::pair<double, std::string>>(
+		"to_string__double",
+		// clang-format off
+		{
+			{0.0, "0"},
+			{-0.0, "-0"},
+			{1.0, "1"},
+			{-1.5, "-1.5"},
+			{0.1, "0.1"},
+			{0.3, "0.3"},
+			{1.0 / 3, "0.3333333333333333"},
+			{100.0, "100"},
+			{123456.0, "123456"},
+			{1e22, "1e+22"},
+			{1e23, "1e+23"},
+			{1.5e-7, "1.5e-07"},
+			{0.001, "0.001"},
+			{5e-324, "5e-324"},
+			{std::numeric_limits<double>::max(), "1.7976931348623157e+308"},
+			{std::numeric_limits<double>::infinity(), "inf"},
+			{-std::numeric_limits<double>::infinity(), "-inf"},
+			{std::numeric_limits<double>::quiet_NaN(), "nan"}
+		},
+		// clang-format on
+		[](const auto& p) {
+			auto s = utki::to_string(p.first);
+
+			tst::check_eq(s, p.second, SL);
+		}
+	);
+
+	suite.add<std::pair<float, std::string>>(
+		"to_string__float",
+		// clang-format off
+		{
+			{0.0f, "0"},
+			{0.1f, "0.1"},
+			{3.14f, "3.14"},
+			{16777216.0f, "16777216"},
+			{1e10f, "1e+10"},
+			{std::numeric_limits<float>::max(), "3.4028235e+38"},
+			{std::numeric_limits<float>::denorm_min(), "1e-45"}
+		},
+		// clang-format on
+		[](const auto& p) {
+			auto s = utki::to_string(p.first);
+
+			tst::check_eq(s, p.second, SL);
+		}
+	);
+
+	suite.add("to_chars__span", []() {
+		std::array<char, 4> buf{};
+
+		auto res = utki::to_chars(utki::make_span(buf), 123);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(std::string_view(buf.data(), res.ptr - buf.data()), "123"sv, SL);
+
+		res = utki::to_chars(utki::make_span(buf), 0xffu, utki::integer_base::hex);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(std::string_view(buf.data(), res.ptr - buf.data()), "0xff"sv, SL);
+
+		res = utki::to_chars(utki::make_span(buf), 0.25);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(std::string_view(buf.data(), res.ptr - buf.data()), "0.25"sv, SL);
+	});
+
+	suite.add("to_chars__span_too_small", []() {
+		std::array<char, 4> buf{};
+
+		tst::check(utki::to_chars(utki::make_span(buf), 12345).ec == std::errc::value_too_large, SL);
+		tst::check(
+			utki::to_chars(utki::make_span(buf), 0x100u, utki::integer_base::hex).ec == std::errc::value_too_large,
+			SL
+		);
+		tst::check(utki::to_chars(utki::make_span(buf), 0.125).ec == std::errc::value_too_large, SL);
+		tst::check(
+			utki::to_chars(utki::make_span(buf).subspan(0, 1), 5u, utki::integer_base::bin).ec ==
+				std::errc::value_too_large,
+			SL
+		);
+	});
+
+	suite.add("append_to_string", []() {
+		std::string str = "values:";
+
+		for (auto v : {1.5, -2.0, 1e100}) {
+			str.push_back(' ');
+			utki::append_to_string(str, v);
+		}
+		str.push_back(' ');
+		utki::append_to_string(str, 10u, utki::integer_base::oct);
+
+		tst::check_eq(str, "values: 1.5 -2 1e+100 012"s, SL);
+	});
+
 	suite.add("cat", []() {
 		tst::check_eq(utki::cat(), ""s, SL);
 		tst::check_eq(utki::cat("hello "), "hello "s, SL);
@@ -1041,6 +1457,55 @@ const tst::set set("string", [](tst::suite& suite) {
 		tst::check_eq(utki::cat("hello "s, "world"sv, "!"), "hello world!"s, SL);
 	});
 
+	suite.add("cat_numbers_and_chars", []() {
+		tst::check_eq(utki::cat(-13, ' ', uint64_t(18446744073709551615u)), "-13 18446744073709551615"s, SL);
+		tst::check_eq(utki::cat('a', uint8_t('b'), int8_t('c')), "abc"s, SL);
+		tst::check_eq(utki::cat(true, false), "10"s, SL);
+		tst::check_eq(utki::cat(3.14f, " ", 0.1, " ", 1e-5, " ", 1234567.0), "3.14 0.1 1e-05 1.23457e+06"s, SL);
+	});
+
+	suite.add("cat_is_same_as_stream", []() {
+		std::stringstream ss;
+		ss << 1.0 / 3 << int16_t(-32768) << 255u << 100.0 << -0.5f << 'x';
+
+		tst::check_eq(utki::cat(1.0 / 3, int16_t(-32768), 255u, 100.0, -0.5f, 'x'), ss.str(), SL);
+	});
+
+	suite.add("cat_streamable_type", []() {
+		tst::check_eq(utki::cat("value = ", utki::make_span("abc"sv)), "value = abc"s, SL);
+	});
+
+	suite.add("cat_stream_manipulators", []() {
+		tst::check_eq(utki::cat(std::hex, 255, ' ', 16), "ff 10"s, SL);
+		tst::check_eq(utki::cat('[', std::setw(5), 42, ']'), "[   42]"s, SL);
+		tst::check_eq(utki::cat(std::setprecision(3), 3.14159, ' ', 2.71828), "3.14 2.72"s, SL);
+	});
+
+	suite.add("cat_type_convertible_to_string_view_uses_its_operator", []() {
+		tst::check_eq(utki::cat("value = ", named{"abc"}), "value = <abc>"s, SL);
+	});
+
+	suite.add("string_builder", []() {
+		utki::string_builder sb;
+
+		auto size = utki::string_builder::estimate_size("hello"sv, ' ', uint16_t(12), "!");
+		tst::check_eq(size, size_t(5 + 1 + 5 + 1), SL);
+
+		sb.reserve(size);
+		sb << "hello"sv << ' ' << uint16_t(12);
+		sb.append("!");
+
+		tst::check_eq(sb.size(), size_t(9), SL);
+		tst::check_eq(sb.view(), "hello 12!"sv, SL);
+		tst::check_eq(sb.str(), "hello 12!"s, SL);
+
+		sb.clear();
+		tst::check_eq(sb.size(), size_t(0), SL);
+
+		sb << "world";
+		tst::check_eq(std::move(sb).str(), "world"s, SL);
+	});
+
 	suite.add("trim_front", []() {
 		const char* str = "\n  hello world \t\n";
 		std::string string = str;
@@ -0,0 +1,174 @@
+#include <tst/check.hpp>
+#include <tst/set.hpp>
+#include <utki/deserializer.hpp>
+#include <utki/serializer.hpp>
+#include <utki/struct_layout.hpp>
+
+namespace {
+enum class message_kind : uint16_t {
+	request = 1,
+	response = 0x0102
+};
+
+struct header {
+	uint32_t magic;
+	message_kind kind;
+	uint8_t flags;
+	int64_t timestamp;
+	float scale;
+	double offset;
+};
+
+using header_layout = utki::struct_layout<
+	utki::struct_field<&header::magic, utki::endian::big>,
+	utki::struct_field<&header::kind, utki::endian::big>,
+	utki::struct_field<&header::flags>,
+	utki::struct_field<&header::timestamp>,
+	utki::struct_field<&header::scale, utki::endian::big>,
+	utki::struct_field<&header::offset>>;
+
+static_assert(header_layout::size == 27);
+
+struct record {
+	uint32_t a;
+	uint16_t b;
+	uint16_t c;
+	uint64_t d;
+};
+
+// same as in-memory representation on little-endian hosts
+using record_layout = utki::struct_layout<
+	utki::struct_field<&record::a>,
+	utki::struct_field<&record::b>,
+	utki::struct_field<&record::c>,
+	utki::struct_field<&record::d>>;
+
+// fields are listed not in order of their location in the struct
+using permuted_record_layout = utki::struct_layout<
+	utki::struct_field<&record::b>,
+	utki::struct_field<&record::a>,
+	utki::struct_field<&record::d>,
+	utki::struct_field<&record::c>>;
+
+// clang-format off
+const std::vector<uint8_t> header_bytes = {
+	0xca, 0xfe, 0xba, 0xbe, // magic
+	0x01, 0x02, // kind
+	0xa5, // flags
+	0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, // timestamp
+	0x41, 0x50, 0x00, 0x00, // scale
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0xc0 // offset
+};
+// clang-format on
+} // namespace
+
+namespace {
+const tst::set set("struct_layout", [](tst::suite& suite) {
+	suite.add("read_write", []() {
+		header h{};
+		header_layout::read(header_bytes.data(), h);
+
+		tst::check_eq(h.magic, uint32_t(0xcafebabe), SL);
+		tst::check(h.kind == message_kind::response, SL);
+		tst::check_eq(h.flags, uint8_t(0xa5), SL);
+		tst::check_eq(h.timestamp, int64_t(-2), SL);
+		tst::check_eq(h.scale, 13.0f, SL);
+		tst::check_eq(h.offset, -13.0, SL);
+
+		std::vector<uint8_t> buf(header_layout::size);
+		auto end = header_layout::write(h, buf.data());
+
+		tst::check(end == buf.data() + buf.size(), SL);
+		tst::check(buf == header_bytes, SL);
+	});
+
+	suite.add("field_order", []() {
+		// clang-format off
+		std::vector<uint8_t> buf = {
+			0x01, 0x02, 0x03, 0x04,
+			0x05, 0x06,
+			0x07, 0x08,
+			0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10
+		};
+		// clang-format on
+
+		utki::deserializer d(buf);
+
+		auto r = d.read_struct<record_layout>();
+		tst::check_eq(r.a, uint32_t(0x04030201), SL);
+		tst::check_eq(r.b, uint16_t(0x0605), SL);
+		tst::check_eq(r.c, uint16_t(0x0807), SL);
+		tst::check_eq(r.d, uint64_t(0x100f0e0d0c0b0a09), SL);
+
+		utki::deserializer pd(buf);
+
+		auto pr = pd.read_struct<permuted_record_layout>();
+		tst::check_eq(pr.b, uint16_t(0x0201), SL);
+		tst::check_eq(pr.a, uint32_t(0x06050403), SL);
+		tst::check_eq(pr.d, uint64_t(0x0e0d0c0b0a090807), SL);
+		tst::check_eq(pr.c, uint16_t(0x100f), SL);
+
+		utki::serializer s;
+		s.write_struct<record_layout>(r);
+		s.write_struct<permuted_record_layout>(pr);
+
+		auto out = s.release();
+		tst::check(std::equal(buf.begin(), buf.end(), out.begin()), SL);
+		tst::check(std::equal(buf.begin(), buf.end(), out.begin() + buf.size()), SL);
+	});
+
+	suite.add("deserializer_read_struct", []() {
+		utki::deserializer d(header_bytes);
+
+		auto h = d.read_struct<header_layout>();
+
+		tst::check(d.empty(), SL);
+		tst::check_eq(h.magic, uint32_t(0xcafebabe), SL);
+		tst::check_eq(h.offset, -13.0, SL);
+
+		utki::deserializer short_d(utki::make_span(header_bytes).subspan(1));
+
+		bool thrown = false;
+		try {
+			short_d.read_struct<header_layout>();
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+		tst::check_eq(short_d.size(), header_bytes.size() - 1, SL);
+	});
+
+	suite.add("checked_deserializer_read_struct", []() {
+		utki::checked_deserializer d(header_bytes);
+
+		auto h = d.read_struct<header_layout>();
+
+		tst::check(!d.error(), SL);
+		tst::check(d.empty(), SL);
+		tst::check_eq(h.scale, 13.0f, SL);
+
+		utki::checked_deserializer short_d(utki::make_span(header_bytes).subspan(1));
+
+		h = short_d.read_struct<header_layout>();
+
+		tst::check(short_d.error(), SL);
+		tst::check_eq(h.magic, uint32_t(0), SL);
+	});
+
+	suite.add("serializer_write_struct", []() {
+		header h{};
+		h.magic = 0xcafebabe;
+		h.kind = message_kind::response;
+		h.flags = 0xa5;
+		h.timestamp = -2;
+		h.scale = 13;
+		h.offset = -13;
+
+		utki::serializer s;
+		s.write_struct<header_layout>(h);
+
+		tst::check(s.release() == header_bytes, SL);
+	});
+});
+} // namespace
@@ -1139,6 +1139,92 @@ const tst::set set("tree", [](tst::suite& suite) {
 		tst::check_eq(traversal[{1, 1, 2}].value, 128, SL);
 	});
 
+	suite.add("traversal_at", []() {
+		using tree = utki::tree<int>;
+		tree::container_type roots{
+			tree(1, {34, 45}),
+			tree( //
+				2,
+				{//
+				 tree(3, {78, 89, 96}),
+				 tree(4, {32, 64, 128}),
+				 tree(42, {98, 99, 100})
+				}
+			)
+		};
+
+		auto traversal = utki::make_traversal(roots);
+
+		tst::check_eq(traversal.at({1, 2}).value, 42, SL);
+		traversal.at({1, 2, 0}).value = 13;
+		tst::check_eq(roots[1].children[2].children[0].value, 13, SL);
+
+		for (const auto& index : std::vector<std::vector<size_t>>{{}, {2}, {0, 2}, {1, 1, 0, 0}}) {
+			bool thrown = false;
+			try {
+				traversal.at(utki::make_span(index));
+			} catch (std::out_of_range&) {
+				thrown = true;
+			}
+			tst::check(thrown, SL);
+		}
+	});
+
+	suite.add("traversal_at_batch", []() {
+		using tree = utki::tree<int>;
+		const tree::container_type roots{
+			tree(1, {34, 45}),
+			tree( //
+				2,
+				{//
+				 tree(3, {78, 89, 96}),
+				 tree(4, {32, 64, 128}),
+				 tree(42, {98, 99, 100})
+				}
+			)
+		};
+
+		const auto traversal = utki::make_traversal(roots);
+
+		const std::vector<std::vector<size_t>> indices = {
+			{1, 1, 2},
+			{1, 1},
+			{1, 1, 0},
+			{1, 1, 0},
+			{0},
+			{1, 2, 1},
+			{1, 2}
+		};
+
+		std::vector<const tree*> nodes(indices.size());
+		traversal.at(utki::make_span(indices), utki::make_span(nodes));
+
+		for (size_t i = 0; i != indices.size(); ++i) {
+			tst::check_eq(nodes[i], &traversal[indices[i]], SL);
+		}
+
+		{
+			bool thrown = false;
+			try {
+				std::vector<std::vector<size_t>> bad_indices = {{1, 1}, {1, 1, 3}};
+				traversal.at(utki::make_span(bad_indices), utki::make_span(nodes).subspan(0, 2));
+			} catch (std::out_of_range&) {
+				thrown = true;
+			}
+			tst::check(thrown, SL);
+		}
+
+		{
+			bool thrown = false;
+			try {
+				traversal.at(utki::make_span(indices), utki::make_span(nodes).subspan(1));
+			} catch (std::invalid_argument&) {
+				thrown = true;
+			}
+			tst::check(thrown, SL);
+		}
+	});
+
 	suite.add("traversal_iterator_comparison", []() {
 		using tree = utki::tree<int>;
 		const tree::container_type roots{
@@ -1336,6 +1422,189 @@ const tst::set set("tree", [](tst::suite& suite) {
 		}
 	);
 
+	suite.add("traversal_iterators_deeper_than_inline_depth", []() {
+		using tree = utki::tree<int>;
+		tree::container_type roots{
+			tree(1, {34, 45}),
+			tree( //
+				2,
+				{//
+				 tree(3, {78, 89, 96}),
+				 tree(4, {32, 64, 128}),
+				 tree(42, {98, 99, tree(100, {tree(101, {102})})})
+				}
+			)
+		};
+
+		utki::traversal<decltype(roots), 1> traversal(roots);
+
+		std::vector<int> encountered;
+		for (auto i = traversal.begin(); i != traversal.end(); ++i) {
+			encountered.push_back(i->value);
+			tst::check(traversal.make_iterator(i.index()) == i, SL);
+		}
+
+		std::vector<int> expected = {1, 34, 45, 2, 3, 78, 89, 96, 4, 32, 64, 128, 42, 98, 99, 100, 101, 102};
+		tst::check(encountered == expected, SL);
+
+		encountered.clear();
+		for (auto i = traversal.rbegin(); i != traversal.rend(); ++i) {
+			encountered.push_back(i->value);
+		}
+		std::reverse(expected.begin(), expected.end());
+		tst::check(encountered == expected, SL);
+
+		auto iter = traversal.make_iterator({1, 2, 2, 0, 0});
+		tst::check_eq(iter.depth(), size_t(5), SL);
+		tst::check_eq(iter->value, 102, SL);
+		tst::check_eq(iter.at_level(3).value, 101, SL);
+
+		auto copy = iter;
+		tst::check(copy == iter, SL);
+		--copy;
+		tst::check(copy != iter, SL);
+		tst::check(copy < iter, SL);
+		tst::check(traversal.make_iterator({1, 2, 2}) < copy, SL);
+		tst::check(traversal.make_iterator({1, 2, 2}) != traversal.make_iterator({1, 2, 2, 0}), SL);
+	});
+
+	suite.add("traversal_iterator_skip_subtree", []() {
+		using tree = utki::tree<int>;
+		const tree::container_type roots{
+			tree(1, {34, 45}),
+			tree( //
+				2,
+				{//
+				 tree(3, {78, 89, 96}),
+				 tree(4, {32, 64, 128}),
+				 tree(42, {98, 99, 100})
+				}
+			)
+		};
+
+		const auto traversal = utki::make_traversal(roots);
+
+		std::vector<int> encountered;
+		for (auto i = traversal.cbegin(); i != traversal.cend();) {
+			encountered.push_back(i->value);
+			if (i->value == 1 || i->value == 4 || i->value == 42) {
+				i.skip_subtree();
+			} else {
+				++i;
+			}
+		}
+
+		const std::vector<int> expected = {1, 2, 3, 78, 89, 96, 4, 42};
+		tst::check(encountered == expected, SL);
+	});
+
+	suite.add("post_order_traversal", []() {
+		using tree = utki::tree<int>;
+		tree::container_type roots{
+			tree(1, {34, 45}),
+			tree( //
+				2,
+				{//
+				 tree(3, {78, 89, 96}),
+				 tree(4, {32, 64, 128}),
+				 tree(42, {98, 99, 100})
+				}
+			)
+		};
+
+		auto traversal = utki::make_post_order_traversal(roots);
+
+		std::vector<int> encountered;
+		std::vector<size_t> depths;
+		for (auto i = traversal.begin(); i != traversal.end(); ++i) {
+			encountered.push_back(i->value);
+			depths.push_back(i.depth());
+		}
+
+		const std::vector<int> expected = {34, 45, 1, 78, 89, 96, 3, 32, 64, 128, 4, 98, 99, 100, 42, 2};
+		tst::check(encountered == expected, SL);
+
+		const std::vector<size_t> expected_depths = {2, 2, 1, 3, 3, 3, 2, 3, 3, 3, 2, 3, 3, 3, 2, 1};
+		tst::check(depths == expected_depths, SL);
+
+		const auto& const_roots = roots;
+		tst::check(
+			std::equal(
+				utki::make_post_order_traversal(const_roots).cbegin(),
+				utki::make_post_order_traversal(const_roots).cend(),
+				expected.begin(),
+				expected.end()
+			),
+			SL
+		);
+
+		const auto const_traversal = utki::make_post_order_traversal(roots);
+		encountered.clear();
+		for (const auto& n : const_traversal) {
+			encountered.push_back(n.value);
+		}
+		tst::check(encountered == expected, SL);
+
+		tree::container_type empty;
+		auto empty_traversal = utki::make_post_order_traversal(empty);
+		tst::check(empty_traversal.begin() == empty_traversal.end(), SL);
+	});
+
+	suite.add("level_order_traversal", []() {
+		using tree = utki::tree<int>;
+		const tree::container_type roots{
+			tree(1, {34, 45}),
+			tree( //
+				2,
+				{//
+				 tree(3, {78, 89, 96}),
+				 tree(4, {32, 64, 128}),
+				 tree(42, {98, 99, 100})
+				}
+			)
+		};
+
+		auto traversal = utki::make_level_order_traversal(roots);
+
+		const std::vector<int> expected = {1, 2, 34, 45, 3, 4, 42, 78, 89, 96, 32, 64, 128, 98, 99, 100};
+		const std::vector<size_t> expected_depths = {1, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3};
+
+		// traverse twice to check that the queue buffer is reused correctly
+		for (unsigned k = 0; k != 2; ++k) {
+			std::vector<int> encountered;
+			std::vector<size_t> depths;
+			for (auto i = traversal.begin(); i != traversal.end(); ++i) {
+				encountered.push_back(i->value);
+				depths.push_back(i.depth());
+			}
+
+			tst::check(encountered == expected, SL);
+			tst::check(depths == expected_depths, SL);
+		}
+
+		// constant iterators have their own queues, so those do not interfere
+		const auto const_traversal = utki::make_level_order_traversal(roots);
+		auto i = const_traversal.cbegin();
+		auto j = const_traversal.begin();
+		std::vector<int> encountered;
+		for (; i != const_traversal.cend(); ++i, ++j) {
+			tst::check(j != const_traversal.end(), SL);
+			tst::check_eq(i->value, j->value, SL);
+			encountered.push_back(i->value);
+			if (encountered.size() == 3) {
+				// copy of an iterator shares the queue and continues from the same position
+				auto k = i;
+				tst::check(std::equal(k, const_traversal.cend(), std::next(expected.begin(), 2), expected.end()), SL);
+			}
+		}
+		tst::check(j == const_traversal.end(), SL);
+		tst::check(encountered == expected, SL);
+
+		tree::container_type empty;
+		auto empty_traversal = utki::make_level_order_traversal(empty);
+		tst::check(empty_traversal.begin() == empty_traversal.end(), SL);
+	});
+
 	suite.add("traversal_iterator_at_level", []() {
 		using tree = utki::tree<int>;
 		tree::container_type roots{
@@ -26,5 +26,16 @@ const tst::set set("type_traits", [](tst::suite& suite) {
 		tst::check(!utki::is_scoped_enum_v<unscoped>, SL);
 		tst::check(utki::is_scoped_enum_v<scoped>, SL);
 	});
+
+	suite.add("member_pointer_traits", []() {
+		struct a {
+			int b;
+			float c;
+		};
+
+		static_assert(std::is_same_v<utki::member_pointer_traits<decltype(&a::b)>::object_type, a>);
+		static_assert(std::is_same_v<utki::member_pointer_traits<decltype(&a::b)>::value_type, int>);
+		static_assert(std::is_same_v<utki::member_pointer_traits<decltype(&a::c)>::value_type, float>);
+	});
 });
 } // namespace
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #if CFG_COMPILER != CFG_COMPILER_MSVC || CFG_COMPILER_MSVC_TOOLS_V >= 142
 
+#	include <algorithm>
+
 #	include <tst/check.hpp>
 #	include <tst/set.hpp>
 #	include <utki/unicode.hpp>
@@ -261,6 +263,438 @@ const tst::set set("unicode", [](tst::suite& suite) {
 			SL
 		);
 	});
+
+	suite.add<std::pair<std::string_view, size_t>>( //
+		"find_invalid_utf8",
+		{
+			{""sv, std::string_view::npos},
+			{"Hello world!"sv, std::string_view::npos},
+			{"aБцﺶ𠀋"sv, std::string_view::npos},
+			{"\xf4\x8f\xbf\xbf"sv, std::string_view::npos}, // U+10ffff
+			{"abc\x80"sv, 3}, // unexpected continuation byte
+			{"ab\xd0"sv, 2}, // truncated sequence
+			{"ab\xe2\x82"sv, 2}, // truncated sequence
+			{"ab\xe2\x82x\xe2\x82\xac"sv, 2}, // not enough continuation bytes
+			{"a\xc0\xafz"sv, 1}, // overlong encoding of '/'
+			{"a\xe0\x80\xafz"sv, 1}, // overlong encoding of '/'
+			{"a\xf0\x80\x80\xafz"sv, 1}, // overlong encoding of '/'
+			{"a\xed\xa0\x80"sv, 1}, // surrogate U+d800
+			{"a\xf4\x90\x80\x80"sv, 1}, // U+110000
+			{"a\xf8\x88\x80\x80\x80"sv, 1}, // 5 byte sequence
+			{"a\xff"sv, 1},
+			{"0123456789abcdef0123456789abcdefБцﺶ𠀋\xe2\x82"sv, 43},
+			{"0123456789abcdef0123456789abcdef0123456789abcdef\xa0"sv, 48},
+			{"0123456789abcdef0123456789abcdeБ\x80 0123456789abcdef"sv, 33},
+			{"0123456789abcdef0123456789abcd\xf0\x9f\x98x0123456789abcdef"sv, 30},
+		},
+		[](const auto& p) {
+			auto res = utki::find_invalid_utf8(p.first);
+			tst::check_eq(res, p.second, SL);
+			tst::check_eq(utki::is_valid_utf8(p.first), p.second == std::string_view::npos, SL);
+		}
+	);
+
+	suite.add("utf8_length", []() {
+		tst::check_eq(utki::utf8_length(""sv), size_t(0), SL);
+		tst::check_eq(utki::utf8_length("aБцﺶ𠀋"sv), size_t(5), SL);
+
+		std::string str;
+		for (unsigned i = 0; i != 100; ++i) {
+			str.append("hello aБцﺶ𠀋");
+		}
+		tst::check_eq(utki::utf8_length(str), size_t(100 * 11), SL);
+	});
+
+	suite.add("utf8_to_utf32_into_span", []() {
+		std::array<char32_t, 10> buf{};
+
+		auto res = utki::to_utf32("aБцﺶ𠀋"sv, buf);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(res.num_written, size_t(5), SL);
+		tst::check_eq(res.offset, size_t(12), SL);
+		tst::check(std::u32string_view(buf.data(), res.num_written) == U"aБцﺶ𠀋"sv, SL);
+	});
+
+	suite.add("utf8_to_utf32_into_span_malformed", []() {
+		std::array<char32_t, 10> buf{};
+
+		auto res = utki::to_utf32("aБ\xed\xa0\x80ц"sv, buf);
+		tst::check(res.ec == std::errc::illegal_byte_sequence, SL);
+		tst::check_eq(res.num_written, size_t(2), SL);
+		tst::check_eq(res.offset, size_t(3), SL);
+		tst::check(std::u32string_view(buf.data(), res.num_written) == U"aБ"sv, SL);
+	});
+
+	suite.add("utf8_to_utf32_into_span_too_small", []() {
+		std::array<char32_t, 4> buf{};
+
+		auto res = utki::to_utf32("aБцﺶ𠀋"sv, buf);
+		tst::check(res.ec == std::errc::value_too_large, SL);
+		tst::check_eq(res.num_written, size_t(0), SL);
+	});
+
+	suite.add("utf8_to_utf32_long_string", []() {
+		std::string str;
+		std::u32string expected;
+		for (unsigned i = 0; i != 100; ++i) {
+			str.append("some long ASCII text to convert ");
+			expected.append(U"some long ASCII text to convert ");
+			if (i % 3 == 0) {
+				str.append("aБцﺶ𠀋");
+				expected.append(U"aБцﺶ𠀋");
+			}
+		}
+
+		auto res = utki::to_utf32(str);
+
+		tst::check(res == expected, SL);
+	});
+
+	suite.add("utf8_to_utf32_stops_at_zero_character", []() {
+		auto str = "abc\0Бц"sv;
+
+		auto res = utki::to_utf32(str);
+
+		tst::check(res == U"abc"sv, SL);
+	});
+
+	suite.add("utf32_to_utf8_skips_zero_character", []() {
+		auto utf8 = utki::to_utf8(U"ab\0cБ"s);
+
+		tst::check_eq(utf8, "abcБ"s, SL);
+	});
+
+	suite.add("utf32_to_utf8_long_string", []() {
+		std::u32string str;
+		std::string expected;
+		for (unsigned i = 0; i != 100; ++i) {
+			str.append(U"some long ASCII text to convert ");
+			expected.append("some long ASCII text to convert ");
+			if (i % 3 == 0) {
+				str.append(U"aБцﺶ𠀋");
+				expected.append("aБцﺶ𠀋");
+			}
+		}
+
+		tst::check_eq(utki::utf8_encoded_size(str), expected.size(), SL);
+		tst::check_eq(utki::to_utf8(str), expected, SL);
+	});
+
+	suite.add("append_utf8", []() {
+		std::string str = "Hello ";
+
+		utki::append_utf8(str, U"aБцﺶ𠀋"sv);
+
+		tst::check_eq(str, "Hello aБцﺶ𠀋"s, SL);
+	});
+
+	suite.add("utf32_to_utf8_into_span", []() {
+		std::array<char, 12> buf{};
+
+		auto res = utki::to_utf8(U"aБцﺶ𠀋"sv, buf);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(res.num_written, size_t(12), SL);
+		tst::check_eq(res.offset, size_t(5), SL);
+		tst::check_eq(std::string_view(buf.data(), res.num_written), "aБцﺶ𠀋"sv, SL);
+	});
+
+	suite.add("utf32_to_utf8_into_span_too_small", []() {
+		std::array<char, 11> buf{};
+
+		auto res = utki::to_utf8(U"aБцﺶ𠀋"sv, buf);
+		tst::check(res.ec == std::errc::value_too_large, SL);
+		tst::check_eq(res.num_written, size_t(0), SL);
+	});
+
+	suite.add("utf32_to_utf8_into_span_encodes_zero_character", []() {
+		std::array<char, 6> buf{};
+
+		auto res = utki::to_utf8(U"ab\0cБ"sv, buf);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(res.num_written, size_t(6), SL);
+		tst::check_eq(res.offset, size_t(5), SL);
+		tst::check_eq(std::string_view(buf.data(), res.num_written), "ab\0cБ"sv, SL);
+	});
+
+	// the second element is the UTF-8 representation of the valid part of the string
+	suite.add<std::pair<std::u32string_view, std::string_view>>( //
+		"utf32_to_utf8_into_span_malformed",
+		{
+			{U"aБ\xd800ц"sv, "aБ"sv}, // surrogate
+			{U"aБц\xdfff"sv, "aБц"sv}, // surrogate
+			{U"\x110000Б"sv, ""sv},
+			{U"some long ASCII text \xffffffff"sv, "some long ASCII text "sv},
+			{U"some long ASCII text \0 and more \xd801 text"sv, "some long ASCII text \0 and more "sv},
+		},
+		[](const auto& p) {
+			std::array<char, 64> buf{};
+
+			auto res = utki::to_utf8(p.first, buf);
+			tst::check(res.ec == std::errc::illegal_byte_sequence, SL);
+			tst::check_eq(res.offset, utki::utf8_length(p.second), SL);
+			tst::check_eq(std::string_view(buf.data(), res.num_written), p.second, SL);
+		}
+	);
+
+	suite.add("utf16_iterator", []() {
+		// aБцﺶ𠀋 followed by unpaired low surrogate
+		auto str = u"aБцﺶ𠀋\xdc00"sv;
+
+		std::vector<char32_t> chars;
+		for (utki::utf16_iterator i(str); !i.is_end(); ++i) {
+			chars.push_back(i.character());
+		}
+
+		tst::check(chars == std::vector<char32_t>{U'a', U'Б', U'ц', U'ﺶ', U'𠀋', char32_t(0xdc00)}, SL);
+	});
+
+	suite.add("utf16_iterator_from_u16string", []() {
+		const std::u16string str = u"aБ𠀋";
+
+		std::u32string chars;
+		for (utki::utf16_iterator i(str); !i.is_end(); ++i) {
+			chars.push_back(i.character());
+		}
+
+		tst::check(chars == U"aБ𠀋"s, SL);
+	});
+
+	suite.add<std::pair<std::u16string_view, size_t>>( //
+		"find_invalid_utf16",
+		{
+			{u""sv, std::u16string_view::npos},
+			{u"aБцﺶ𠀋"sv, std::u16string_view::npos},
+			{u"abc\xd800"sv, 3},
+			{u"abc\xdc00"sv, 3},
+			{u"ab\xd800\xd800\xdc00"sv, 2},
+			{u"0123456789abcdef\xdbff\xdfff\xd800x"sv, 18},
+		},
+		[](const auto& p) {
+			tst::check_eq(utki::find_invalid_utf16(p.first), p.second, SL);
+			tst::check_eq(utki::is_valid_utf16(p.first), p.second == std::u16string_view::npos, SL);
+		}
+	);
+
+	suite.add("utf16_conversions", []() {
+		tst::check(utki::to_utf16("aБцﺶ𠀋"sv) == u"aБцﺶ𠀋"sv, SL);
+		tst::check(utki::to_utf16(U"aБцﺶ𠀋"sv) == u"aБцﺶ𠀋"sv, SL);
+		tst::check_eq(utki::to_utf8(u"aБцﺶ𠀋"sv), "aБцﺶ𠀋"s, SL);
+		tst::check(utki::to_utf32(u"aБцﺶ𠀋"sv) == U"aБцﺶ𠀋"sv, SL);
+
+		tst::check_eq(utki::utf16_length(u"aБцﺶ𠀋"sv), size_t(5), SL);
+		tst::check_eq(utki::utf16_encoded_size("aБцﺶ𠀋"sv), size_t(6), SL);
+		tst::check_eq(utki::utf16_encoded_size(U"aБцﺶ𠀋"sv), size_t(6), SL);
+		tst::check_eq(utki::utf8_encoded_size(u"aБцﺶ𠀋"sv), size_t(12), SL);
+	});
+
+	suite.add("utf16_conversions_long_string", []() {
+		std::string utf8;
+		std::u16string utf16;
+		std::u32string utf32;
+		for (unsigned i = 0; i != 100; ++i) {
+			utf8.append("some long ASCII text to convert ");
+			utf16.append(u"some long ASCII text to convert ");
+			utf32.append(U"some long ASCII text to convert ");
+			if (i % 3 == 0) {
+				utf8.append("aБцﺶ𠀋");
+				utf16.append(u"aБцﺶ𠀋");
+				utf32.append(U"aБцﺶ𠀋");
+			}
+		}
+
+		tst::check(utki::to_utf16(utf8) == utf16, SL);
+		tst::check(utki::to_utf16(utf32) == utf16, SL);
+		tst::check_eq(utki::to_utf8(utf16), utf8, SL);
+		tst::check(utki::to_utf32(utf16) == utf32, SL);
+	});
+
+	suite.add("utf16_conversions_malformed", []() {
+		bool thrown = false;
+		try {
+			utki::to_utf16("ab\xff"sv);
+			tst::check(false, SL);
+		} catch (std::invalid_argument& e) {
+			thrown = true;
+			tst::check_eq(
+				std::string(e.what()), //
+				"to_utf16(): malformed UTF-8 string: invalid sequence at offset 2"s,
+				SL
+			);
+		}
+		tst::check(thrown, SL);
+
+
+		thrown = false;
+		try {
+			utki::to_utf8(u"ab\xd800"sv);
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+
+		thrown = false;
+		try {
+			utki::to_utf16(U"ab\xd800"sv);
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+	});
+
+	suite.add("utf16_conversions_into_span", []() {
+		std::array<char16_t, 6> buf16{};
+		auto res = utki::to_utf16("aБцﺶ𠀋"sv, buf16);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check_eq(res.num_written, size_t(6), SL);
+		tst::check(std::u16string_view(buf16.data(), res.num_written) == u"aБцﺶ𠀋"sv, SL);
+
+		res = utki::to_utf16(U"aБ\xd800ц"sv, buf16);
+		tst::check(res.ec == std::errc::illegal_byte_sequence, SL);
+		tst::check_eq(res.offset, size_t(2), SL);
+		tst::check(std::u16string_view(buf16.data(), res.num_written) == u"aБ"sv, SL);
+
+		std::array<char, 11> buf8{};
+		res = utki::to_utf8(u"aБцﺶ𠀋"sv, buf8);
+		tst::check(res.ec == std::errc::value_too_large, SL);
+
+		std::array<char32_t, 5> buf32{};
+		res = utki::to_utf32(u"aБцﺶ𠀋"sv, buf32);
+		tst::check(res.ec == std::errc(), SL);
+		tst::check(std::u32string_view(buf32.data(), res.num_written) == U"aБцﺶ𠀋"sv, SL);
+	});
+
+	suite.add<size_t>( //
+		"utf8_index",
+		{1, 3, 64},
+		[](const auto& stride) {
+			std::string str;
+			std::u32string utf32;
+			for (unsigned i = 0; i != 50; ++i) {
+				str.append("some text aБцﺶ𠀋 ");
+				utf32.append(U"some text aБцﺶ𠀋 ");
+			}
+
+			utki::utf8_index index(str, stride);
+
+			tst::check_eq(index.size(), utf32.size(), SL);
+			tst::check_eq(index.offset(index.size()), str.size(), SL);
+			tst::check_eq(index.index_of(str.size()), index.size(), SL);
+
+			for (size_t i = 0; i != utf32.size(); ++i) {
+				tst::check_eq(uint32_t(index.at(i)), uint32_t(utf32[i]), SL);
+				tst::check_eq(index.index_of(index.offset(i)), i, SL);
+			}
+
+			// "aБцﺶ𠀋" of the third repetition
+			tst::check_eq(index.substr(2 * 16 + 10, 5), "aБцﺶ𠀋"sv, SL);
+			tst::check_eq(index.substr(index.size() - 6), "aБцﺶ𠀋 "sv, SL);
+			tst::check_eq(index.substr(index.size()), ""sv, SL);
+		}
+	);
+
+	suite.add("utf8_index_empty_string", []() {
+		utki::utf8_index index(""sv);
+
+		tst::check_eq(index.size(), size_t(0), SL);
+		tst::check_eq(index.offset(0), size_t(0), SL);
+		tst::check_eq(index.index_of(0), size_t(0), SL);
+		tst::check_eq(index.substr(0), ""sv, SL);
+	});
+
+	suite.add("utf8_index_out_of_range", []() {
+		utki::utf8_index index("aБцﺶ𠀋"sv);
+
+		bool thrown = false;
+		try {
+			index.at(5);
+			tst::check(false, SL);
+		} catch (std::out_of_range&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+
+		thrown = false;
+		try {
+			utki::utf8_index zero_stride_index("abc"sv, 0);
+			tst::check(false, SL);
+		} catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+	});
+
+	suite.add("utf8_reverse_iterator", []() {
+		auto str = "aБцﺶ𠀋"sv;
+
+		std::vector<char32_t> chars;
+		std::vector<size_t> offsets;
+		for (utki::utf8_reverse_iterator i(str); !i.is_end(); ++i) {
+			chars.push_back(i.character());
+			offsets.push_back(i.offset());
+		}
+
+		tst::check(chars == std::vector<char32_t>{U'𠀋', U'ﺶ', U'ц', U'Б', U'a'}, SL);
+		tst::check(offsets == std::vector<size_t>{8, 5, 3, 1, 0}, SL);
+	});
+
+	suite.add("utf8_reverse_iterator_malformed", []() {
+		// lone continuation byte, truncated sequence, lead byte without continuation bytes
+		auto str = "a\x80\xe2\x82\xd0"sv;
+
+		std::vector<char32_t> chars;
+		for (utki::utf8_reverse_iterator i(str); !i.is_end(); ++i) {
+			chars.push_back(i.character());
+		}
+
+		tst::check(chars == std::vector<char32_t>{0xfffd, 0xfffd, 0xfffd, 0xfffd, U'a'}, SL);
+	});
+
+	suite.add<std::pair<std::string_view, std::u32string>>(
+		"utf8_iterator_malformed_same_in_both_directions",
+		{
+			{"a\x80\xe2\x82\xd0"sv, U"a\xfffd\xfffd\xfffd\xfffd"s}, // lone continuation byte, truncated sequences
+			{"\xe2\x82\xac\x80\x80"sv, U"€\xfffd\xfffd"s}, // extra continuation bytes
+			{"\x80\x80\x80\x80\x80Б"sv, U"\xfffd\xfffd\xfffd\xfffd\xfffdБ"s},
+			{"a\xc0\xafz"sv, U"a\xfffd\xfffdz"s}, // overlong encoding
+			{"a\xed\xa0\x80z"sv, U"a\xfffd\xfffd\xfffdz"s}, // surrogate
+			{"a\xf4\x90\x80\x80"sv, U"a\xfffd\xfffd\xfffd\xfffd"s}, // above U+10ffff
+			{"a\xf8\x88\x80\x80\x80"sv, U"a\xfffd\xfffd\xfffd\xfffd\xfffd"s}, // 5 byte sequence
+			{"\xe2\x82x\xf0\x9f\x98\x80\xff"sv, U"\xfffd\xfffdx😀\xfffd"s},
+		},
+		[](const auto& p) {
+			std::u32string forward;
+			for (utki::utf8_iterator i(p.first); !i.is_end(); ++i) {
+				forward.push_back(i.character());
+			}
+			tst::check(forward == p.second, SL);
+
+			std::u32string reverse;
+			for (utki::utf8_reverse_iterator i(p.first); !i.is_end(); ++i) {
+				reverse.push_back(i.character());
+			}
+			std::reverse(reverse.begin(), reverse.end());
+			tst::check(reverse == forward, SL);
+
+			tst::check(utki::to_utf32(p.first) == forward, SL);
+		}
+	);
+
+	suite.add("utf8_truncate", []() {
+		tst::check_eq(utki::utf8_truncate("aБцﺶ𠀋"sv, 0), ""sv, SL);
+		tst::check_eq(utki::utf8_truncate("aБцﺶ𠀋"sv, 3), "aБц"sv, SL);
+		tst::check_eq(utki::utf8_truncate("aБцﺶ𠀋"sv, 5), "aБцﺶ𠀋"sv, SL);
+		tst::check_eq(utki::utf8_truncate("aБцﺶ𠀋"sv, 100), "aБцﺶ𠀋"sv, SL);
+		tst::check_eq(utki::utf8_truncate(""sv, 1), ""sv, SL);
+
+		std::string str;
+		for (unsigned i = 0; i != 10; ++i) {
+			str.append("some text aБцﺶ𠀋 ");
+		}
+		auto expected = std::string_view(str).substr(0, 2 * std::string_view("some text aБцﺶ𠀋 ").size());
+		tst::check_eq(utki::utf8_truncate(str, 2 * 16), expected, SL);
+	});
 });
 } // namespace
 
@@ -89,6 +89,37 @@ const tst::set set("util", [](tst::suite& suite) {
 	});
 #endif
 
+	suite.add("byte_swap", []() {
+		static_assert(utki::byte_swap(uint8_t(0xa1)) == 0xa1);
+		static_assert(utki::byte_swap(uint16_t(0xa1b2)) == 0xb2a1);
+		static_assert(utki::byte_swap(uint32_t(0xa1b2c3d4)) == 0xd4c3b2a1);
+		static_assert(utki::byte_swap(uint64_t(0xa1b2c3d4e5f61728)) == 0x2817f6e5d4c3b2a1);
+
+		volatile uint32_t v = 0xa1b2c3d4;
+		tst::check_eq(utki::byte_swap(uint32_t(v)), uint32_t(0xd4c3b2a1), SL);
+		tst::check_eq(utki::byte_swap(utki::byte_swap(uint32_t(v))), uint32_t(v), SL);
+	});
+
+#if UTKI_IS_CONSTANT_EVALUATED_SUPPORTED
+	suite.add("serialization_constexpr", []() {
+		constexpr auto buf = []() {
+			std::array<uint8_t, 6> ret{};
+			auto p = utki::serialize16le(0xa1b2, ret.data());
+			utki::serialize32be(0xc3d4e5f6, p);
+			return ret;
+		}();
+
+		static_assert(buf[0] == 0xb2 && buf[1] == 0xa1);
+		static_assert(buf[2] == 0xc3 && buf[3] == 0xd4 && buf[4] == 0xe5 && buf[5] == 0xf6);
+		static_assert(utki::deserialize16le(buf.data()) == 0xa1b2);
+		static_assert(utki::deserialize32be(buf.data() + 2) == 0xc3d4e5f6);
+		static_assert(utki::deserialize_be<uint64_t>(std::array<uint8_t, 8>{1, 2, 3, 4, 5, 6, 7, 8}.data()) ==
+			0x0102030405060708);
+
+		tst::check_eq(utki::deserialize32be(buf.data() + 2), uint32_t(0xc3d4e5f6), SL);
+	});
+#endif
+
 	suite.add("serialization_16_bit_little_endian", []() {
 		for (uint32_t i = 0; i <= uint16_t(-1); ++i) {
 			std::array<uint8_t, sizeof(uint16_t)> buf = {0};
@@ -184,6 +215,96 @@ const tst::set set("util", [](tst::suite& suite) {
 		}
 	);
 
+	suite.add<std::pair<uint64_t, std::vector<uint8_t>>>( //
+		"serialization_varuint",
+		// clang-format off
+		{
+			{0, {0x00}},
+			{1, {0x01}},
+			{0x7f, {0x7f}},
+			{0x80, {0x80, 0x01}},
+			{300, {0xac, 0x02}},
+			{0x3fff, {0xff, 0x7f}},
+			{0x4000, {0x80, 0x80, 0x01}},
+			{0xffffffff, {0xff, 0xff, 0xff, 0xff, 0x0f}},
+			{0xffffffffffffffff, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01}},
+		},
+		// clang-format on
+		[](const auto& p) {
+			tst::check_eq(utki::varuint_size(p.first), p.second.size(), SL);
+
+			std::array<uint8_t, utki::max_varuint_size<uint64_t>> buf{};
+			auto end = utki::serialize_varuint(p.first, buf.data());
+
+			tst::check_eq(size_t(end - buf.data()), p.second.size(), SL);
+			tst::check(std::equal(p.second.begin(), p.second.end(), buf.begin()), SL);
+
+			uint64_t value = 0;
+			tst::check_eq(utki::deserialize_varuint(utki::make_span(p.second), value), p.second.size(), SL);
+			tst::check_eq(value, p.first, SL);
+
+			// truncated value
+			tst::check_eq(
+				utki::deserialize_varuint(utki::make_span(p.second).subspan(0, p.second.size() - 1), value),
+				size_t(0),
+				SL
+			);
+		}
+	);
+
+	suite.add("deserialization_varuint_overflow", []() {
+		std::vector<uint8_t> buf = {0xff, 0xff, 0x03};
+		uint16_t u16 = 0;
+		tst::check_eq(utki::deserialize_varuint(utki::make_span(buf), u16), size_t(3), SL);
+		tst::check_eq(u16, uint16_t(0xffff), SL);
+
+		buf = {0xff, 0xff, 0x04};
+		tst::check_eq(utki::deserialize_varuint(utki::make_span(buf), u16), size_t(0), SL);
+
+		buf = {0xff, 0xff, 0x83, 0x00};
+		tst::check_eq(utki::deserialize_varuint(utki::make_span(buf), u16), size_t(0), SL);
+
+		buf = {0xff, 0xff, 0xff, 0xff, 0x1f};
+		uint32_t u32 = 0;
+		tst::check_eq(utki::deserialize_varuint(utki::make_span(buf), u32), size_t(0), SL);
+
+		buf = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02};
+		uint64_t u64 = 0;
+		tst::check_eq(utki::deserialize_varuint(utki::make_span(buf), u64), size_t(0), SL);
+	});
+
+	suite.add<std::pair<int32_t, uint32_t>>( //
+		"zigzag",
+		{
+			{0, 0},
+			{-1, 1},
+			{1, 2},
+			{-2, 3},
+			{2147483647, 4294967294},
+			{-2147483648, 4294967295},
+		},
+		[](const auto& p) {
+			tst::check_eq(utki::zigzag_encode(p.first), p.second, SL);
+			tst::check_eq(utki::zigzag_decode(p.second), p.first, SL);
+
+			std::array<uint8_t, utki::max_varuint_size<uint32_t>> buf{};
+			auto end = utki::serialize_varint(p.first, buf.data());
+
+			int32_t value = 0;
+			auto size = utki::deserialize_varint(utki::make_span(buf), value);
+			tst::check_eq(size, size_t(end - buf.data()), SL);
+			tst::check_eq(value, p.first, SL);
+		}
+	);
+
+	suite.add("zigzag_8_bit", []() {
+		for (int i = -128; i != 128; ++i) {
+			auto e = utki::zigzag_encode(int8_t(i));
+			tst::check_eq(unsigned(e), unsigned(i < 0 ? -2 * i - 1 : 2 * i), SL);
+			tst::check_eq(int(utki::zigzag_decode(e)), i, SL);
+		}
+	});
+
 	suite.add("scope_exit", []() {
 		bool flag = false;
 		{